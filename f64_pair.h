@@ -32,6 +32,7 @@
 
 #pragma once
 
+#include <stdbool.h>
 #include <stdint.h>
 #include <string.h>
 #include <math.h>
@@ -147,6 +148,10 @@ extern fe_noinline double add3_slowpath_f64(fe_pair_t, fe_pair_t);
 extern fe_noinline fe_pair_t   fe_add_d_cr_slowpath(fe_pair_t, fe_pair_t, fe_pair_t);
 extern fe_noinline fe_triple_t fe_triple_add_pd_slowpath(fe_pair_t, fe_pair_t, fe_pair_t);
 extern fe_noinline int64_t fe_to_i64_slowpath(fe_pair_t x, double a);
+extern fe_noinline double fe_result_mul_slowpath(fe_pair_t, fe_pair_t, double, double);
+extern fe_noinline double fe_result_div_slowpath(fe_pair_t, fe_pair_t, double, double);
+extern fe_noinline double fe_result_sqrt_slowpath(fe_pair_t, double, double);
+extern fe_noinline double fr_result_add_slowpath(fr_pair_t, fr_pair_t);
 
 extern fe_pair_t fe_pow_pn_d(double x, uint64_t n);
 extern fe_pair_t fe_pow_n_d(double x, int64_t n);
@@ -842,6 +847,117 @@ static inline fe_pair_t fe_fma_ddd_a(double a, double b, double c)
 }
 
 
+// xy+z : the product isn't renormalized. Its three parts (p.hi,p.lo,m)
+// go directly into AccurateDWPlusDW with the cross terms 'm' added to
+// the final tail. vs. fe_add(fe_mul(x,y),z) this drops the product's
+// fast-sum (and its dependent step in the critical path). Peak error in
+// the test harness is ~6 ulp vs. ~5.4 for the composed version. Under
+// cancellation (z<0) the error of both is bounded relative to |xy| and
+// not the result: the harness peak is then the worst sample (tens to a
+// few hundred ulp for both). fe_fma_a doesn't have that problem.
+static inline fe_pair_t fe_fma(fe_pair_t x, fe_pair_t y, fe_pair_t z)
+{
+  // 3 fma, 2 mul, 21 adds (composed: 3 fma, 2 mul, 24 adds)
+  fe_pair_t p = fe_two_mul(x.hi,y.hi);  // 1 fma, 1 mul
+  double    a = x.lo * y.lo;
+  double    b = fma(x.hi,y.lo,a);
+  double    m = fma(x.lo,y.hi,b);
+  fe_pair_t s = fe_two_sum(p.hi,z.hi);  // 6 adds
+  fe_pair_t t = fe_two_sum(p.lo,z.lo);  // 6 adds
+  double    c = s.lo + t.hi;
+  fe_pair_t v = fe_fast_sum(s.hi, c);   // 3 adds
+  double    w = (t.lo + m) + v.lo;
+
+  return fe_fast_sum(v.hi,w);           // 3 adds
+}
+
+// xy+z : double 'y'. peak error ~3.5 ulp vs. ~3.2 composed. the same
+// as fe_fma under cancellation.
+static inline fe_pair_t fe_fma_d(fe_pair_t x, double y, fe_pair_t z)
+{
+  // 2 fma, 1 mul, 20 adds (composed: 2 fma, 1 mul, 23 adds)
+  fe_pair_t p = fe_two_mul(x.hi,y);     // 1 fma, 1 mul
+  double    d = fma(x.lo,y,p.lo);       // (p.hi,d): unnormalized product
+  fe_pair_t s = fe_two_sum(p.hi,z.hi);  // 6 adds
+  fe_pair_t t = fe_two_sum(d,z.lo);     // 6 adds
+  double    c = s.lo + t.hi;
+  fe_pair_t v = fe_fast_sum(s.hi, c);   // 3 adds
+  double    w = t.lo + v.lo;
+
+  return fe_fast_sum(v.hi,w);           // 3 adds
+}
+
+// xy+z : the cross products are also split error-free so the product
+// reaches AccurateDWPlusDW as (p.hi,r.hi) with a tail that's only
+// missing x.lo*y.lo's rounding. The product is never rounded to a pair
+// so there's no cancellation penalty: peak error in the test harness is
+// ~4.5 ulp for both signs of 'z'. Costs more ops than the composed version.
+static inline fe_pair_t fe_fma_a(fe_pair_t x, fe_pair_t y, fe_pair_t z)
+{
+  // 3 fma, 4 mul, 37 adds
+  fe_pair_t p = fe_two_mul(x.hi,y.hi);  // 1 fma, 1 mul
+  fe_pair_t a = fe_two_mul(x.hi,y.lo);  // 1 fma, 1 mul
+  fe_pair_t b = fe_two_mul(x.lo,y.hi);  // 1 fma, 1 mul
+  fe_pair_t q = fe_two_sum(p.lo,a.hi);  // 6 adds
+  fe_pair_t r = fe_two_sum(q.hi,b.hi);  // 6 adds
+  double    m = (q.lo + r.lo) + ((a.lo + b.lo) + x.lo*y.lo);
+  fe_pair_t s = fe_two_sum(p.hi,z.hi);  // 6 adds
+  fe_pair_t t = fe_two_sum(r.hi,z.lo);  // 6 adds
+  double    c = s.lo + t.hi;
+  fe_pair_t v = fe_fast_sum(s.hi, c);   // 3 adds
+  double    w = (t.lo + m) + v.lo;
+
+  return fe_fast_sum(v.hi,w);           // 3 adds
+}
+
+// xy+z : double 'y'. x.lo*y is split error-free as above: peak error
+// ~2.5 (z>0) and ~4.5 (z<0) ulp.
+static inline fe_pair_t fe_fma_d_a(fe_pair_t x, double y, fe_pair_t z)
+{
+  // 2 fma, 2 mul, 28 adds
+  fe_pair_t p = fe_two_mul(x.hi,y);     // 1 fma, 1 mul
+  fe_pair_t e = fe_two_mul(x.lo,y);     // 1 fma, 1 mul
+  fe_pair_t q = fe_two_sum(p.lo,e.hi);  // 6 adds
+  fe_pair_t s = fe_two_sum(p.hi,z.hi);  // 6 adds
+  fe_pair_t t = fe_two_sum(q.hi,z.lo);  // 6 adds
+  double    c = s.lo + t.hi;
+  fe_pair_t v = fe_fast_sum(s.hi, c);   // 3 adds
+  double    w = (t.lo + (q.lo + e.lo)) + v.lo;
+
+  return fe_fast_sum(v.hi,w);           // 3 adds
+}
+
+// xy+z : CPairMul feeding CPairSum. all of the low order terms
+// are accumulated by the FMAs: e + (ay'+a'y+z'). Peak error in the test
+// harness is ~7.6 ulp (composed ~9.3). Under cancellation the error is
+// bounded relative to |xy| (as fe_fma): the harness peak for z<0 swings
+// between ~30 and ~90 ulp from run to run (composed ~50 to ~95).
+static inline fr_pair_t fr_fma(fr_pair_t x, fr_pair_t y, fr_pair_t z)
+{
+  // 3 fma, 1 mul, 8 adds (composed: 2 fma, 3 mul, 10 adds)
+  double    h = x.hi*y.hi;
+  double    e = fma(x.hi,y.hi,-h);      // ab-RN(ab)
+  double    u = fma(x.lo,y.hi,z.lo);
+  double    g = fma(x.hi,y.lo,u);       // af+be+z.lo
+  fr_pair_t t = fr_two_sum(h,z.hi);     // 6 adds
+
+  return fr_pair(t.hi, t.lo+(e+g));
+}
+
+// xy+z : double 'y'. peak error ~3 ulp (composed ~4) and as fr_fma
+// under cancellation.
+static inline fr_pair_t fr_fma_d(fr_pair_t x, double y, fr_pair_t z)
+{
+  // 2 fma, 1 mul, 8 adds (composed: same count)
+  double    h = x.hi*y;
+  double    e = fma(x.hi,y,-h);         // ay-RN(ay)
+  double    g = fma(x.lo,y,z.lo);       // ey+z.lo
+  fr_pair_t t = fr_two_sum(h,z.hi);     // 6 adds
+
+  return fr_pair(t.hi, t.lo+(e+g));
+}
+
+
 
 static inline fe_pair_t fe_div_d(fe_pair_t x, double y)
 {
@@ -1104,7 +1220,66 @@ static inline fr_pair_t fr_inv_a(fr_pair_t x)
 }
 
 
-// 1) "Accelerating Correctly Rounded Floating-Point Division when the Divisor Is Known in Advance"
+// Division by a divisor known in advance (1). `fe_divisor_t` holds the
+// divisor 'y' and the pair (ih,il) ≈ 1/y. The quotient 'h' comes from a
+// multiply by the reciprocal pair instead of a divide (RN(x/y) except
+// for hard cases) and the remainder x-hy is formed as in DWDivDW2
+// (fe_div). The correction is the remainder times 1/y which is as good
+// as dividing by y.hi. No divides in the per element work.
+//
+// 1) "Accelerating Correctly Rounded Floating-Point Division when the
+//     Divisor Is Known in Advance", Brisebarre, Muller & Raina, 2004
+
+typedef struct { double hi, lo, ih, il; } fe_divisor_t;
+
+static inline fe_divisor_t fe_divisor_init(fe_pair_t y)
+{
+  fe_pair_t    i = fe_inv(y);
+  fe_divisor_t d = {.hi = y.hi, .lo = y.lo, .ih = i.hi, .il = i.lo};
+  return d;
+}
+
+static inline fe_divisor_t fe_divisor_init_d(double y) { return fe_divisor_init(fe_set_d(y)); }
+
+// x/y : pair numerator
+static inline fe_pair_t fe_div_pre(fe_pair_t x, fe_divisor_t d)
+{
+  // 4 fma, 3 mul, 9 add (fe_div: 2 div, 2 fma, 1 mul, 9 add)
+  // ulp: ~4.41 (fe_div: ~6.88 in the same test)
+  double    h = fma(x.hi,d.ih,fma(x.lo,d.ih,x.hi*d.il)); // RN(x/y) (almost always)
+  fe_pair_t r = fe_mul_d(fe_pair(d.hi,d.lo),h); // DWTimesFP3: 2 fma, 1 mul, 3 add
+  double    a = x.hi - r.hi;            // (exact operation)
+  double    b = x.lo - r.lo;
+  double    c = a + b;
+  double    l = c * d.ih;
+
+  return fe_fast_sum(h,l);              // 3 add
+}
+
+// x/y : double numerator
+static inline fe_pair_t fe_d_div_pre(double x, fe_divisor_t d)
+{
+  // 3 fma, 3 mul, 8 add (fe_d_div: 2 div, 2 fma, 1 mul, 8 add)
+  // ulp: ~2.69 (fe_d_div: ~6.10 in the same test)
+  double    h = fma(x,d.ih,x*d.il);     // RN(x/y) (almost always)
+  fe_pair_t r = fe_mul_d(fe_pair(d.hi,d.lo),h); // DWTimesFP3: 2 fma, 1 mul, 3 add
+  double    t = (x - r.hi) - r.lo;
+  double    l = t * d.ih;
+
+  return fe_fast_sum(h,l);              // 3 add
+}
+
+// batch forms: r[i] = x[i]/y. no loop carried dependencies so
+// these vectorize (GCC 14 versions the loop for aliasing)
+static inline void fe_div_pre_batch(const fe_pair_t* x, size_t n, fe_pair_t* r, fe_divisor_t d)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_div_pre(x[i],d);
+}
+
+static inline void fe_d_div_pre_batch(const double* x, size_t n, fe_pair_t* r, fe_divisor_t d)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_d_div_pre(x[i],d);
+}
 
 
 // Newton-Raphson step for 1/sqrt(x)
@@ -1262,11 +1437,11 @@ static inline double fe_result_ro(fe_pair_t x)
   uint64_t  xl = fe_to_bits(x.lo);
 
   // thinking cap is in order for below here.
-  uint64_t  o  = xl != 0;                   // if (x+y) is exact (low result zero) then there's no rounding
+  uint64_t  o  = -(uint64_t)(x.lo != 0.0);  // if (x+y) is exact (low result zero) then there's no rounding
   uint64_t  s  = (xh & 1)-1;                // -1 if even, 0 if already odd (selector)
-  uint64_t  d  = (-(xl >> 63))|o;           // ±1 to round in opposite direction that RN performed (if even)
+  uint64_t  d  = (-((xh^xl) >> 63))|1;      // ±1 on the magnitude: toward lo (opposite direction that RN performed)
 
-  xh += s & d;                              // perform any rounding correction
+  xh += s & o & d;                          // perform any rounding correction
 
   return fe_from_bits(xh);
 }
@@ -1315,6 +1490,10 @@ extern fe_triple_t fe_triple_add3_ddd(double a, double b, double c);
 extern fe_pair_t   fe_add3_ddd(double a, double b, double c);
 extern double      fe_result_add(fe_pair_t x, fe_pair_t y);
 
+extern fe_pair_t   fe_fmod(fe_pair_t x, fe_pair_t y);
+extern fe_pair_t   fe_remquo(fe_pair_t x, fe_pair_t y, int* quo);
+extern void        fe_fmod_batch(const fe_pair_t* x, size_t n, fe_pair_t* r, fe_pair_t y);
+
 #else
 
 // integer powers support
@@ -1630,7 +1809,7 @@ fe_pair_t fe_add3_ddd(double a, double b, double c)
 double fe_result_add(fe_pair_t x, fe_pair_t y)
 {
   // [9] algorithm 11 (FPNearestSumDW)
-  // 55 adds (following fast-path)
+  // 56 adds (following fast-path)
   fe_pair_t s = fe_two_sum(x.hi, y.hi);        // 6 adds
   fe_pair_t t = fe_two_sum(x.lo, y.lo);        // 6 adds
   fe_pair_t γ = fe_two_sum(s.lo, t.hi);        // 6 adds
@@ -1640,7 +1819,7 @@ double fe_result_add(fe_pair_t x, fe_pair_t y)
   fe_pair_t q = fe_add3_ddd(z.lo, w.lo, γ.lo); // 28 adds (along fast-path)
   uint64_t  T = fe_not_pot(q.hi);
   
-  if (fe_likely(T != 0)) return z.hi;
+  if (fe_likely(T != 0)) return z.hi + q.hi;
 
   // slow-path: 
   double ρ = 1.5*q.hi;
@@ -1653,6 +1832,117 @@ double fe_result_add(fe_pair_t x, fe_pair_t y)
   return σ;
 }
 
+// Shewchuk's grow-expansion with zero elimination. 'v' is overwritten by
+// the nonoverlapping expansion (increasing magnitude) of the exact sum of
+// the 'n' elements. returns the number of elements.
+static uint32_t fe_sum_expansion_i(double* v, uint32_t n)
+{
+  uint32_t m = 0;
+
+  for(uint32_t i=0; i<n; i++) {
+    double   q = v[i];
+    uint32_t k = 0;
+
+    for(uint32_t j=0; j<m; j++) {
+      fe_pair_t s = fe_two_sum(q,v[j]);
+      q = s.hi;
+      if (s.lo != 0.0) v[k++] = s.lo;
+    }
+
+    if (q != 0.0) v[k++] = q;
+    m = k;
+  }
+
+  return m;
+}
+
+// sign of the exact sum of the 'n' elements of 'v' (which is overwritten):
+// the sign of the last element of the expansion.
+static int fe_sum_sign_i(double* v, uint32_t n)
+{
+  uint32_t m = fe_sum_expansion_i(v,n);
+
+  if (m == 0) return 0;
+
+  return (v[m-1] > 0.0) ? 1 : -1;
+}
+
+// common tail of the correctly rounded result slow-paths. 'a' < 'b' are
+// adjacent and 's' is the sign of X-M where X is the exact result and
+// M the midpoint of a & b.
+static inline double fe_result_pick_i(double a, double b, int s)
+{
+  if (s > 0) return b;
+  if (s < 0) return a;
+
+  // tie: to even
+  return (fe_to_bits(a) & 1) ? b : a;
+}
+
+// midpoint of adjacent 'a' < 'b' as an (exact) unevaluated pair
+static inline fe_pair_t fe_result_mid_i(double a, double b)
+{
+  return fe_pair(a, 0.5*(b-a));         // b-a is exact (Sterbenz)
+}
+
+// RN(xy) : the rounding test failed and the candidates are (a,b)
+fe_noinline double fe_result_mul_slowpath(fe_pair_t x, fe_pair_t y, double a, double b)
+{
+  // nan/inf inputs or overflow lands here
+  if (fe_unlikely(!(isfinite(a) && isfinite(b)))) return x.hi*y.hi;
+
+  // sign of xy-M: all products are error free
+  fe_pair_t m  = fe_result_mid_i(a,b);
+  fe_pair_t p0 = fe_two_mul(x.hi,y.hi);
+  fe_pair_t p1 = fe_two_mul(x.hi,y.lo);
+  fe_pair_t p2 = fe_two_mul(x.lo,y.hi);
+  fe_pair_t p3 = fe_two_mul(x.lo,y.lo);
+  double    v[10] = {-m.lo,p3.lo,p3.hi,p2.lo,p1.lo,p2.hi,p1.hi,p0.lo,-m.hi,p0.hi};
+
+  return fe_result_pick_i(a,b,fe_sum_sign_i(v,10));
+}
+
+// RN(x/y) : the rounding test failed and the candidates are (a,b)
+fe_noinline double fe_result_div_slowpath(fe_pair_t x, fe_pair_t y, double a, double b)
+{
+  if (fe_unlikely(!(isfinite(a) && isfinite(b)))) return x.hi/y.hi;
+
+  // sign of x/y-M = sign of (x-My)*sign(y)
+  fe_pair_t m  = fe_result_mid_i(a,b);
+  fe_pair_t p0 = fe_two_mul(m.hi,y.hi);
+  fe_pair_t p1 = fe_two_mul(m.hi,y.lo);
+  fe_pair_t p2 = fe_two_mul(m.lo,y.hi);
+  fe_pair_t p3 = fe_two_mul(m.lo,y.lo);
+  double    v[10] = {-p3.lo,-p3.hi,-p2.lo,-p1.lo,-p2.hi,-p1.hi,-p0.lo,x.lo,-p0.hi,x.hi};
+  int       s     = fe_sum_sign_i(v,10);
+
+  return fe_result_pick_i(a,b, (y.hi > 0.0) ? s : -s);
+}
+
+// RN(sqrt(x)) : the rounding test failed and the candidates are (a,b)
+fe_noinline double fe_result_sqrt_slowpath(fe_pair_t x, double a, double b)
+{
+  if (fe_unlikely(!(isfinite(a) && isfinite(b)))) return sqrt(x.hi);
+
+  // sign of sqrt(x)-M = sign of x-M^2 (both positive)
+  fe_pair_t m  = fe_result_mid_i(a,b);
+  fe_pair_t p0 = fe_two_mul(m.hi,m.hi);
+  fe_pair_t p1 = fe_two_mul(m.hi,m.lo+m.lo);
+  fe_pair_t p2 = fe_two_mul(m.lo,m.lo);
+  double    v[8] = {-p2.lo,-p2.hi,-p1.lo,-p1.hi,-p0.lo,x.lo,-p0.hi,x.hi};
+
+  return fe_result_pick_i(a,b,fe_sum_sign_i(v,8));
+}
+
+// RN(x+y) for unnormalized 'x' & 'y': [9] algorithm 12 (Sum4)
+fe_noinline double fr_result_add_slowpath(fr_pair_t x, fr_pair_t y)
+{
+  fe_pair_t a = fe_two_sum(x.hi,x.lo);
+  fe_pair_t b = fe_two_sum(y.hi,y.lo);
+  
+  return fe_result_add(a,b);
+}
+
 // |x| >= 2^63 or NaN
 fe_noinline int64_t fe_to_i64_slowpath(fe_pair_t x, double a)
 {
@@ -1675,6 +1965,161 @@ fe_noinline int64_t fe_to_i64_slowpath(fe_pair_t x, double a)
   return r;
 }
 
+
+// exact sum of the 'n' elements of 'v' (overwritten) when it's representable
+// as a pair. 'v' needs two spare elements. hi is first approximated and the
+// exact residual of the expansion (v-h) then corrects hi to RN(Σv) so the
+// final residual is 'lo'.
+static double fe_sum_expansion_approx_i(const double* v, uint32_t m)
+{
+  double s = 0.0;
+
+  for(uint32_t i=0; i<m; i++) s += v[i];   // increasing magnitude
+
+  return s;
+}
+
+static fe_pair_t fe_sum_pair_i(double* v, uint32_t n)
+{
+  uint32_t  m = fe_sum_expansion_i(v,n);
+  double    h = fe_sum_expansion_approx_i(v,m);
+
+  v[m] = -h;
+  m    = fe_sum_expansion_i(v,m+1);
+
+  fe_pair_t t = fe_fast_sum(h, fe_sum_expansion_approx_i(v,m));
+
+  // v-t.hi = (v-h) - (t.hi-h) where t.hi-h = l-t.lo exactly
+  v[m]   = -fe_sum_expansion_approx_i(v,m);
+  v[m+1] = t.lo;
+  m      = fe_sum_expansion_i(v,m+2);
+
+  return fe_fast_sum(t.hi, fe_sum_expansion_approx_i(v,m));
+}
+
+// size of the partial remainder expansion in fe_fmod/fe_remquo
+#ifndef FE_FMOD_EXPANSION
+#define FE_FMOD_EXPANSION 64
+#endif
+
+// |x| mod |y| and the low 3 bits of the quotient in 'k'. The partial
+// remainders can need far more bits than a pair (up to the exponent
+// difference plus the bits of 'y') so they're kept as a nonoverlapping
+// expansion and each step subtracts the error-free products of q·y.
+// The quotient estimate is shrunk by 2^-48 to cover the rounding of the
+// division, y.lo and the estimate of the expansion so the partial
+// remainder (practically) never goes negative: ~48 quotient bits per step.
+// If it does 'y' is added back. For exponent differences past 52 the
+// step subtracts q·(2^e·y) instead (exact scaling and q stays ~2^52) so
+// r/y can't overflow and the quotient bits are those of q·2^e.
+// The expansion is capped at FE_FMOD_EXPANSION terms: before anything is
+// appended the two smallest are merged until it fits. Each merge rounds
+// so past the cap the result is no longer exact (never seen in practice).
+static uint32_t fe_fmod_fold_i(double* v, uint32_t m)
+{
+  while (m > FE_FMOD_EXPANSION) {
+    v[1] += v[0];
+    memmove(v, v+1, --m*sizeof(double));
+  }
+
+  return m;
+}
+
+static fe_pair_t fe_fmod_i(fe_pair_t x, fe_pair_t y, uint32_t* k)
+{
+  double    v[FE_FMOD_EXPANSION+4];     // m <= cap then +4 appended
+  double    t[FE_FMOD_EXPANSION+2];     // m <= cap then +2 appended
+  fe_pair_t a = fe_abs(y);
+  uint32_t  n = 0;
+  uint32_t  m;
+
+  v[0] = (x.hi*x.lo >= 0.0) ? fabs(x.lo) : -fabs(x.lo);
+  v[1] = fabs(x.hi);
+  m    = fe_sum_expansion_i(v,2);
+
+  for(;;) {
+    // exact sign of r-a
+    memcpy(t,v,m*sizeof(double));
+    t[m] = -a.lo; t[m+1] = -a.hi;
+
+    if (fe_sum_sign_i(t,m+2) < 0) break;
+
+    // approximate r (increasing magnitude order)
+    double r = 0.0;
+
+    for(uint32_t i=0; i<m; i++) r += v[i];
+
+    // b = 2^e·a : 'u' is 2^e mod 8
+    int       e = ilogb(r) - ilogb(a.hi) - 52;
+    fe_pair_t b = (e > 0) ? fe_pair(ldexp(a.hi,e), ldexp(a.lo,e)) : a;
+    uint32_t  u = (e <= 0) ? 1u : ((e < 3) ? (1u << e) : 0u);
+
+    double    q = fmax(trunc((r/b.hi)*(1.0-0x1.0p-48)), 1.0);
+    fe_pair_t p = fe_two_mul(q,b.hi);
+    fe_pair_t s = fe_two_mul(q,b.lo);
+
+    n += (uint32_t)fmod(q,8.0)*u;
+
+    v[m  ] = -s.lo; v[m+1] = -s.hi;
+    v[m+2] = -p.lo; v[m+3] = -p.hi;
+    m = fe_sum_expansion_i(v,m+4);
+
+    while (m != 0 && v[m-1] < 0.0) {
+      m = fe_fmod_fold_i(v,m);
+      v[m] = b.lo; v[m+1] = b.hi;
+      m = fe_sum_expansion_i(v,m+2);
+      n -= u;
+    }
+
+    m = fe_fmod_fold_i(v,m);
+  }
+
+  *k = n & 7;
+
+  return fe_sum_pair_i(v,m);
+}
+
+fe_pair_t fe_fmod(fe_pair_t x, fe_pair_t y)
+{
+  uint32_t k;
+
+  if (!isfinite(x.hi) || isnan(y.hi) || y.hi == 0.0) return fe_pair(NAN,NAN);
+  if (isinf(y.hi)) return x;
+
+  return fe_mulsign(fe_fmod_i(x,y,&k), x);
+}
+
+fe_pair_t fe_remquo(fe_pair_t x, fe_pair_t y, int* quo)
+{
+  uint32_t k;
+
+  *quo = 0;
+
+  if (!isfinite(x.hi) || isnan(y.hi) || y.hi == 0.0) return fe_pair(NAN,NAN);
+  if (isinf(y.hi)) return x;
+
+  fe_pair_t r = fe_fmod_i(x,y,&k);
+  fe_pair_t a = fe_abs(y);
+  fe_pair_t h = fe_mul_pot(2.0,r);
+
+  // 2r > a or a tie with an odd quotient: r-a and the quotient goes up one
+  if (h.hi > a.hi || (h.hi == a.hi && (h.lo > a.lo || (h.lo == a.lo && (k & 1))))) {
+    double v[8] = {a.lo, a.hi, -r.lo, -r.hi};
+
+    r = fe_neg(fe_sum_pair_i(v,4));
+    k = (k+1) & 7;
+  }
+
+  *quo = ((x.hi < 0.0) != (y.hi < 0.0)) ? -(int)k : (int)k;
+
+  return fe_mulsign(r, x);
+}
+
+void fe_fmod_batch(const fe_pair_t* x, size_t n, fe_pair_t* r, fe_pair_t y)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_fmod(x[i],y);
+}
+
 #endif
 
 
@@ -1719,6 +2164,68 @@ static inline double fe_result_roadd_d(fe_pair_t x, double c)
   return add3_slowpath_f64(s,v);
 }
 
+// Correctly rounded results of pair mul/div/sqrt. All three compute the
+// unnormalized (h,l) of the pair op and perform a rounding test: given
+// |X-(h+l)| <= e then RN(h+(l-e)) = RN(h+(l+e)) implies that value is RN(X)
+// (monotonicity of RN). The 'e' values leave large margins over the error
+// bounds which also covers the rounding of l±e. Otherwise the slow-path
+// determines the sign of X relative to the midpoint exactly.
+// expected rate to reach the slow-path: ~2^-46
+
+// RN(xy) : error bound = u (correctly rounded)
+static inline double fe_result_mul(fe_pair_t x, fe_pair_t y)
+{
+  // DWTimesDW3 (w/o final Fast2Sum) + test: 3 fma, 3 mul, 5 add
+  fe_pair_t p = fe_two_mul(x.hi,y.hi);  // 1 fma, 1 mul
+  double    a = x.lo * y.lo;
+  double    b = fma(x.hi,y.lo,a);
+  double    c = fma(x.lo,y.hi,b);
+  double    l = p.lo + c;               // |xy-(h+l)| <= 4u^2|h|
+  double    e = 0x1.0p-99*fabs(p.hi);
+  double    r0 = p.hi + (l-e);
+  double    r1 = p.hi + (l+e);
+
+  if (fe_likely(r0 == r1)) return r0;
+
+  return fe_result_mul_slowpath(x,y,r0,r1);
+}
+
+// RN(x/y) : error bound = u (correctly rounded)
+static inline double fe_result_div(fe_pair_t x, fe_pair_t y)
+{
+  // DWDivDW2 (w/o final Fast2Sum) + test: 2 div, 2 fma, 2 mul, 10 add
+  double    h = x.hi/y.hi;
+  fe_pair_t r = fe_mul_d(y,h);          // DWTimesFP3: 2 fma, 1 mul, 3 add
+  double    a = x.hi - r.hi;            // (exact operation)
+  double    b = x.lo - r.lo;
+  double    c = a + b;
+  double    l = c / y.hi;               // |x/y-(h+l)| <= 15u^2|h| (+ tiny)
+  double    e = 0x1.0p-98*fabs(h);
+  double    r0 = h + (l-e);
+  double    r1 = h + (l+e);
+
+  if (fe_likely(r0 == r1)) return r0;
+
+  return fe_result_div_slowpath(x,y,r0,r1);
+}
+
+// RN(sqrt(x)) : error bound = u (correctly rounded)
+static inline double fe_result_sqrt(fe_pair_t x)
+{
+  // CPairSqrt + test: 1 sqrt, 1 div, 1 fma, 1 mul, 6 add
+  double h = sqrt(x.hi);
+  double d = x.hi != 0 ? h+h : 1.0;
+  double t = -fma(h,h,-x.hi);
+  double l = (t+x.lo)/d;                // |sqrt(x)-(h+l)| <= (25/8)u^2|h|
+  double e = 0x1.0p-99*h;
+  double r0 = h + (l-e);
+  double r1 = h + (l+e);
+
+  if (fe_likely(r0 == r1)) return r0;
+
+  return fe_result_sqrt_slowpath(x,r0,r1);
+}
+
 // RN(a+b+c)  a.k.a correctly rounded.
 static inline double add3_f64(double a, double b, double c)
 {
@@ -1783,6 +2290,50 @@ static inline double sum4_cr_f64(double a, double b, double c, double d)
   return fe_result_add(x,y);
 }
 
+// correctly rounded lowering of 'fr' values. These don't require the
+// inputs to be normalized (|lo| can be larger than ulp(hi)/2) and
+// don't pay for normalizing them along the fast-path.
+
+// RN(x) : just here for completeness. x.hi+x.lo is a single
+// rounding of the exact represented value so `fr_result` is
+// already correctly rounded. (it's the value represented by 'x'
+// that carries the error of the ops that produced it)
+static inline double fr_result_cr(fr_pair_t x) { return x.hi+x.lo; }
+
+// RN(x+c)
+static inline double fr_result_add_d(fr_pair_t x, double c)
+{
+  // [8] EmulADD3 (mod): 12 adds (following fast-path)
+  return add3_f64(x.hi,x.lo,c);
+}
+
+// RN(x+y) : error bound = u (correctly rounded)
+static inline double fr_result_add(fr_pair_t x, fr_pair_t y)
+{
+  // CPairSum + rounding test: 13 adds, 1 mul (following fast-path)
+  // X = s.hi+s.lo+x.lo+y.lo (exact) and the computed
+  //   |X-(s.hi+l)| <= u(|a|+|l|)
+  // the rounding test (see: fe_result_mul) uses 4u(|a|+|l|)
+  // slow-path is Sum4 (67 adds) and is reached when X is near a
+  // midpoint or when |a| is large WRT the result (cancellation).
+  fe_pair_t s  = fe_two_sum(x.hi,y.hi);   // 6 adds
+  double    a  = x.lo + y.lo;
+  double    l  = s.lo + a;
+  double    e  = 0x1.0p-51*(fabs(a)+fabs(l));
+  double    r0 = s.hi + (l-e);
+  double    r1 = s.hi + (l+e);
+
+  if (fe_likely(r0 == r1)) return r0;
+
+  return fr_result_add_slowpath(x,y);
+}
+
+// RN(x-y) : error bound = u (correctly rounded)
+static inline double fr_result_sub(fr_pair_t x, fr_pair_t y)
+{
+  return fr_result_add(x,fr_neg(y));
+}
+
 // ab+cd
 // error bound = 3u & 2u if sign(ab)==sign(cd)  (Kahan)
 static inline double mma_f64(double a, double b, double c, double d)
@@ -1855,16 +2406,120 @@ static const fe_pair_t fe_k_sqrt_2   = {.hi = 0x1.6a09e667f3bcdp0,  .lo=-0x1.bdd
 static const fe_pair_t fe_k_sqrt_2_i = {.hi = 0x1.6a09e667f3bcdp-1, .lo=-0x1.bdd3413b26456p-55};
 
 
+/// ## Multiplication by a constant
+///
+/// `fe_const_t` is a constant $K=h+l$ (as a normalized pair) with the
+/// precomputed ratio $r = \text{RN}\left(l/h\right)$. Since the constant
+/// is known ahead of time the two cross terms of the pair product
+/// collapse into one: $x_h l + x_l h = h\left(x_h r + x_l\right) + O(u^2)$
+///
+/// * `fe_mul_k(x,k)`  : $Kx$ for pair $x$.   3 fma, 1 mul, 3 add (`fe_mul` is 3 fma, 2 mul, 4 add)
+/// * `fe_mul_k_d(x,k)`: $Kx$ for double $x$. 3 fma, 1 mul (`fe_mul_d` is 2 fma, 1 mul, 3 add)
+/// <br>
+/// `fe_mul_k_d` computes 'hi' directly as $\text{RN}\left(hx + \text{RN}(lx)\right)$ (see the
+/// ConstAddMul link above) which is $\text{RN}(Kx)$ except for rare hard cases
+/// and then the exact remainder via FMA. No renormalization is needed: $|lo|$
+/// is at most a hair over $\frac{1}{2}\text{ulp}(hi)$ in the hard cases.
+/// Peak errors measured (`test/f64_pair_test.c`) for $K$ in the constant
+/// table: `fe_mul_k` ~4.4 ulp (vs. ~3.5 for `fe_mul`), `fe_mul_k_d` ~0.5 ulp
+/// (vs. ~2.0 for `fe_mul_d`) in units of $2^{-106}$ relative.
+/// <br>
+/// `fe_mul_k` is the one that trades accuracy for speed. The rounding of
+/// $x_h r + x_l$ is scaled by $h$ and replaces `fe_mul`'s separate
+/// rounding of the cross terms. That is up to ~1 more ulp (a bound of
+/// ~5 ulp vs. 4 for DWTimesDW3) for a shorter dependency chain:
+/// ~25% lower latency and ~8% higher throughput than `fe_mul` (x86-64).
+/// Use `fe_mul(x, fe_const_pair(k))` when that ulp matters.
+
+typedef struct { double hi, lo, r; } fe_const_t;
+
+static inline fe_const_t fe_const_init(fe_pair_t k)
+{
+  fe_const_t c = {.hi = k.hi, .lo = k.lo, .r = (k.hi != 0.0) ? k.lo/k.hi : 0.0};
+  return c;
+}
+
+static inline fe_pair_t fe_const_pair(fe_const_t k) { return fe_pair(k.hi,k.lo); }
+
+static inline fe_pair_t fe_mul_k(fe_pair_t x, fe_const_t k)
+{
+  // 3 fma, 1 mul, 3 add
+  fe_pair_t p = fe_two_mul(x.hi,k.hi);  // 1 fma, 1 mul
+  double    c = fma(x.hi,k.r,x.lo);     // (x.hi·l+x.lo·h)/h
+  double    d = fma(c,k.hi,p.lo);
+  return fe_fast_sum(p.hi,d);           // 3 adds
+}
+
+static inline fe_pair_t fe_mul_k_d(double x, fe_const_t k)
+{
+  // 3 fma, 1 mul
+  double h = fma(k.hi,x,k.lo*x);        // RN(Kx) except hard cases
+  double e = fma(k.hi,x,-h);            // hx-h
+  double l = fma(k.lo,x,e);             // lx+hx-h
+  return fe_pair(h,l);
+}
+
+// batch forms: r[i] = K·x[i]
+static inline void fe_mul_k_batch(const fe_pair_t* x, size_t n, fe_pair_t* r, fe_const_t k)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_mul_k(x[i],k);
+}
+
+static inline void fe_mul_k_d_batch(const double* x, size_t n, fe_pair_t* r, fe_const_t k)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_mul_k_d(x[i],k);
+}
+
+
+// 32-bit words to double by the exponent bias: (2^52+x)-2^52 is exact.
+// only integer ops and a subtract so the batch forms vectorize without
+// 64-bit integer conversions (AVX-512DQ)
+static inline double fe_u32_to_d_i(uint32_t x)
+{
+  return fe_from_bits(UINT64_C(0x4330000000000000) | x) - 0x1.0p52;
+}
+
+// x·2^32 (high word)
+static inline double fe_u32_hi_to_d_i(uint32_t x)
+{
+  return fe_from_bits(UINT64_C(0x4530000000000000) | x) - 0x1.0p84;
+}
+
+// x·2^32 (signed high word): bias by 2^31
+static inline double fe_i32_hi_to_d_i(int32_t x)
+{
+  uint32_t u = (uint32_t)x ^ UINT32_C(0x80000000);
+  return fe_from_bits(UINT64_C(0x4530000000000000) | u) - 0x1.000008p84;
+}
+
 static inline fe_pair_t fe_from_i64(int64_t x)
 {
   // split the hi word so no rounding occurs
-  double a = (double)(x & (int64_t)UINT64_C(0xffffffff00000000));
-  double b = (double)(x-((int64_t)a));
+  double a = fe_i32_hi_to_d_i((int32_t)(x >> 32));
+  double b = fe_u32_to_d_i((uint32_t)x);
 
   // fast-sum to canonicalize: note legal when a=0
   return fe_fast_sum(a,b);
 }
 
+static inline fe_pair_t fe_from_u64(uint64_t x)
+{
+  double a = fe_u32_hi_to_d_i((uint32_t)(x >> 32));
+  double b = fe_u32_to_d_i((uint32_t)x);
+
+  return fe_fast_sum(a,b);
+}
+
+static inline void fe_from_i64_batch(const int64_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_from_i64(x[i]);
+}
+
+static inline void fe_from_u64_batch(const uint64_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_from_u64(x[i]);
+}
+
 
 // if conversion of hi of 'x' cannot integer overflow
 static inline int64_t fe_to_i64_i(fe_pair_t x)
@@ -1893,23 +2548,531 @@ static inline fr_pair_t fr_zero(void)      { return fr_set_d( 0.0);  }
 static inline fe_pair_t fe_neg_zero(void)  { return fe_set_d(-0.0);  }
 static inline fr_pair_t fr_neg_zero(void)  { return fr_set_d(-0.0);  }
 
-static inline _Bool fe_eq_zero(fe_pair_t x) { return x.hi      == 0.0; }   // if hi is zero then illegal for lo to be non-zero
-static inline _Bool fr_eq_zero(fr_pair_t x) { return x.hi+x.lo == 0.0; }
-static inline _Bool fe_gt_zero(fe_pair_t x) { return x.hi      >  0.0; }
-static inline _Bool fr_gt_zero(fr_pair_t x) { return x.hi+x.lo >  0.0; }
+static inline bool fe_eq_zero(fe_pair_t x) { return x.hi      == 0.0; }   // if hi is zero then illegal for lo to be non-zero
+static inline bool fr_eq_zero(fr_pair_t x) { return x.hi+x.lo == 0.0; }
+static inline bool fe_gt_zero(fe_pair_t x) { return x.hi      >  0.0; }
+static inline bool fr_gt_zero(fr_pair_t x) { return x.hi+x.lo >  0.0; }
+
+
+/// ## Comparisons, min/max & array kernels
+///
+/// For normalized pairs the order is lexicographic on (hi,lo): if 'hi'
+/// differ then so do the values (in the same order) since $|lo|$ is at
+/// most half an ulp of 'hi' (with ties to even). The predicates are
+/// written with non-short-circuit `&`,`|` so they compile to compares
+/// and selects (no branches). As with doubles all ordered comparisons
+/// are false if either input is NaN.
+///
+/// * `fe_min`,`fe_max` : like `fmin`/`fmax` a NaN input returns the other
+/// * `fe_clamp`        : $x$ clamped to $[a,b]$ (NaN $x$ returns NaN)
+/// * `fe_cmp`          : -1, 0 or 1 for $x<y$, $x=y$, $x>y$ (0 if unordered)
+/// * `fe_sign`         : -1, 0 or 1 for the sign of $x$ (0 for zeros and NaN)
+
+static inline bool fe_eq(fe_pair_t x, fe_pair_t y) { return (x.hi == y.hi) & (x.lo == y.lo); }
+static inline bool fe_ne(fe_pair_t x, fe_pair_t y) { return (x.hi != y.hi) | (x.lo != y.lo); }
+static inline bool fe_gt(fe_pair_t x, fe_pair_t y) { return (x.hi >  y.hi) | ((x.hi == y.hi) & (x.lo >  y.lo)); }
+static inline bool fe_ge(fe_pair_t x, fe_pair_t y) { return (x.hi >  y.hi) | ((x.hi == y.hi) & (x.lo >= y.lo)); }
+static inline bool fe_lt(fe_pair_t x, fe_pair_t y) { return (x.hi <  y.hi) | ((x.hi == y.hi) & (x.lo <  y.lo)); }
+static inline bool fe_le(fe_pair_t x, fe_pair_t y) { return (x.hi <  y.hi) | ((x.hi == y.hi) & (x.lo <= y.lo)); }
+
+static inline fe_pair_t fe_select(bool c, fe_pair_t x, fe_pair_t y)
+{
+  return fe_pair(c ? x.hi : y.hi, c ? x.lo : y.lo);
+}
+
+static inline fe_pair_t fe_min(fe_pair_t x, fe_pair_t y)
+{
+  return fe_select(fe_lt(y,x) | (x.hi != x.hi), y, x);
+}
+
+static inline fe_pair_t fe_max(fe_pair_t x, fe_pair_t y)
+{
+  return fe_select(fe_gt(y,x) | (x.hi != x.hi), y, x);
+}
+
+static inline fe_pair_t fe_clamp(fe_pair_t x, fe_pair_t a, fe_pair_t b)
+{
+  x = fe_select(fe_lt(x,a), a, x);
+  return fe_select(fe_gt(x,b), b, x);
+}
+
+static inline int fe_cmp(fe_pair_t x, fe_pair_t y)  { return (int)fe_gt(x,y) - (int)fe_lt(x,y); }
+static inline int fe_sign(fe_pair_t x)              { return (int)(x.hi > 0.0) - (int)(x.hi < 0.0); }
+
+// SoA array kernels: element 'i' is the pair (hi[i],lo[i]).
+//
+// The reductions keep `FE_CMP_LANES` independent candidates (updated in
+// lockstep like `fe_accum_t` in f64_pair_sum.h) so the inner loop is a
+// fixed width block of selects that vectorizes. NaN elements are skipped
+// so min/max return NaN and argmin/argmax return 'n' only if there are no
+// ordered elements (including n=0). argmin/argmax return the first index
+// of the extreme value.
+//
+// The masked compares set m[i] = cmp(x[i],y) (0 or 1) and return the
+// number of set elements.
+
+#ifndef FE_CMP_LANES
+#define FE_CMP_LANES 8
+#endif
+
+static inline fe_pair_t fe_min_soa(const double* hi, const double* lo, size_t n)
+{
+  double mh[FE_CMP_LANES], ml[FE_CMP_LANES];
+  size_t i = 0;
+
+  for(uint32_t j=0; j<FE_CMP_LANES; j++) { mh[j] = NAN; ml[j] = NAN; }
+
+  for(; n-i >= FE_CMP_LANES; i += FE_CMP_LANES) {
+    for(uint32_t j=0; j<FE_CMP_LANES; j++) {
+      fe_pair_t m = fe_min(fe_pair(mh[j],ml[j]), fe_pair(hi[i+j],lo[i+j]));
+      mh[j] = m.hi; ml[j] = m.lo;
+    }
+  }
+
+  fe_pair_t r = fe_pair(mh[0],ml[0]);
+
+  for(uint32_t j=1; j<FE_CMP_LANES; j++) r = fe_min(r, fe_pair(mh[j],ml[j]));
+  for(; i<n; i++)                        r = fe_min(r, fe_pair(hi[i],lo[i]));
+
+  return r;
+}
+
+static inline fe_pair_t fe_max_soa(const double* hi, const double* lo, size_t n)
+{
+  double mh[FE_CMP_LANES], ml[FE_CMP_LANES];
+  size_t i = 0;
+
+  for(uint32_t j=0; j<FE_CMP_LANES; j++) { mh[j] = NAN; ml[j] = NAN; }
+
+  for(; n-i >= FE_CMP_LANES; i += FE_CMP_LANES) {
+    for(uint32_t j=0; j<FE_CMP_LANES; j++) {
+      fe_pair_t m = fe_max(fe_pair(mh[j],ml[j]), fe_pair(hi[i+j],lo[i+j]));
+      mh[j] = m.hi; ml[j] = m.lo;
+    }
+  }
+
+  fe_pair_t r = fe_pair(mh[0],ml[0]);
+
+  for(uint32_t j=1; j<FE_CMP_LANES; j++) r = fe_max(r, fe_pair(mh[j],ml[j]));
+  for(; i<n; i++)                        r = fe_max(r, fe_pair(hi[i],lo[i]));
+
+  return r;
+}
+
+// lane candidates are (mh,ml,mi). an empty lane is a NaN value with
+// index 'n'. 'c' selects the element: x strictly before the candidate in
+// the order (or the candidate is empty and x isn't NaN)
+static inline size_t fe_arg_soa_i(const double* hi, const double* lo, size_t n, bool max)
+{
+  double mh[FE_CMP_LANES], ml[FE_CMP_LANES];
+  size_t mi[FE_CMP_LANES];
+  size_t i = 0;
+
+  for(uint32_t j=0; j<FE_CMP_LANES; j++) { mh[j] = NAN; ml[j] = NAN; mi[j] = n; }
+
+  for(; n-i >= FE_CMP_LANES; i += FE_CMP_LANES) {
+    for(uint32_t j=0; j<FE_CMP_LANES; j++) {
+      fe_pair_t x = fe_pair(hi[i+j],lo[i+j]);
+      fe_pair_t m = fe_pair(mh[j],ml[j]);
+      bool      c = (max ? fe_gt(x,m) : fe_lt(x,m)) | ((m.hi != m.hi) & (x.hi == x.hi));
+
+      mh[j] = c ? x.hi : mh[j];
+      ml[j] = c ? x.lo : ml[j];
+      mi[j] = c ? i+j  : mi[j];
+    }
+  }
+
+  // merge the lanes then the tail: ties go to the lower index
+  fe_pair_t r = fe_pair(mh[0],ml[0]);
+  size_t    k = mi[0];
+
+  for(uint32_t j=1; j<FE_CMP_LANES; j++) {
+    fe_pair_t x = fe_pair(mh[j],ml[j]);
+    bool      c = (max ? fe_gt(x,r) : fe_lt(x,r)) | ((r.hi != r.hi) & (x.hi == x.hi));
+
+    c |= fe_eq(x,r) & (mi[j] < k);
+    r  = fe_select(c, x, r);
+    k  = c ? mi[j] : k;
+  }
+
+  for(; i<n; i++) {
+    fe_pair_t x = fe_pair(hi[i],lo[i]);
+    bool      c = (max ? fe_gt(x,r) : fe_lt(x,r)) | ((r.hi != r.hi) & (x.hi == x.hi));
+
+    r = fe_select(c, x, r);
+    k = c ? i : k;
+  }
+
+  return k;
+}
+
+static inline size_t fe_argmin_soa(const double* hi, const double* lo, size_t n) { return fe_arg_soa_i(hi,lo,n,false); }
+static inline size_t fe_argmax_soa(const double* hi, const double* lo, size_t n) { return fe_arg_soa_i(hi,lo,n,true);  }
+
+#define FE_CMP_SOA(OP)                                                     \
+static inline size_t fe_##OP##_soa(const double* hi, const double* lo,     \
+                                   size_t n, uint8_t* m, fe_pair_t y)      \
+{                                                                          \
+  size_t c = 0;                                                            \
+                                                                           \
+  for(size_t i=0; i<n; i++) {                                              \
+    bool b = fe_##OP(fe_pair(hi[i],lo[i]), y);                             \
+    m[i]   = (uint8_t)b;                                                   \
+    c     += b;                                                            \
+  }                                                                        \
+                                                                           \
+  return c;                                                                \
+}
+
+FE_CMP_SOA(lt)
+FE_CMP_SOA(le)
+FE_CMP_SOA(gt)
+FE_CMP_SOA(ge)
+FE_CMP_SOA(eq)
+FE_CMP_SOA(ne)
+
+#undef FE_CMP_SOA
+
+
+/// ## Rounding to integer, remainders & scaling
+///
+/// All of the rounding functions are exact. If 'hi' isn't an integer
+/// then $|hi| < 2^{52}$ and 'lo' is below the spacing of 'hi' so it
+/// can only matter when 'hi' is a half-integer (round, nearbyint). If
+/// 'hi' is an integer then the result is 'hi' plus 'lo' rounded with
+/// the sign of $x$ (trunc, round) or the parity of 'hi' (nearbyint)
+/// taken into account. The cases are selects (no branches) so the
+/// batch forms vectorize.
+///
+/// * `fe_nearbyint` : ties to even (assumes the default rounding mode)
+/// * `fe_round`     : ties away from zero
+/// * `fe_fmod`      : $x-ny$ with $n = \text{trunc}(x/y)$
+/// * `fe_remquo`    : $x-ny$ with $n = \text{nearbyint}(x/y)$ and the low 3 bits of $n$ (with the sign of $x/y$)
+/// <br>
+/// The remainder functions are exact when the result is representable
+/// as a pair (always the case unless the bits of 'x' and 'y' span more
+/// than a pair can hold). Both are a loop of ~48 quotient bits per
+/// step so they're in the implementation section.
+/// `fe_ldexp` is exact unless 'lo' underflows or 'hi' overflows and
+/// `fe_frexp` returns $m$ with $\frac{1}{2} \le |m| < 1$.
+
+static inline fe_pair_t fe_floor(fe_pair_t x)
+{
+  double h = floor(x.hi);
+  double l = (h == x.hi) ? floor(x.lo) : copysign(0.0,h);
+
+  return fe_fast_sum(h,l);
+}
+
+static inline fe_pair_t fe_ceil(fe_pair_t x)
+{
+  double h = ceil(x.hi);
+  double l = (h == x.hi) ? ceil(x.lo) : copysign(0.0,h);
+
+  return fe_fast_sum(h,l);
+}
+
+static inline fe_pair_t fe_trunc(fe_pair_t x)
+{
+  double h = trunc(x.hi);
+  double l = (x.hi > 0.0) ? floor(x.lo) : ceil(x.lo);
+
+  l = (h == x.hi) ? l : copysign(0.0,h);
+
+  return fe_fast_sum(h,l);
+}
+
+// hi isn't an integer: 'h' is hi rounded unless hi is a half-integer and
+// lo breaks the tie
+static inline double fe_round_hi_i(fe_pair_t x, double h)
+{
+  double t = (x.lo > 0.0) ? ceil(x.hi) : floor(x.hi);
+  bool   m = (fabs(x.hi-trunc(x.hi)) == 0.5) && (x.lo != 0.0);
+
+  return m ? t : h;
+}
+
+static inline fe_pair_t fe_round(fe_pair_t x)
+{
+  // hi is an integer: lo rounded with ties away from zero WRT the sign of x
+  double a = floor(x.lo);
+  double b = ceil(x.lo);
+  double u = (x.lo - a >= 0.5) ? a+1.0 : a;   // x > 0 (x.lo-a exact)
+  double d = (b - x.lo >= 0.5) ? b-1.0 : b;   // x < 0
+  double l = (x.hi > 0.0) ? u : d;
+  double h = fe_round_hi_i(x, round(x.hi));
+
+  l = (x.hi == trunc(x.hi)) ? l : copysign(0.0,h);
+
+  return fe_fast_sum(h,l);
+}
+
+static inline fe_pair_t fe_nearbyint(fe_pair_t x)
+{
+  // hi is an integer: lo rounded ties to even is correct unless hi is
+  // odd (then |lo| <= 1/2) and lo is a tie.
+  double l = nearbyint(x.lo);
+  bool   o = (x.hi - 2.0*floor(0.5*x.hi)) != 0.0;
+  double h = fe_round_hi_i(x, nearbyint(x.hi));
+
+  l = (o && fabs(x.lo) == 0.5) ? copysign(1.0,x.lo) : l;
+  l = (x.hi == trunc(x.hi)) ? l : copysign(0.0,h);
+
+  return fe_fast_sum(h,l);
+}
+
+static inline fe_pair_t fe_ldexp(fe_pair_t x, int e)
+{
+  return fe_pair(ldexp(x.hi,e), ldexp(x.lo,e));
+}
+
+static inline fe_pair_t fe_frexp(fe_pair_t x, int* e)
+{
+  int    k;
+  double h = frexp(x.hi,&k);
+  double l = ldexp(x.lo,-k);
+
+  // |h| = 1/2 and lo of the opposite sign: |x| < 2^(k-1)
+  bool   d = (fabs(h) == 0.5) && (h*l < 0.0);
+
+  *e = d ? k-1 : k;
+
+  return d ? fe_pair(2.0*h, 2.0*l) : fe_pair(h,l);
+}
+
+// batch forms: r[i] = f(x[i])
+static inline void fe_floor_batch(const fe_pair_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_floor(x[i]);
+}
+
+static inline void fe_ceil_batch(const fe_pair_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_ceil(x[i]);
+}
+
+static inline void fe_trunc_batch(const fe_pair_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_trunc(x[i]);
+}
+
+static inline void fe_round_batch(const fe_pair_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_round(x[i]);
+}
+
+static inline void fe_nearbyint_batch(const fe_pair_t* x, size_t n, fe_pair_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_nearbyint(x[i]);
+}
+
+/// ## 128-bit integer conversions
+///
+/// `fe_from_i128`/`fe_from_u128` are correctly rounded: $hi = \text{RN}(x)$
+/// and $lo = \text{RN}(x-hi)$ (so exact when $|x| < 2^{106}$). $x$ is split
+/// into 42,43,43-bit words which convert exactly and are summed error-free.
+/// `fe_to_i128`/`fe_to_u128` truncate (like C casts) and are exact when
+/// the result is in range. Out of range values saturate and NaN maps to
+/// the minimum integer (zero for unsigned) like `fe_to_i64`. The in-range
+/// path splits the (integer) 'hi' and 'lo' at $2^{64}$ so has no 128-bit
+/// float conversions (library calls on most targets). Requires a compiler
+/// with `__int128`.
+
+#if defined(__SIZEOF_INT128__)
+
+// a+b+c correctly rounded to a pair: a,b multiples of 2^43 with |a| >= |b|
+// (or a=0) and 0 <= c < 2^43.
+// x = h.hi+l.hi+l.lo exactly. l.hi is replaced by its round-to-odd 'o'
+// (the odd neighbor toward l.lo when inexact) which can't be a midpoint
+// of the 'hi' grid so RN(h.hi+o) = RN(x) even for ties. Then x-hi is
+// (h.hi-hi)+l.hi (exact) plus l.lo and 'lo' is its single rounding.
+static inline fe_pair_t fe_from_words_i(double a, double b, double c)
+{
+  fe_pair_t s = fe_fast_sum(a,b);
+  fe_pair_t t = fe_two_sum(s.lo,c);
+  fe_pair_t h = fe_fast_sum(s.hi,t.hi);
+  fe_pair_t l = fe_two_sum(h.lo,t.lo);
+  uint64_t  u = fe_to_bits(l.hi);
+  uint64_t  d = (l.hi*l.lo > 0.0) ? 1 : UINT64_MAX;
+  double    o = (l.lo != 0.0 && !(u & 1)) ? fe_from_bits(u+d) : l.hi;
+  double    r = h.hi + o;
+
+  return fe_pair(r, ((h.hi-r)+l.hi)+l.lo);
+}
+
+static inline fe_pair_t fe_from_i128(__int128 x)
+{
+  const __int128 m = ((__int128)1 << 43)-1;
+
+  double a = (double)(int64_t)(x >> 86) * 0x1.0p86;
+  double b = (double)(int64_t)((x >> 43) & m) * 0x1.0p43;
+  double c = (double)(int64_t)(x & m);
 
+  return fe_from_words_i(a,b,c);
+}
 
-static inline _Bool fe_eq(fe_pair_t x, fe_pair_t y)
+static inline fe_pair_t fe_from_u128(unsigned __int128 x)
 {
-  return (x.hi == y.hi) && (x.lo == y.lo);
+  const unsigned __int128 m = ((unsigned __int128)1 << 43)-1;
+
+  double a = (double)(int64_t)(x >> 86) * 0x1.0p86;
+  double b = (double)(int64_t)((x >> 43) & m) * 0x1.0p43;
+  double c = (double)(int64_t)(x & m);
+
+  return fe_from_words_i(a,b,c);
 }
 
+// integer valued x with |x| < 2^128: |x| split into exact words at 2^64
+// and the sign applied modulo 2^128
+static inline unsigned __int128 fe_d_to_u128_i(double x)
+{
+  double            a = fabs(x);
+  double            h = trunc(a*0x1.0p-64);
+  double            l = a - h*0x1.0p64;
+  unsigned __int128 r = ((unsigned __int128)(uint64_t)h << 64) | (uint64_t)l;
+  unsigned __int128 s = (unsigned __int128)0 - (x < 0.0);
 
-// gt() { return (x.hi > y.hi || (x.hi == y.hi && x.lo >  y.lo)); }
-// ge() { return (x.hi > y.hi || (x.hi == y.hi && x.lo >= y.lo)); }
-// lt() { return (x.hi < y.hi || (x.hi == y.hi && x.lo <  y.lo)); }
-// le() { return (x.hi < y.hi || (x.hi == y.hi && x.lo <= y.lo)); }
-// ne() { return (x.hi != y.hi || x.lo != y.lo); }
+  return (r ^ s) - s;
+}
+
+extern fe_noinline __int128          fe_to_i128_slowpath(fe_pair_t x, double a);
+extern fe_noinline unsigned __int128 fe_to_u128_slowpath(fe_pair_t x, double a);
+
+// 't' is integral (hi of an infinity can have a NaN lo)
+static inline __int128 fe_to_i128_i(fe_pair_t t)
+{
+  double a = fabs(t.hi);
+
+  if (a < 0x1.0p127) return (__int128)(fe_d_to_u128_i(t.hi) + fe_d_to_u128_i(t.lo));
+
+  return fe_to_i128_slowpath(t,a);
+}
+
+static inline __int128 fe_to_i128(fe_pair_t x) { return fe_to_i128_i(fe_trunc(x)); }
+
+static inline unsigned __int128 fe_to_u128(fe_pair_t x)
+{
+  fe_pair_t t = fe_trunc(x);
+  double    a = t.hi;
+
+  if (a >= 0.0 && a < 0x1.0p128) return fe_d_to_u128_i(t.hi) + fe_d_to_u128_i(t.lo);
+
+  return fe_to_u128_slowpath(t,a);
+}
+
+/// ## Fixed-point (Qm.n)
+///
+/// A signed Qm.n value is an `__int128` 'x' with 'f'=n fraction bits
+/// (m=128-f, $0 \le f \le 127$) and the value $x \cdot 2^{-f}$. Scaling
+/// by $2^{\pm f}$ is exact for pairs so these are the integer conversions
+/// plus `fe_ldexp`:
+/// * `fe_from_q`: correctly rounded (exact when $|x| < 2^{106}$)
+/// * `fe_to_q`:   $x \cdot 2^f$ rounded to nearest (ties to even). Out of
+///   range values saturate and NaN maps to the minimum like `fe_to_i128`
+/// * `fe_{from,to}_q64`: Q64.64
+
+static inline fe_pair_t fe_from_q(__int128 x, int f)  { return fe_ldexp(fe_from_i128(x), -f); }
+static inline __int128  fe_to_q(fe_pair_t x, int f)   { return fe_to_i128_i(fe_nearbyint(fe_ldexp(x, f))); }
+static inline fe_pair_t fe_from_q64(__int128 x)       { return fe_from_q(x, 64); }
+static inline __int128  fe_to_q64(fe_pair_t x)        { return fe_to_q(x, 64); }
+
+static inline void fe_from_q_batch(const __int128* x, size_t n, fe_pair_t* r, int f)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_from_q(x[i],f);
+}
+
+static inline void fe_to_q_batch(const fe_pair_t* x, size_t n, __int128* r, int f)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_to_q(x[i],f);
+}
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+// truncated 'x': |x| >= 2^127 or NaN
+fe_noinline __int128 fe_to_i128_slowpath(fe_pair_t x, double a)
+{
+  const __int128 max = (__int128)(((unsigned __int128)1 << 127)-1);
+  const __int128 min = -max-1;
+
+  // |x| = 2^127 and in range when lo brings it back: |lo| <= 2^73
+  if (x.hi > 0.0) return (a == 0x1.0p127 && x.lo < 0.0) ? max + ((__int128)fe_d_to_u128_i(x.lo) + 1) : max;
+  if (x.hi < 0.0) return (a == 0x1.0p127 && x.lo > 0.0) ? min +  (__int128)fe_d_to_u128_i(x.lo)      : min;
+
+  return min;
+}
+
+// truncated 'x': negative, >= 2^128 or NaN
+fe_noinline unsigned __int128 fe_to_u128_slowpath(fe_pair_t x, double a)
+{
+  const unsigned __int128 max = ~(unsigned __int128)0;
+
+  if (a >= 0x1.0p128) return (a == 0x1.0p128 && x.lo < 0.0) ? max + fe_d_to_u128_i(x.lo) + 1u : max;
+
+  return 0;
+}
+
+#endif
+#endif
+
+/// ## Narrowing conversions
+///
+/// `fe_to_f32`, `fe_to_bf16` and `fe_to_f16` are correctly rounded (to
+/// nearest, ties to even) including subnormal results and overflow to
+/// infinity. `(float)x.hi` isn't: it double rounds when 'hi' is a tie
+/// of the narrow format that 'lo' breaks. Instead 'x' is rounded to odd
+/// at double precision (`fe_result_ro`) which keeps the information the
+/// single final rounding needs since all three formats have at most 24
+/// significand bits (less than 53-1). bfloat16 and binary16 results are
+/// the 16-bit encodings. NaNs convert to quiet NaNs. The batch forms
+/// are branch-free and vectorize.
+
+// round-to-odd of 'x' to a double: infinities pass through (lo can be NaN)
+static inline double fe_narrow_ro_i(fe_pair_t x)
+{
+  double d = fe_result_ro(x);
+  return (fabs(x.hi) <= 0x1.fffffffffffffp1023) ? d : x.hi;
+}
+
+// RN of 'd' to the encoding of a 16-bit binary format with 'm' stored
+// significand bits and exponent bias 'b' (constant folded):
+// * normal:    rebias then round on the bits (ties to even)
+// * subnormal: adding 'c' = 2^(52+1-b-m) rounds to a multiple of 2^(1-b-m)
+// * |d| >= 2^(b+1) or NaN: infinity or a quiet NaN
+static inline uint16_t fe_d_to_h16_i(double d, int m, int b)
+{
+  int      k   = 52-m;
+  uint64_t inf = ((UINT64_C(1) << (15-m))-1) << m;
+  uint64_t u   = fe_to_bits(d);
+  uint64_t a   = u & UINT64_C(0x7fffffffffffffff);
+  uint64_t n   = (a - ((uint64_t)(1023-b) << 52) + ((a >> k) & 1) + ((UINT64_C(1) << (k-1))-1)) >> k;
+  double   c   = fe_from_bits((uint64_t)(1023+53-b-m) << 52);
+  uint64_t z   = fe_to_bits(fabs(d)+c) - fe_to_bits(c);
+  uint64_t r   = (a < ((uint64_t)(1024-b) << 52)) ? z : n;
+
+  r = (a >= ((uint64_t)(1024+b) << 52)) ? inf : r;
+  r = (a >  UINT64_C(0x7ff0000000000000)) ? (inf | (UINT64_C(1) << (m-1))) : r;
+
+  return (uint16_t)(((u >> 48) & 0x8000) | r);
+}
+
+static inline float    fe_to_f32(fe_pair_t x)  { return (float)fe_narrow_ro_i(x); }
+static inline uint16_t fe_to_bf16(fe_pair_t x) { return fe_d_to_h16_i(fe_narrow_ro_i(x), 7, 127); }
+static inline uint16_t fe_to_f16(fe_pair_t x)  { return fe_d_to_h16_i(fe_narrow_ro_i(x), 10, 15); }
+
+static inline void fe_to_f32_batch(const fe_pair_t* x, size_t n, float* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_to_f32(x[i]);
+}
+
+static inline void fe_to_bf16_batch(const fe_pair_t* x, size_t n, uint16_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_to_bf16(x[i]);
+}
+
+static inline void fe_to_f16_batch(const fe_pair_t* x, size_t n, uint16_t* r)
+{
+  for(size_t i=0; i<n; i++) r[i] = fe_to_f16(x[i]);
+}
 
 // generics versions (dd = double-double). Nothing really here yet because
 // I'm not so sure it's an interesting thing to do. Treating double-doubles
@@ -0,0 +1,265 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Shared (multiple writer) pair accumulators built on `f64_pair.h`
+///
+/// * fe_atomic_pair_t: lock-free pair. `fe_atomic_fetch_add` is a 128-bit
+///   CAS loop around `fe_add`
+/// * fe_sharded_pair_t: `FE_SHARDED_SLOTS` cache line padded atomic pairs.
+///   Adds are spread across the slots (by thread) and the slots are summed
+///   on read. For heavily contended totals (histogram bins, etc)
+/// <br>
+/// The lock-free path requires a 16 byte CAS (x86-64 `cmpxchg16b`: GCC/clang
+/// with `-mcx16` or an `-march` that includes it). Otherwise falls back to
+/// a per object spin lock.
+/// <br>
+/// Concurrent adds are applied in some serial order so the result is
+/// that of `fe_add` recursive summation in an unspecified order (see
+/// `f64_pair_sum.h` for reproducible accumulation).
+
+#pragma once
+
+#include <stdatomic.h>
+#include "f64_pair.h"
+
+#if defined(__GCC_HAVE_SYNC_COMPARE_AND_SWAP_16)
+#define FE_ATOMIC_LOCK_FREE 1
+#else
+#define FE_ATOMIC_LOCK_FREE 0
+#endif
+
+#ifndef FE_SHARDED_SLOTS
+#define FE_SHARDED_SLOTS 16        // must be a power of two
+#endif
+
+#ifndef FE_CACHE_LINE
+#define FE_CACHE_LINE 64
+#endif
+
+
+//**********************************************************
+// atomic pair
+
+#if FE_ATOMIC_LOCK_FREE
+
+typedef union {
+  unsigned __int128 u;
+  fe_pair_t         v;
+} fe_atomic_pair_t;
+
+static inline unsigned __int128 fe_atomic_bits_i(fe_pair_t x)
+{
+  unsigned __int128 u; memcpy(&u, &x, 16); return u;
+}
+
+static inline fe_pair_t fe_atomic_pair_i(unsigned __int128 u)
+{
+  fe_pair_t x; memcpy(&x, &u, 16); return x;
+}
+
+static inline unsigned __int128 fe_atomic_cas_i(fe_atomic_pair_t* p, unsigned __int128 o, unsigned __int128 n)
+{
+  return __sync_val_compare_and_swap(&p->u, o, n);
+}
+
+static inline void fe_atomic_init(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  p->u = fe_atomic_bits_i(x);
+}
+
+// CAS with itself as a 16 byte atomic load
+static inline fe_pair_t fe_atomic_load(fe_atomic_pair_t* p)
+{
+  return fe_atomic_pair_i(fe_atomic_cas_i(p, 0, 0));
+}
+
+// returns the previous value
+static inline fe_pair_t fe_atomic_exchange(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  unsigned __int128 n = fe_atomic_bits_i(x);
+  unsigned __int128 o = fe_atomic_cas_i(p, 0, 0);
+  unsigned __int128 r;
+
+  while ((r = fe_atomic_cas_i(p, o, n)) != o) o = r;
+
+  return fe_atomic_pair_i(o);
+}
+
+static inline void fe_atomic_store(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  fe_atomic_exchange(p, x);
+}
+
+// returns the previous value. a failed CAS returns the current value so
+// the retry doesn't need a reload.
+static inline fe_pair_t fe_atomic_fetch_add(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  unsigned __int128 o = fe_atomic_cas_i(p, 0, 0);
+
+  for(;;) {
+    unsigned __int128 n = fe_atomic_bits_i(fe_add(fe_atomic_pair_i(o), x));
+    unsigned __int128 r = fe_atomic_cas_i(p, o, n);
+
+    if (fe_likely(r == o)) return fe_atomic_pair_i(o);
+
+    o = r;
+  }
+}
+
+static inline fe_pair_t fe_atomic_fetch_add_d(fe_atomic_pair_t* p, double x)
+{
+  unsigned __int128 o = fe_atomic_cas_i(p, 0, 0);
+
+  for(;;) {
+    unsigned __int128 n = fe_atomic_bits_i(fe_add_d(fe_atomic_pair_i(o), x));
+    unsigned __int128 r = fe_atomic_cas_i(p, o, n);
+
+    if (fe_likely(r == o)) return fe_atomic_pair_i(o);
+
+    o = r;
+  }
+}
+
+#else
+
+typedef struct {
+  fe_pair_t   v;
+  atomic_flag l;
+} fe_atomic_pair_t;
+
+static inline void fe_atomic_lock_i(fe_atomic_pair_t* p)
+{
+  while (atomic_flag_test_and_set_explicit(&p->l, memory_order_acquire));
+}
+
+static inline void fe_atomic_unlock_i(fe_atomic_pair_t* p)
+{
+  atomic_flag_clear_explicit(&p->l, memory_order_release);
+}
+
+static inline void fe_atomic_init(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  p->v = x;
+  atomic_flag_clear(&p->l);
+}
+
+static inline fe_pair_t fe_atomic_load(fe_atomic_pair_t* p)
+{
+  fe_atomic_lock_i(p);
+  fe_pair_t r = p->v;
+  fe_atomic_unlock_i(p);
+  return r;
+}
+
+static inline fe_pair_t fe_atomic_exchange(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  fe_atomic_lock_i(p);
+  fe_pair_t r = p->v;
+  p->v = x;
+  fe_atomic_unlock_i(p);
+  return r;
+}
+
+static inline void fe_atomic_store(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  fe_atomic_exchange(p, x);
+}
+
+static inline fe_pair_t fe_atomic_fetch_add(fe_atomic_pair_t* p, fe_pair_t x)
+{
+  fe_atomic_lock_i(p);
+  fe_pair_t r = p->v;
+  p->v = fe_add(r, x);
+  fe_atomic_unlock_i(p);
+  return r;
+}
+
+static inline fe_pair_t fe_atomic_fetch_add_d(fe_atomic_pair_t* p, double x)
+{
+  fe_atomic_lock_i(p);
+  fe_pair_t r = p->v;
+  p->v = fe_add_d(r, x);
+  fe_atomic_unlock_i(p);
+  return r;
+}
+
+#endif
+
+
+//**********************************************************
+// sharded pair
+//
+// Each slot is on its own cache line so writers to different slots
+// don't contend. The slot is either explicit (`_slot` versions: e.g. a
+// worker index) or assigned to each thread (round-robin on first use).
+// `fe_sharded_load` is the sum of the slots (`fe_add` in slot order)
+// and isn't an atomic snapshot if there are concurrent writers.
+// Size is FE_SHARDED_SLOTS*FE_CACHE_LINE bytes (1K by default).
+
+typedef struct {
+  _Alignas(FE_CACHE_LINE) fe_atomic_pair_t s;
+} fe_sharded_slot_t;
+
+typedef struct {
+  fe_sharded_slot_t slot[FE_SHARDED_SLOTS];
+} fe_sharded_pair_t;
+
+static inline void fe_sharded_init(fe_sharded_pair_t* p)
+{
+  for(uint32_t i=0; i<FE_SHARDED_SLOTS; i++)
+    fe_atomic_init(&p->slot[i].s, fe_zero());
+}
+
+// per thread slot index: assigned on first use
+static inline uint32_t fe_sharded_thread_slot(void)
+{
+  static atomic_uint         next = 0;
+  static _Thread_local int32_t id = -1;
+
+  if (fe_unlikely(id < 0))
+    id = (int32_t)(atomic_fetch_add_explicit(&next, 1, memory_order_relaxed) & (FE_SHARDED_SLOTS-1));
+
+  return (uint32_t)id;
+}
+
+static inline void fe_sharded_add_slot(fe_sharded_pair_t* p, fe_pair_t x, uint32_t slot)
+{
+  fe_atomic_fetch_add(&p->slot[slot & (FE_SHARDED_SLOTS-1)].s, x);
+}
+
+static inline void fe_sharded_add_d_slot(fe_sharded_pair_t* p, double x, uint32_t slot)
+{
+  fe_atomic_fetch_add_d(&p->slot[slot & (FE_SHARDED_SLOTS-1)].s, x);
+}
+
+static inline void fe_sharded_add(fe_sharded_pair_t* p, fe_pair_t x)
+{
+  fe_sharded_add_slot(p, x, fe_sharded_thread_slot());
+}
+
+static inline void fe_sharded_add_d(fe_sharded_pair_t* p, double x)
+{
+  fe_sharded_add_d_slot(p, x, fe_sharded_thread_slot());
+}
+
+static inline fe_pair_t fe_sharded_load(fe_sharded_pair_t* p)
+{
+  fe_pair_t r = fe_atomic_load(&p->slot[0].s);
+
+  for(uint32_t i=1; i<FE_SHARDED_SLOTS; i++)
+    r = fe_add(r, fe_atomic_load(&p->slot[i].s));
+
+  return r;
+}
+
+// returns the sum and zeros the slots (each slot is atomically exchanged)
+static inline fe_pair_t fe_sharded_exchange_zero(fe_sharded_pair_t* p)
+{
+  fe_pair_t r = fe_atomic_exchange(&p->slot[0].s, fe_zero());
+
+  for(uint32_t i=1; i<FE_SHARDED_SLOTS; i++)
+    r = fe_add(r, fe_atomic_exchange(&p->slot[i].s, fe_zero()));
+
+  return r;
+}
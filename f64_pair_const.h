@@ -0,0 +1,319 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Compile time pair constants from decimal (or hex) literals
+///
+/// `FE_CONST(X)` where 'X' is a floating point literal (decimal with a
+/// '.' and/or exponent or hex float) gives the pair $\left(\text{RN}(K),~\text{RN}(K-\text{RN}(K))\right)$
+/// for the value $K$ of the literal:
+///
+///     static const fe_pair_t k_h  = FE_CONST(6.62607015e-34);
+///     static const fe_pair_t k_g  = FE_CONST(0.5772156649015328606065120900824024310422);
+///     static const fe_pair_t k_pi = FE_CONST(0x1.921fb54442d18469898cc51701b8p1);
+///
+/// * C++17 and later: `fe_const(const char*)` is constexpr and is
+///   correctly rounded for every input: exact rational arithmetic on
+///   fixed size big integers. `FE_CONST(X)` is `fe_const(#X)`. Invalid
+///   strings and values that overflow are compile errors (in constant
+///   expressions).
+/// * C: `FE_CONST(X)` is an initializer evaluated by the compiler in
+///   binary128 (GCC's `__float128`, otherwise `long double`). 'hi' is
+///   correct and 'lo' is faithful: the double rounding through binary128
+///   makes it 1 ulp off for roughly one in a hundred constants. With an
+///   80-bit `long double` only ~11 bits of 'lo' are meaningful.
+///
+/// Neither needs runtime parsing or MPFR.
+
+#pragma once
+
+#include "f64_pair.h"
+
+#if defined(__cplusplus)
+
+#if (__cplusplus < 201703L)
+#error "f64_pair_const.h: C++17 or later required (f64_pair.h has hex float literals)"
+#endif
+
+// big integer size (32-bit words): enough for any double range decimal
+// with a few hundred digits
+#ifndef FE_CONST_WORDS
+#define FE_CONST_WORDS 64
+#endif
+
+namespace fe_const_i {
+
+const int words = FE_CONST_WORDS;
+
+// non-constexpr: reaching it in a constant expression is a compile error
+inline double error(const char*) { return NAN; }
+
+struct big_t { uint32_t w[FE_CONST_WORDS]; };
+
+constexpr int bits(const big_t& a)
+{
+  for(int i=words-1; i>=0; i--) {
+    if (a.w[i]) {
+      uint32_t x = a.w[i];
+      int      b = 32;
+      while (!(x >> 31)) { x <<= 1; b--; }
+      return 32*i+b;
+    }
+  }
+  return 0;
+}
+
+// a = a*m+c. false on overflow
+constexpr bool mul_add(big_t& a, uint32_t m, uint32_t c)
+{
+  uint64_t t = c;
+
+  for(int i=0; i<words; i++) {
+    t += (uint64_t)a.w[i]*m;
+    a.w[i] = (uint32_t)t;
+    t >>= 32;
+  }
+
+  return t == 0;
+}
+
+constexpr big_t shl(const big_t& a, int n)
+{
+  big_t r{};
+  int   q = n >> 5;
+  int   s = n & 31;
+
+  for(int i=0; i+q<words; i++) {
+    uint64_t v = (uint64_t)a.w[i] << s;
+    r.w[i+q] |= (uint32_t)v;
+    if (i+q+1 < words) r.w[i+q+1] |= (uint32_t)(v >> 32);
+  }
+
+  return r;
+}
+
+constexpr void shr1(big_t& a)
+{
+  for(int i=0; i<words-1; i++) a.w[i] = (a.w[i] >> 1) | (a.w[i+1] << 31);
+  a.w[words-1] >>= 1;
+}
+
+constexpr int cmp(const big_t& a, const big_t& b)
+{
+  for(int i=words-1; i>=0; i--)
+    if (a.w[i] != b.w[i]) return (a.w[i] < b.w[i]) ? -1 : 1;
+
+  return 0;
+}
+
+// a -= b (a >= b)
+constexpr void sub(big_t& a, const big_t& b)
+{
+  int64_t t = 0;
+
+  for(int i=0; i<words; i++) {
+    t += (int64_t)a.w[i] - (int64_t)b.w[i];
+    a.w[i] = (uint32_t)t;
+    t >>= 32;
+  }
+}
+
+constexpr double pow2(int e)
+{
+  double r = 1.0;
+
+  for(; e > 0; e--) r *= 2.0;
+  for(; e < 0; e++) r *= 0.5;     // exact down to 2^-1074
+
+  return r;
+}
+
+// RN(p/q·2^e) and the residual p/q·2^e - RN(..) = ±rp/rq·2^re
+struct rnd_t {
+  double v;
+  big_t  rp, rq;
+  int    re;
+  bool   neg;     // residual sign
+  bool   ok;
+};
+
+constexpr rnd_t round(const big_t& p, const big_t& q, int e)
+{
+  rnd_t r{};
+
+  r.ok = true;
+
+  if (bits(p) == 0) return r;
+
+  // p/q·2^-j on [2^52,2^54) and k = j+e clamped to the subnormal range
+  // (which only makes the quotient smaller). one position up if the
+  // quotient is 2^53 or larger.
+  int      j = bits(p) - bits(q) - 53;
+  int      k = j + e;
+  big_t    a{}, b{};
+  uint64_t m = 0;
+
+  if (k < -1074) { j += -1074-k; k = -1074; }
+
+  for(;;) {
+    a = (j < 0) ? shl(p,-j) : p;
+    b = (j > 0) ? shl(q, j) : q;
+
+    if (bits(a) > 32*words-2 || bits(b) > 32*words-57) { r.ok = false; return r; }
+
+    // m = floor(a/b) < 2^54. 'a' becomes the remainder
+    big_t s = shl(b,54);
+
+    m = 0;
+
+    for(int i=54; i>=0; i--) {
+      if (cmp(a,s) >= 0) { sub(a,s); m |= UINT64_C(1) << i; }
+      shr1(s);
+    }
+
+    if (m < (UINT64_C(1) << 53)) break;
+
+    j++; k++;
+  }
+
+  // round to nearest even. residual: a/b or (b-a)/b (scaled by 2^k)
+  big_t a2 = shl(a,1);
+  int   c  = cmp(a2,b);
+
+  r.rq = b;
+  r.re = k;
+
+  if (c > 0 || (c == 0 && (m & 1))) {
+    big_t t = b;
+    sub(t,a);
+    r.rp  = t;
+    r.neg = true;
+    m++;
+  }
+  else
+    r.rp = a;
+
+  if (k > 971 || (k == 971 && m == (UINT64_C(1) << 53))) { r.ok = false; return r; }
+
+  r.v = (double)m * pow2(k);
+
+  return r;
+}
+
+constexpr int digit(char c, int base)
+{
+  int d = (c >= '0' && c <= '9') ? c-'0'
+        : (c >= 'a' && c <= 'f') ? c-'a'+10
+        : (c >= 'A' && c <= 'F') ? c-'A'+10 : 99;
+
+  return (d < base) ? d : -1;
+}
+
+// parse & round
+constexpr fe_pair_t parse(const char* s)
+{
+  fe_pair_t r{0.0, 0.0};
+  bool      neg  = false;
+  int       base = 10;
+  int       f    = 0;         // fraction digits
+  int       n    = 0;         // digits
+  big_t     p{};
+
+  if (*s == '-' || *s == '+') neg = (*s++ == '-');
+
+  if (s[0] == '0' && (s[1] == 'x' || s[1] == 'X')) { base = 16; s += 2; }
+
+  for(bool frac = false;; s++) {
+    if (*s == '.' && !frac) { frac = true; continue; }
+
+    int d = digit(*s, base);
+
+    if (d < 0) break;
+
+    if (!mul_add(p, (uint32_t)base, (uint32_t)d)) { r.hi = error("fe_const: too many digits"); return r; }
+
+    n++;
+    f += frac;
+  }
+
+  if (n == 0) { r.hi = error("fe_const: no digits"); return r; }
+
+  // exponent: 'e' (power of 10) or 'p' (power of 2 for hex)
+  int x = 0;
+
+  if ((base == 10 && (*s == 'e' || *s == 'E')) || (base == 16 && (*s == 'p' || *s == 'P'))) {
+    bool xn = false;
+    s++;
+
+    if (*s == '-' || *s == '+') xn = (*s++ == '-');
+
+    if (digit(*s,10) < 0) { r.hi = error("fe_const: bad exponent"); return r; }
+
+    for(; digit(*s,10) >= 0; s++) {
+      x = 10*x + digit(*s,10);
+      if (x > 100000) { r.hi = error("fe_const: exponent out of range"); return r; }
+    }
+
+    if (xn) x = -x;
+  }
+
+  // allow a C literal suffix
+  if (*s == 'f' || *s == 'F' || *s == 'l' || *s == 'L') s++;
+
+  if (*s != 0) { r.hi = error("fe_const: invalid string"); return r; }
+
+  // value = p/q·2^e
+  big_t q{};
+  int   e = 0;
+
+  q.w[0] = 1;
+
+  if (base == 16)
+    e = x - 4*f;
+  else {
+    int t = x - f;
+
+    if (t > 400 || t < -800) { r.hi = error("fe_const: exponent out of range"); return r; }
+
+    bool ok = true;
+
+    for(; t > 0; t--) ok &= mul_add(p,10,0);
+    for(; t < 0; t++) ok &= mul_add(q,10,0);
+
+    if (!ok) { r.hi = error("fe_const: FE_CONST_WORDS too small"); return r; }
+  }
+
+  rnd_t h = round(p,q,e);
+
+  if (!h.ok) { r.hi = error("fe_const: overflow"); return r; }
+
+  rnd_t l = round(h.rp, h.rq, h.re);
+
+  if (!l.ok) { r.hi = error("fe_const: FE_CONST_WORDS too small"); return r; }
+
+  r.hi = neg ? -h.v : h.v;
+  r.lo = (neg != h.neg) ? -l.v : l.v;
+
+  return r;
+}
+
+} // fe_const_i
+
+constexpr fe_pair_t fe_const(const char* s) { return fe_const_i::parse(s); }
+
+#define FE_CONST(X) fe_const(#X)
+
+#else
+
+// C: evaluated by the compiler in binary128
+#if defined(__GNUC__) && !defined(__clang__) && defined(__SIZEOF_FLOAT128__)
+typedef __float128 fe_const_q_t;
+#define FE_CONST_Q(X) X##Q
+#else
+typedef long double fe_const_q_t;
+#define FE_CONST_Q(X) X##L
+#endif
+
+#define FE_CONST(X) { .hi = (double)FE_CONST_Q(X), .lo = (double)(FE_CONST_Q(X) - (fe_const_q_t)(double)FE_CONST_Q(X)) }
+
+#endif
@@ -0,0 +1,983 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Geometry built on `f64_pair.h`
+///
+/// * fe_{orient2d,orient3d,incircle,insphere}: robust (exact sign)
+///   geometric predicates. return -1, 0 or 1
+/// * fe_*_stage: same but also return the stage that decided the sign
+/// * fe_*_batch: indexed batch forms with per stage counts
+/// * fe_vec3_t, fe_mat3_t: 3D vectors and 3x3 matrices in pair
+///   precision with SoA batch forms for point clouds
+/// <br>
+/// The predicates follow the sign conventions of Shewchuk's [^1]:
+/// * orient2d(a,b,c) > 0 if a,b,c are counterclockwise
+/// * orient3d(a,b,c,d) > 0 if 'd' is below the plane of a,b,c (where
+///   a,b,c are counterclockwise seen from above)
+/// * incircle(a,b,c,d) > 0 if 'd' is inside the circle through a,b,c
+///   (counterclockwise)
+/// * insphere(a,b,c,d,e) > 0 if 'e' is inside the sphere through a,b,c,d
+///   (with orient3d(a,b,c,d) > 0)
+/// <br>
+/// Each is evaluated in up to three stages and stops as soon as the
+/// sign is certain:
+/// 1. double precision with a forward error bound filter (Shewchuk's
+///    'A' bounds: the error is at most a constant times the permanent)
+/// 2. pair precision from the exact differences of the coordinates
+///    with a u² error bound. orient2d with exact differences is instead
+///    `mms_cr_f64` (correctly rounded so has the exact sign)
+/// 3. exact expansion arithmetic [^1]
+/// <br>
+/// Points are arrays of 2 or 3 doubles. The results are exact in the
+/// absence of overflow and underflow (intermediate products must be
+/// above ~2^-1022/u² in magnitude when nonzero). The non-trivial
+/// routines are only defined in the translation unit that defines
+/// `FE_PAIR_IMPLEMENTATION`.
+///
+/// [^1]: "Adaptive Precision Floating-Point Arithmetic and Fast Robust
+///        Geometric Predicates", Shewchuk, 1997
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "f64_pair.h"
+
+// stage that decided the sign (indices into the batch counters)
+enum { FE_GEOM_FILTER, FE_GEOM_PAIR, FE_GEOM_EXACT, FE_GEOM_STAGES };
+
+extern int fe_orient2d_stage(const double* a, const double* b, const double* c, uint32_t* stage);
+extern int fe_orient3d_stage(const double* a, const double* b, const double* c, const double* d, uint32_t* stage);
+extern int fe_incircle_stage(const double* a, const double* b, const double* c, const double* d, uint32_t* stage);
+extern int fe_insphere_stage(const double* a, const double* b, const double* c, const double* d, const double* e, uint32_t* stage);
+
+static inline int fe_orient2d(const double* a, const double* b, const double* c)
+{
+  return fe_orient2d_stage(a,b,c,NULL);
+}
+
+static inline int fe_orient3d(const double* a, const double* b, const double* c, const double* d)
+{
+  return fe_orient3d_stage(a,b,c,d,NULL);
+}
+
+static inline int fe_incircle(const double* a, const double* b, const double* c, const double* d)
+{
+  return fe_incircle_stage(a,b,c,d,NULL);
+}
+
+static inline int fe_insphere(const double* a, const double* b, const double* c, const double* d, const double* e)
+{
+  return fe_insphere_stage(a,b,c,d,e,NULL);
+}
+
+// batch forms: 'p' is the point array (2 or 3 doubles per point), 'idx'
+// has 3, 4 or 5 point indices per query and r[i] is the sign of query
+// 'i'. if 'stats' is not NULL the number of queries decided by each
+// stage are added to stats[FE_GEOM_*].
+extern void fe_orient2d_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats);
+extern void fe_orient3d_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats);
+extern void fe_incircle_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats);
+extern void fe_insphere_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats);
+
+
+//**********************************************************
+// 3D vectors & 3x3 matrices
+//
+// * `fe_vec3_cross_d`: cross product of double vectors where each
+//   component is the difference of exact products (FD2 [^2]) and
+//   `fe_vec3_cross_f64` the same correctly rounded (`mms_cr_f64`).
+//   The pair versions are accurate relative to the permanent so can
+//   still lose precision on nearly parallel pair inputs.
+// * `fe_vec3_normalize`: via `fe_rsqrt` of the squared length. The zero
+//   vector gives NaNs and (as `fe_rsqrt`) blows up if the squared
+//   length is denormal.
+// * matrices are row major: m.r[i] is row 'i'
+//
+// [^2]: "Emulation of 3Sum, 4Sum, the FMA and the FD2 instructions in
+//       rounded-to-nearest floating-point arithmetic", Graillat & Muller,
+//       2024 (algorithm 13)
+
+typedef struct { fe_pair_t x,y,z; } fe_vec3_t;
+typedef struct { fe_vec3_t r[3];  } fe_mat3_t;
+
+static inline fe_vec3_t fe_vec3(fe_pair_t x, fe_pair_t y, fe_pair_t z)
+{
+  return (fe_vec3_t){.x=x, .y=y, .z=z};
+}
+
+static inline fe_vec3_t fe_vec3_d(double x, double y, double z)
+{
+  return fe_vec3(fe_set_d(x), fe_set_d(y), fe_set_d(z));
+}
+
+// p[0..2]
+static inline fe_vec3_t fe_vec3_load_d(const double* p)
+{
+  return fe_vec3_d(p[0],p[1],p[2]);
+}
+
+static inline fe_vec3_t fe_vec3_add(fe_vec3_t a, fe_vec3_t b)
+{
+  return fe_vec3(fe_add(a.x,b.x), fe_add(a.y,b.y), fe_add(a.z,b.z));
+}
+
+static inline fe_vec3_t fe_vec3_sub(fe_vec3_t a, fe_vec3_t b)
+{
+  return fe_vec3(fe_sub(a.x,b.x), fe_sub(a.y,b.y), fe_sub(a.z,b.z));
+}
+
+static inline fe_vec3_t fe_vec3_neg(fe_vec3_t a)
+{
+  return fe_vec3(fe_neg(a.x), fe_neg(a.y), fe_neg(a.z));
+}
+
+// sa
+static inline fe_vec3_t fe_vec3_scale(fe_pair_t s, fe_vec3_t a)
+{
+  return fe_vec3(fe_mul(s,a.x), fe_mul(s,a.y), fe_mul(s,a.z));
+}
+
+static inline fe_vec3_t fe_vec3_scale_d(double s, fe_vec3_t a)
+{
+  return fe_vec3(fe_mul_d(a.x,s), fe_mul_d(a.y,s), fe_mul_d(a.z,s));
+}
+
+static inline fe_pair_t fe_vec3_dot(fe_vec3_t a, fe_vec3_t b)
+{
+  return fe_add(fe_add(fe_mul(a.x,b.x), fe_mul(a.y,b.y)), fe_mul(a.z,b.z));
+}
+
+// dot product of double vectors (exact products)
+static inline fe_pair_t fe_vec3_dot_d(const double* a, const double* b)
+{
+  fe_pair_t x = fe_two_mul(a[0],b[0]);
+  fe_pair_t y = fe_two_mul(a[1],b[1]);
+  fe_pair_t z = fe_two_mul(a[2],b[2]);
+
+  return fe_add(fe_add(x,y),z);
+}
+
+static inline fe_pair_t fe_vec3_norm2(fe_vec3_t a)
+{
+  return fe_add(fe_add(fe_sq(a.x), fe_sq(a.y)), fe_sq(a.z));
+}
+
+static inline fe_pair_t fe_vec3_norm(fe_vec3_t a)
+{
+  return fe_sqrt(fe_vec3_norm2(a));
+}
+
+static inline fe_vec3_t fe_vec3_normalize(fe_vec3_t a)
+{
+  return fe_vec3_scale(fe_rsqrt(fe_vec3_norm2(a)), a);
+}
+
+static inline fe_vec3_t fe_vec3_cross(fe_vec3_t a, fe_vec3_t b)
+{
+  return fe_vec3(fe_sub(fe_mul(a.y,b.z), fe_mul(a.z,b.y)),
+                 fe_sub(fe_mul(a.z,b.x), fe_mul(a.x,b.z)),
+                 fe_sub(fe_mul(a.x,b.y), fe_mul(a.y,b.x)));
+}
+
+// ab-cd from the exact products: relative error ~3u²
+static inline fe_pair_t fe_vec3_fd2_i(double a, double b, double c, double d)
+{
+  return fe_sub(fe_two_mul(a,b), fe_two_mul(c,d));
+}
+
+static inline fe_vec3_t fe_vec3_cross_d(const double* a, const double* b)
+{
+  return fe_vec3(fe_vec3_fd2_i(a[1],b[2],a[2],b[1]),
+                 fe_vec3_fd2_i(a[2],b[0],a[0],b[2]),
+                 fe_vec3_fd2_i(a[0],b[1],a[1],b[0]));
+}
+
+// r = RN(a×b) per component. 'r' can alias the inputs
+static inline void fe_vec3_cross_f64(double* r, const double* a, const double* b)
+{
+  double x = mms_cr_f64(a[1],b[2],a[2],b[1]);
+  double y = mms_cr_f64(a[2],b[0],a[0],b[2]);
+  double z = mms_cr_f64(a[0],b[1],a[1],b[0]);
+
+  r[0] = x; r[1] = y; r[2] = z;
+}
+
+// r[0..2] = a rounded to double
+static inline void fe_vec3_store_d(double* r, fe_vec3_t a)
+{
+  r[0] = fe_result(a.x); r[1] = fe_result(a.y); r[2] = fe_result(a.z);
+}
+
+static inline fe_mat3_t fe_mat3(fe_vec3_t r0, fe_vec3_t r1, fe_vec3_t r2)
+{
+  return (fe_mat3_t){.r={r0,r1,r2}};
+}
+
+static inline fe_mat3_t fe_mat3_identity(void)
+{
+  return fe_mat3(fe_vec3_d(1,0,0), fe_vec3_d(0,1,0), fe_vec3_d(0,0,1));
+}
+
+// m[0..8] row major
+static inline fe_mat3_t fe_mat3_load_d(const double* m)
+{
+  return fe_mat3(fe_vec3_load_d(m), fe_vec3_load_d(m+3), fe_vec3_load_d(m+6));
+}
+
+static inline fe_mat3_t fe_mat3_transpose(fe_mat3_t m)
+{
+  return fe_mat3(fe_vec3(m.r[0].x, m.r[1].x, m.r[2].x),
+                 fe_vec3(m.r[0].y, m.r[1].y, m.r[2].y),
+                 fe_vec3(m.r[0].z, m.r[1].z, m.r[2].z));
+}
+
+// mv
+static inline fe_vec3_t fe_mat3_mul_vec3(fe_mat3_t m, fe_vec3_t v)
+{
+  return fe_vec3(fe_vec3_dot(m.r[0],v), fe_vec3_dot(m.r[1],v), fe_vec3_dot(m.r[2],v));
+}
+
+// ab
+static inline fe_mat3_t fe_mat3_mul(fe_mat3_t a, fe_mat3_t b)
+{
+  fe_mat3_t t = fe_mat3_transpose(b);
+
+  return fe_mat3(fe_mat3_mul_vec3(t, a.r[0]),
+                 fe_mat3_mul_vec3(t, a.r[1]),
+                 fe_mat3_mul_vec3(t, a.r[2]));
+}
+
+// triple product r0·(r1×r2)
+static inline fe_pair_t fe_mat3_det(fe_mat3_t m)
+{
+  return fe_vec3_dot(m.r[0], fe_vec3_cross(m.r[1], m.r[2]));
+}
+
+// inverse by the adjugate: returns the determinant & the result is
+// meaningless if it's zero (or tiny relative to the entries)
+static inline fe_pair_t fe_mat3_inverse(fe_mat3_t* inv, fe_mat3_t m)
+{
+  fe_vec3_t c0 = fe_vec3_cross(m.r[1], m.r[2]);
+  fe_vec3_t c1 = fe_vec3_cross(m.r[2], m.r[0]);
+  fe_vec3_t c2 = fe_vec3_cross(m.r[0], m.r[1]);
+  fe_pair_t d  = fe_vec3_dot(m.r[0], c0);
+  fe_pair_t s  = fe_inv(d);
+
+  *inv = fe_mat3_transpose(fe_mat3(fe_vec3_scale(s,c0), fe_vec3_scale(s,c1), fe_vec3_scale(s,c2)));
+
+  return d;
+}
+
+// SoA point cloud batch forms: points are (x[i],y[i],z[i]) and results
+// are rounded to double. The arrays can't overlap.
+//
+// r = mp+t (t can be NULL)
+extern void fe_mat3_transform_soa(const fe_mat3_t* m, const fe_vec3_t* t, size_t n,
+                                  const double* x, const double* y, const double* z,
+                                  double* rx, double* ry, double* rz);
+
+// r = p/|p|
+extern void fe_vec3_normalize_soa(size_t n, const double* x, const double* y, const double* z,
+                                  double* rx, double* ry, double* rz);
+
+
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+//**********************************************************
+// expansions [^1]: arrays of nonoverlapping doubles in increasing
+// order of magnitude with zero components eliminated. The value is
+// the exact sum and the sign is that of the last component (the empty
+// expansion is zero). Requires round to nearest even.
+
+static inline int fe_xp_sign_i(const double* e, uint32_t n)
+{
+  return n ? (e[n-1] > 0) - (e[n-1] < 0) : 0;
+}
+
+// exact a-b as an expansion (at most 2 components)
+static inline uint32_t fe_xp_diff_i(double a, double b, double* h)
+{
+  fe_pair_t t = fe_two_diff(a,b);
+  uint32_t  n = 0;
+
+  if (t.lo != 0) h[n++] = t.lo;
+  if (t.hi != 0) h[n++] = t.hi;
+
+  return n;
+}
+
+static inline void fe_xp_neg_i(double* e, uint32_t n)
+{
+  for(uint32_t i=0; i<n; i++) e[i] = -e[i];
+}
+
+// h = e+f (at most en+fn components). 'h' can't alias the inputs.
+// Fast-Expansion-Sum: merge by magnitude and chain `fe_two_sum`.
+static uint32_t fe_xp_sum_i(const double* e, uint32_t en, const double* f, uint32_t fn, double* h)
+{
+  uint32_t i = 0, j = 0, n = 0;
+  double   q;
+
+  if (en+fn == 0) return 0;
+
+  if (j >= fn || (i < en && fabs(e[i]) < fabs(f[j]))) q = e[i++]; else q = f[j++];
+
+  while (i < en || j < fn) {
+    double g;
+
+    if (j >= fn || (i < en && fabs(e[i]) < fabs(f[j]))) g = e[i++]; else g = f[j++];
+
+    fe_pair_t t = fe_two_sum(q,g);
+
+    if (t.lo != 0) h[n++] = t.lo;
+
+    q = t.hi;
+  }
+
+  if (q != 0) h[n++] = q;
+
+  return n;
+}
+
+// h = be (at most 2en components). Scale-Expansion
+static uint32_t fe_xp_scale_i(const double* e, uint32_t en, double b, double* h)
+{
+  uint32_t n = 0;
+
+  if (en == 0 || b == 0) return 0;
+
+  fe_pair_t p = fe_two_mul(e[0],b);
+  double    q = p.hi;
+
+  if (p.lo != 0) h[n++] = p.lo;
+
+  for(uint32_t i=1; i<en; i++) {
+    fe_pair_t t = fe_two_mul(e[i],b);
+    fe_pair_t s = fe_two_sum(q,t.lo);
+
+    if (s.lo != 0) h[n++] = s.lo;
+
+    fe_pair_t u = fe_fast_sum(t.hi,s.hi);
+
+    if (u.lo != 0) h[n++] = u.lo;
+
+    q = u.hi;
+  }
+
+  if (q != 0) h[n++] = q;
+
+  return n;
+}
+
+// h = ef (at most 2en*fn components). 'w' is workspace of 2en(fn+1)
+static uint32_t fe_xp_mul_i(const double* e, uint32_t en, const double* f, uint32_t fn, double* h, double* w)
+{
+  double*  t = w;
+  double*  x = h;
+  double*  y = w + 2*en;
+  uint32_t n = 0;
+
+  for(uint32_t j=0; j<fn; j++) {
+    uint32_t tn = fe_xp_scale_i(e,en,f[j],t);
+
+    n = fe_xp_sum_i(x,n,t,tn,y);
+
+    double* s = x; x = y; y = s;
+  }
+
+  if (x != h) memcpy(h, x, n*sizeof(double));
+
+  return n;
+}
+
+// in place Compress: same value with (usually) fewer components
+static uint32_t fe_xp_compress_i(double* e, uint32_t n)
+{
+  if (n == 0) return 0;
+
+  uint32_t b = n-1;
+  double   q = e[b];
+
+  for(uint32_t i=n-1; i-- > 0;) {
+    fe_pair_t t = fe_fast_sum(q,e[i]);
+
+    if (t.lo != 0) { e[b--] = t.hi; q = t.lo; }
+    else           { q = t.hi; }
+  }
+
+  uint32_t top = 0;
+
+  for(uint32_t i=b+1; i<n; i++) {
+    fe_pair_t t = fe_fast_sum(e[i],q);
+
+    if (t.lo != 0) e[top++] = t.lo;
+
+    q = t.hi;
+  }
+
+  if (q != 0) e[top++] = q;
+
+  return top;
+}
+
+// h = ad-bc (at most 2(an dn + bn cn)). 'w': mul workspace
+static uint32_t fe_xp_det2_i(const double* a, uint32_t an, const double* b, uint32_t bn,
+                             const double* c, uint32_t cn, const double* d, uint32_t dn,
+                             double* h, double* w)
+{
+  double   p[32], q[32];    // the inputs here are at most 4 components
+  uint32_t pn = fe_xp_mul_i(a,an,d,dn,p,w);
+  uint32_t qn = fe_xp_mul_i(b,bn,c,cn,q,w);
+
+  fe_xp_neg_i(q,qn);
+
+  return fe_xp_sum_i(p,pn,q,qn,h);
+}
+
+
+//**********************************************************
+// filter constants & pair stage bounds
+//
+// stage 1: Shewchuk's bounds with ε=2^-53 for the double expressions as
+// written (no contractions).
+//
+// stage 2: the entries are exact (pair differences) and each pair op has
+// a relative error below 5u² (fe_mul: 4u², fe_add: 3u², fe_sq: ~2.4u²).
+// Propagating through the expressions gives at most 8u², 19u², 27u² and
+// 44u² times the permanent. The constants are ~2x (3x for insphere)
+// those to cover the double computed permanent & second order terms.
+
+static const double fe_geom_eps = 0x1.0p-53;
+
+#define FE_GEOM_A(K,J) (((K) + (J)*fe_geom_eps)*fe_geom_eps)
+#define FE_GEOM_B(K)   ((K)*0x1.0p-106)
+
+// exact differences
+static inline fe_vec3_t fe_geom_diff_i(const double* a, const double* b, int dim)
+{
+  fe_vec3_t r;
+
+  r.x = fe_two_diff(a[0],b[0]);
+  r.y = fe_two_diff(a[1],b[1]);
+  r.z = (dim == 3) ? fe_two_diff(a[2],b[2]) : fe_zero();
+
+  return r;
+}
+
+static inline int fe_geom_sign_i(double x) { return (x > 0) - (x < 0); }
+
+static inline fe_pair_t fe_geom_det2_i(fe_pair_t a, fe_pair_t b, fe_pair_t c, fe_pair_t d)
+{
+  return fe_sub(fe_mul(a,d), fe_mul(b,c));
+}
+
+static inline fe_pair_t fe_geom_lift_i(fe_vec3_t d)
+{
+  return fe_add(fe_add(fe_sq(d.x), fe_sq(d.y)), fe_sq(d.z));
+}
+
+// expansions of the exact differences (2 components each)
+typedef struct {
+  double   x[2], y[2], z[2];
+  uint32_t xn, yn, zn;
+} fe_geom_x3_t;
+
+static inline fe_geom_x3_t fe_geom_xdiff_i(const double* a, const double* b, int dim)
+{
+  fe_geom_x3_t r;
+
+  r.xn = fe_xp_diff_i(a[0],b[0],r.x);
+  r.yn = fe_xp_diff_i(a[1],b[1],r.y);
+  r.zn = (dim == 3) ? fe_xp_diff_i(a[2],b[2],r.z) : 0;
+
+  return r;
+}
+
+#define FE_XP_X(P) (P).x,(P).xn
+#define FE_XP_Y(P) (P).y,(P).yn
+#define FE_XP_Z(P) (P).z,(P).zn
+
+// lift = x²+y²+z² (at most 24 components)
+static uint32_t fe_xp_lift_i(const fe_geom_x3_t* d, double* h, double* w)
+{
+  double   s[8], t[8], u[8], v[16];
+  uint32_t sn = fe_xp_mul_i(FE_XP_X(*d),FE_XP_X(*d),s,w);
+  uint32_t tn = fe_xp_mul_i(FE_XP_Y(*d),FE_XP_Y(*d),t,w);
+  uint32_t un = fe_xp_mul_i(FE_XP_Z(*d),FE_XP_Z(*d),u,w);
+  uint32_t vn = fe_xp_sum_i(s,sn,t,tn,v);
+
+  return fe_xp_sum_i(v,vn,u,un,h);
+}
+
+
+//**********************************************************
+// orient2d
+
+static int fe_orient2d_exact_i(const double* a, const double* b, const double* c)
+{
+  fe_geom_x3_t ac = fe_geom_xdiff_i(a,c,2);
+  fe_geom_x3_t bc = fe_geom_xdiff_i(b,c,2);
+  double       h[16], w[16];
+  uint32_t     hn = fe_xp_det2_i(FE_XP_X(ac),FE_XP_Y(ac),FE_XP_X(bc),FE_XP_Y(bc),h,w);
+
+  return fe_xp_sign_i(h,hn);
+}
+
+int fe_orient2d_stage(const double* a, const double* b, const double* c, uint32_t* stage)
+{
+  static const double ka = FE_GEOM_A(3,16);
+  static const double kb = FE_GEOM_B(16);
+
+  double l = (a[0]-c[0])*(b[1]-c[1]);
+  double r = (a[1]-c[1])*(b[0]-c[0]);
+  double d = l-r;
+  uint32_t s = FE_GEOM_FILTER;
+
+  // different signs (or zero): no cancellation so 'd' has the right sign
+  if ((l > 0 && r <= 0) || (l < 0 && r >= 0) || l == 0)
+    goto done;
+
+  double p = fabs(l)+fabs(r);
+
+  if (fabs(d) > ka*p) goto done;
+
+  s = FE_GEOM_PAIR;
+
+  fe_vec3_t ac = fe_geom_diff_i(a,c,2);
+  fe_vec3_t bc = fe_geom_diff_i(b,c,2);
+
+  if (ac.x.lo == 0 && ac.y.lo == 0 && bc.x.lo == 0 && bc.y.lo == 0) {
+    d = mms_cr_f64(ac.x.hi, bc.y.hi, ac.y.hi, bc.x.hi);
+    goto done;
+  }
+
+  d = fe_geom_det2_i(ac.x, ac.y, bc.x, bc.y).hi;
+
+  if (fabs(d) > kb*p) goto done;
+
+  s = FE_GEOM_EXACT;
+
+  if (stage) *stage = s;
+
+  return fe_orient2d_exact_i(a,b,c);
+
+ done:
+  if (stage) *stage = s;
+
+  return fe_geom_sign_i(d);
+}
+
+
+//**********************************************************
+// orient3d
+
+static int fe_orient3d_exact_i(const double* a, const double* b, const double* c, const double* d)
+{
+  fe_geom_x3_t ad = fe_geom_xdiff_i(a,d,3);
+  fe_geom_x3_t bd = fe_geom_xdiff_i(b,d,3);
+  fe_geom_x3_t cd = fe_geom_xdiff_i(c,d,3);
+  double       m[16], t[3][64], u[128], h[192], w[96];
+  uint32_t     mn, tn[3], un, hn;
+
+  // adz(bdx cdy - cdx bdy) + bdz(cdx ady - adx cdy) + cdz(adx bdy - bdx ady)
+  mn    = fe_xp_det2_i(FE_XP_X(bd),FE_XP_X(cd),FE_XP_Y(bd),FE_XP_Y(cd),m,w);
+  tn[0] = fe_xp_mul_i(m,mn,FE_XP_Z(ad),t[0],w);
+  mn    = fe_xp_det2_i(FE_XP_X(cd),FE_XP_X(ad),FE_XP_Y(cd),FE_XP_Y(ad),m,w);
+  tn[1] = fe_xp_mul_i(m,mn,FE_XP_Z(bd),t[1],w);
+  mn    = fe_xp_det2_i(FE_XP_X(ad),FE_XP_X(bd),FE_XP_Y(ad),FE_XP_Y(bd),m,w);
+  tn[2] = fe_xp_mul_i(m,mn,FE_XP_Z(cd),t[2],w);
+
+  un = fe_xp_sum_i(t[0],tn[0],t[1],tn[1],u);
+  hn = fe_xp_sum_i(u,un,t[2],tn[2],h);
+
+  return fe_xp_sign_i(h,hn);
+}
+
+int fe_orient3d_stage(const double* a, const double* b, const double* c, const double* d, uint32_t* stage)
+{
+  static const double ka = FE_GEOM_A(7,56);
+  static const double kb = FE_GEOM_B(32);
+
+  double adx = a[0]-d[0], ady = a[1]-d[1], adz = a[2]-d[2];
+  double bdx = b[0]-d[0], bdy = b[1]-d[1], bdz = b[2]-d[2];
+  double cdx = c[0]-d[0], cdy = c[1]-d[1], cdz = c[2]-d[2];
+
+  double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy;
+  double cdxady = cdx*ady, adxcdy = adx*cdy;
+  double adxbdy = adx*bdy, bdxady = bdx*ady;
+
+  double det = adz*(bdxcdy-cdxbdy) + bdz*(cdxady-adxcdy) + cdz*(adxbdy-bdxady);
+  double p   = (fabs(bdxcdy)+fabs(cdxbdy))*fabs(adz)
+             + (fabs(cdxady)+fabs(adxcdy))*fabs(bdz)
+             + (fabs(adxbdy)+fabs(bdxady))*fabs(cdz);
+
+  uint32_t s = FE_GEOM_FILTER;
+
+  if (fabs(det) > ka*p) goto done;
+
+  s = FE_GEOM_PAIR;
+
+  fe_vec3_t ad = fe_geom_diff_i(a,d,3);
+  fe_vec3_t bd = fe_geom_diff_i(b,d,3);
+  fe_vec3_t cd = fe_geom_diff_i(c,d,3);
+
+  fe_pair_t t0 = fe_mul(ad.z, fe_geom_det2_i(bd.x,cd.x,bd.y,cd.y));
+  fe_pair_t t1 = fe_mul(bd.z, fe_geom_det2_i(cd.x,ad.x,cd.y,ad.y));
+  fe_pair_t t2 = fe_mul(cd.z, fe_geom_det2_i(ad.x,bd.x,ad.y,bd.y));
+
+  det = fe_add(fe_add(t0,t1),t2).hi;
+
+  if (fabs(det) > kb*p) goto done;
+
+  if (stage) *stage = FE_GEOM_EXACT;
+
+  return fe_orient3d_exact_i(a,b,c,d);
+
+ done:
+  if (stage) *stage = s;
+
+  return fe_geom_sign_i(det);
+}
+
+
+//**********************************************************
+// incircle
+
+static int fe_incircle_exact_i(const double* a, const double* b, const double* c, const double* d)
+{
+  fe_geom_x3_t ad = fe_geom_xdiff_i(a,d,2);
+  fe_geom_x3_t bd = fe_geom_xdiff_i(b,d,2);
+  fe_geom_x3_t cd = fe_geom_xdiff_i(c,d,2);
+
+  const fe_geom_x3_t* p[3] = { &ad, &bd, &cd };
+
+  double   l[16], m[16], t[3][512], u[1024], h[1536], w[544];
+  uint32_t ln, mn, tn[3], un, hn;
+
+  // Σ lift(i) det2(i+1,i+2): alift(bdx cdy - cdx bdy) + ...
+  for(int i=0; i<3; i++) {
+    const fe_geom_x3_t* q = p[(i+1)%3];
+    const fe_geom_x3_t* r = p[(i+2)%3];
+
+    ln    = fe_xp_lift_i(p[i],l,w);
+    ln    = fe_xp_compress_i(l,ln);
+    mn    = fe_xp_det2_i(FE_XP_X(*q),FE_XP_X(*r),FE_XP_Y(*q),FE_XP_Y(*r),m,w);
+    mn    = fe_xp_compress_i(m,mn);
+    tn[i] = fe_xp_mul_i(l,ln,m,mn,t[i],w);
+  }
+
+  un = fe_xp_sum_i(t[0],tn[0],t[1],tn[1],u);
+  hn = fe_xp_sum_i(u,un,t[2],tn[2],h);
+
+  return fe_xp_sign_i(h,hn);
+}
+
+int fe_incircle_stage(const double* a, const double* b, const double* c, const double* d, uint32_t* stage)
+{
+  static const double ka = FE_GEOM_A(10,96);
+  static const double kb = FE_GEOM_B(64);
+
+  double adx = a[0]-d[0], ady = a[1]-d[1];
+  double bdx = b[0]-d[0], bdy = b[1]-d[1];
+  double cdx = c[0]-d[0], cdy = c[1]-d[1];
+
+  double bdxcdy = bdx*cdy, cdxbdy = cdx*bdy, alift = adx*adx + ady*ady;
+  double cdxady = cdx*ady, adxcdy = adx*cdy, blift = bdx*bdx + bdy*bdy;
+  double adxbdy = adx*bdy, bdxady = bdx*ady, clift = cdx*cdx + cdy*cdy;
+
+  double det = alift*(bdxcdy-cdxbdy) + blift*(cdxady-adxcdy) + clift*(adxbdy-bdxady);
+  double p   = (fabs(bdxcdy)+fabs(cdxbdy))*alift
+             + (fabs(cdxady)+fabs(adxcdy))*blift
+             + (fabs(adxbdy)+fabs(bdxady))*clift;
+
+  uint32_t s = FE_GEOM_FILTER;
+
+  if (fabs(det) > ka*p) goto done;
+
+  s = FE_GEOM_PAIR;
+
+  fe_vec3_t ad = fe_geom_diff_i(a,d,2);
+  fe_vec3_t bd = fe_geom_diff_i(b,d,2);
+  fe_vec3_t cd = fe_geom_diff_i(c,d,2);
+
+  fe_pair_t t0 = fe_mul(fe_geom_lift_i(ad), fe_geom_det2_i(bd.x,cd.x,bd.y,cd.y));
+  fe_pair_t t1 = fe_mul(fe_geom_lift_i(bd), fe_geom_det2_i(cd.x,ad.x,cd.y,ad.y));
+  fe_pair_t t2 = fe_mul(fe_geom_lift_i(cd), fe_geom_det2_i(ad.x,bd.x,ad.y,bd.y));
+
+  det = fe_add(fe_add(t0,t1),t2).hi;
+
+  if (fabs(det) > kb*p) goto done;
+
+  if (stage) *stage = FE_GEOM_EXACT;
+
+  return fe_incircle_exact_i(a,b,c,d);
+
+ done:
+  if (stage) *stage = s;
+
+  return fe_geom_sign_i(det);
+}
+
+
+//**********************************************************
+// insphere
+//
+// The exact stage compresses the lifts & minors and sizes the products
+// from the actual lengths (the worst case is tens of thousands of
+// components) so it allocates. On allocation failure it returns the
+// sign of the pair estimate.
+
+// 3x3 minor (rows p,q,r) of the differences (at most 192 components)
+static uint32_t fe_xp_det3_i(const fe_geom_x3_t* p, const fe_geom_x3_t* q, const fe_geom_x3_t* r,
+                             double* h, double* w)
+{
+  double   m[16], t[3][64], u[128];
+  uint32_t mn, tn[3], un;
+
+  // pz(qx ry - rx qy) + qz(rx py - px ry) + rz(px qy - qx py)
+  mn    = fe_xp_det2_i(FE_XP_X(*q),FE_XP_X(*r),FE_XP_Y(*q),FE_XP_Y(*r),m,w);
+  tn[0] = fe_xp_mul_i(m,mn,FE_XP_Z(*p),t[0],w);
+  mn    = fe_xp_det2_i(FE_XP_X(*r),FE_XP_X(*p),FE_XP_Y(*r),FE_XP_Y(*p),m,w);
+  tn[1] = fe_xp_mul_i(m,mn,FE_XP_Z(*q),t[1],w);
+  mn    = fe_xp_det2_i(FE_XP_X(*p),FE_XP_X(*q),FE_XP_Y(*p),FE_XP_Y(*q),m,w);
+  tn[2] = fe_xp_mul_i(m,mn,FE_XP_Z(*r),t[2],w);
+
+  un = fe_xp_sum_i(t[0],tn[0],t[1],tn[1],u);
+
+  return fe_xp_sum_i(u,un,t[2],tn[2],h);
+}
+
+static int fe_insphere_exact_i(const double* a, const double* b, const double* c, const double* d,
+                               const double* e, int fallback)
+{
+  fe_geom_x3_t x[4] = {
+    fe_geom_xdiff_i(a,e,3), fe_geom_xdiff_i(b,e,3),
+    fe_geom_xdiff_i(c,e,3), fe_geom_xdiff_i(d,e,3)
+  };
+
+  // det = -alift bcd + blift cda - clift dab + dlift abc where the
+  // minors are the 3x3 determinants of the differences with the rows
+  // in cyclic order: bcd = det3(b,c,d), cda = det3(c,d,a), etc
+  double   l[4][24], m[4][192], w[800];
+  uint32_t ln[4], mn[4];
+  size_t   tot = 0;
+
+  for(int i=0; i<4; i++) {
+    ln[i] = fe_xp_compress_i(l[i], fe_xp_lift_i(x+i, l[i], w));
+    mn[i] = fe_xp_compress_i(m[i], fe_xp_det3_i(x+(i+1)%4, x+(i+2)%4, x+(i+3)%4, m[i], w));
+    tot  += 2*(size_t)ln[i]*mn[i];
+  }
+
+  // products + running sums + mul workspace
+  size_t   wl = 2*(size_t)24*193;
+  double*  buf = malloc((3*tot+wl)*sizeof(double));
+
+  if (buf == NULL) return fallback;
+
+  double*  t  = buf;
+  double*  s0 = t + tot;
+  double*  s1 = s0 + tot;
+  double*  mw = s1 + tot;
+  uint32_t sn = 0;
+
+  // even terms are negative
+  for(int i=0; i<4; i++) {
+    uint32_t tn = fe_xp_mul_i(l[i],ln[i],m[i],mn[i],t,mw);
+
+    if (!(i & 1)) fe_xp_neg_i(t,tn);
+
+    sn = fe_xp_sum_i(s0,sn,t,tn,s1);
+
+    double* q = s0; s0 = s1; s1 = q;
+  }
+
+  int r = fe_xp_sign_i(s0,sn);
+
+  free(buf);
+
+  return r;
+}
+
+int fe_insphere_stage(const double* a, const double* b, const double* c, const double* d,
+                      const double* e, uint32_t* stage)
+{
+  static const double ka = FE_GEOM_A(16,224);
+  static const double kb = FE_GEOM_B(128);
+
+  double aex = a[0]-e[0], aey = a[1]-e[1], aez = a[2]-e[2];
+  double bex = b[0]-e[0], bey = b[1]-e[1], bez = b[2]-e[2];
+  double cex = c[0]-e[0], cey = c[1]-e[1], cez = c[2]-e[2];
+  double dex = d[0]-e[0], dey = d[1]-e[1], dez = d[2]-e[2];
+
+  double aexbey = aex*bey, bexaey = bex*aey;
+  double bexcey = bex*cey, cexbey = cex*bey;
+  double cexdey = cex*dey, dexcey = dex*cey;
+  double dexaey = dex*aey, aexdey = aex*dey;
+  double aexcey = aex*cey, cexaey = cex*aey;
+  double bexdey = bex*dey, dexbey = dex*bey;
+
+  double ab = aexbey-bexaey, bc = bexcey-cexbey, cd = cexdey-dexcey;
+  double da = dexaey-aexdey, ac = aexcey-cexaey, bd = bexdey-dexbey;
+
+  double abc = aez*bc - bez*ac + cez*ab;
+  double bcd = bez*cd - cez*bd + dez*bc;
+  double cda = cez*da + dez*ac + aez*cd;
+  double dab = dez*ab + aez*bd + bez*da;
+
+  double alift = aex*aex + aey*aey + aez*aez;
+  double blift = bex*bex + bey*bey + bez*bez;
+  double clift = cex*cex + cey*cey + cez*cez;
+  double dlift = dex*dex + dey*dey + dez*dez;
+
+  double det = (dlift*abc - clift*dab) + (blift*cda - alift*bcd);
+
+  double pab = fabs(aexbey)+fabs(bexaey), pbc = fabs(bexcey)+fabs(cexbey);
+  double pcd = fabs(cexdey)+fabs(dexcey), pda = fabs(dexaey)+fabs(aexdey);
+  double pac = fabs(aexcey)+fabs(cexaey), pbd = fabs(bexdey)+fabs(dexbey);
+
+  double p = (pcd*fabs(bez) + pbd*fabs(cez) + pbc*fabs(dez))*alift
+           + (pda*fabs(cez) + pac*fabs(dez) + pcd*fabs(aez))*blift
+           + (pab*fabs(dez) + pbd*fabs(aez) + pda*fabs(bez))*clift
+           + (pbc*fabs(aez) + pac*fabs(bez) + pab*fabs(cez))*dlift;
+
+  uint32_t s = FE_GEOM_FILTER;
+
+  if (fabs(det) > ka*p) goto done;
+
+  s = FE_GEOM_PAIR;
+
+  {
+    fe_vec3_t ae = fe_geom_diff_i(a,e,3);
+    fe_vec3_t be = fe_geom_diff_i(b,e,3);
+    fe_vec3_t ce = fe_geom_diff_i(c,e,3);
+    fe_vec3_t de = fe_geom_diff_i(d,e,3);
+
+    fe_pair_t pab2 = fe_geom_det2_i(ae.x,be.x,ae.y,be.y);
+    fe_pair_t pbc2 = fe_geom_det2_i(be.x,ce.x,be.y,ce.y);
+    fe_pair_t pcd2 = fe_geom_det2_i(ce.x,de.x,ce.y,de.y);
+    fe_pair_t pda2 = fe_geom_det2_i(de.x,ae.x,de.y,ae.y);
+    fe_pair_t pac2 = fe_geom_det2_i(ae.x,ce.x,ae.y,ce.y);
+    fe_pair_t pbd2 = fe_geom_det2_i(be.x,de.x,be.y,de.y);
+
+    fe_pair_t pabc = fe_add(fe_sub(fe_mul(ae.z,pbc2), fe_mul(be.z,pac2)), fe_mul(ce.z,pab2));
+    fe_pair_t pbcd = fe_add(fe_sub(fe_mul(be.z,pcd2), fe_mul(ce.z,pbd2)), fe_mul(de.z,pbc2));
+    fe_pair_t pcda = fe_add(fe_add(fe_mul(ce.z,pda2), fe_mul(de.z,pac2)), fe_mul(ae.z,pcd2));
+    fe_pair_t pdab = fe_add(fe_add(fe_mul(de.z,pab2), fe_mul(ae.z,pbd2)), fe_mul(be.z,pda2));
+
+    fe_pair_t u = fe_sub(fe_mul(fe_geom_lift_i(de),pabc), fe_mul(fe_geom_lift_i(ce),pdab));
+    fe_pair_t v = fe_sub(fe_mul(fe_geom_lift_i(be),pcda), fe_mul(fe_geom_lift_i(ae),pbcd));
+
+    det = fe_add(u,v).hi;
+  }
+
+  if (fabs(det) > kb*p) goto done;
+
+  if (stage) *stage = FE_GEOM_EXACT;
+
+  return fe_insphere_exact_i(a,b,c,d,e,fe_geom_sign_i(det));
+
+ done:
+  if (stage) *stage = s;
+
+  return fe_geom_sign_i(det);
+}
+
+
+//**********************************************************
+// batch forms
+
+void fe_orient2d_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats)
+{
+  uint64_t c[FE_GEOM_STAGES] = {0};
+
+  for(size_t i=0; i<n; i++, idx += 3) {
+    uint32_t s;
+    r[i] = (int8_t)fe_orient2d_stage(p+2*idx[0], p+2*idx[1], p+2*idx[2], &s);
+    c[s]++;
+  }
+
+  if (stats) for(int i=0; i<FE_GEOM_STAGES; i++) stats[i] += c[i];
+}
+
+void fe_orient3d_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats)
+{
+  uint64_t c[FE_GEOM_STAGES] = {0};
+
+  for(size_t i=0; i<n; i++, idx += 4) {
+    uint32_t s;
+    r[i] = (int8_t)fe_orient3d_stage(p+3*idx[0], p+3*idx[1], p+3*idx[2], p+3*idx[3], &s);
+    c[s]++;
+  }
+
+  if (stats) for(int i=0; i<FE_GEOM_STAGES; i++) stats[i] += c[i];
+}
+
+void fe_incircle_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats)
+{
+  uint64_t c[FE_GEOM_STAGES] = {0};
+
+  for(size_t i=0; i<n; i++, idx += 4) {
+    uint32_t s;
+    r[i] = (int8_t)fe_incircle_stage(p+2*idx[0], p+2*idx[1], p+2*idx[2], p+2*idx[3], &s);
+    c[s]++;
+  }
+
+  if (stats) for(int i=0; i<FE_GEOM_STAGES; i++) stats[i] += c[i];
+}
+
+void fe_insphere_batch(const double* p, const uint32_t* idx, size_t n, int8_t* r, uint64_t* stats)
+{
+  uint64_t c[FE_GEOM_STAGES] = {0};
+
+  for(size_t i=0; i<n; i++, idx += 5) {
+    uint32_t s;
+    r[i] = (int8_t)fe_insphere_stage(p+3*idx[0], p+3*idx[1], p+3*idx[2], p+3*idx[3], p+3*idx[4], &s);
+    c[s]++;
+  }
+
+  if (stats) for(int i=0; i<FE_GEOM_STAGES; i++) stats[i] += c[i];
+}
+
+
+//**********************************************************
+// vec3/mat3 batch forms
+
+void fe_mat3_transform_soa(const fe_mat3_t* m, const fe_vec3_t* t, size_t n,
+                           const double* restrict x, const double* restrict y, const double* restrict z,
+                           double* restrict rx, double* restrict ry, double* restrict rz)
+{
+  // locals so the loop doesn't reload through the pointers (vectorizes)
+  fe_mat3_t a = *m;
+  fe_vec3_t b = t ? *t : fe_vec3_d(0,0,0);
+
+  for(size_t i=0; i<n; i++) {
+    double px = x[i], py = y[i], pz = z[i];
+
+    fe_pair_t u = fe_add(fe_add(fe_mul_d(a.r[0].x,px), fe_mul_d(a.r[0].y,py)), fe_add(fe_mul_d(a.r[0].z,pz), b.x));
+    fe_pair_t v = fe_add(fe_add(fe_mul_d(a.r[1].x,px), fe_mul_d(a.r[1].y,py)), fe_add(fe_mul_d(a.r[1].z,pz), b.y));
+    fe_pair_t w = fe_add(fe_add(fe_mul_d(a.r[2].x,px), fe_mul_d(a.r[2].y,py)), fe_add(fe_mul_d(a.r[2].z,pz), b.z));
+
+    rx[i] = fe_result(u);
+    ry[i] = fe_result(v);
+    rz[i] = fe_result(w);
+  }
+}
+
+void fe_vec3_normalize_soa(size_t n, const double* restrict x, const double* restrict y, const double* restrict z,
+                           double* restrict rx, double* restrict ry, double* restrict rz)
+{
+  for(size_t i=0; i<n; i++) {
+    double    px = x[i], py = y[i], pz = z[i];
+    fe_pair_t l  = fe_add(fe_add(fe_sq_d(px), fe_sq_d(py)), fe_sq_d(pz));
+    fe_pair_t s  = fe_rsqrt(l);
+
+    rx[i] = fe_result_mul_d(s,px);
+    ry[i] = fe_result_mul_d(s,py);
+    rz[i] = fe_result_mul_d(s,pz);
+  }
+}
+
+#endif
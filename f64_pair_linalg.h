@@ -0,0 +1,1328 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Dense linear algebra built on `f64_pair.h`
+///
+/// * fe_mat_t: SoA pair matrix view (separate `hi` and `lo` arrays, row-major)
+/// * fe_lu_{factor,solve}_f64: LU with partial pivoting in double
+/// * fe_residual_f64: pair precision residual b-Ax for double A
+/// * fe_lu_refine_f64, fe_solve_ir_f64: mixed precision iterative
+///   refinement (double factorization, pair residuals and solution)
+/// * fe_gemm: C += sAB in pair precision. backends: fe_gemm_direct
+///   (vectorized SoA kernel) & fe_gemm_ozaki (error-free splitting into
+///   double GEMMs)
+/// * fe_trsv_{l,u,lt}: triangular solves
+/// * fe_lu_{factor,solve}: blocked LU with partial pivoting in pair precision
+/// * fe_chol_{factor,solve}: blocked Cholesky in pair precision
+/// * fe_qr_{factor,apply_qt,solve}: blocked Householder QR & least squares
+/// * fe_nrm2: overflow safe 2-norm
+/// * `FE_PAIR_PTHREADS`: fe_gemm_mt, fe_{lu,chol,qr}_factor_mt thread the
+///   trailing matrix updates
+/// <br>
+/// Matrices are row-major with an explicit row stride ('ld' in elements).
+/// Pair vectors are passed as two arrays (hi,lo). Factorizations return
+/// 0 on success and k+1 for an exactly zero pivot in column 'k'. Routines
+/// which allocate workspace return negative on allocation failure. The
+/// non-trivial routines are only defined in the translation unit that
+/// defines `FE_PAIR_IMPLEMENTATION`.
+
+#pragma once
+
+#include <limits.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include "f64_pair.h"
+
+// row block size of the residual kernel
+#ifndef FE_LA_RB
+#define FE_LA_RB 4
+#endif
+
+// panel width of the blocked factorizations
+#ifndef FE_LA_NB
+#define FE_LA_NB 32
+#endif
+
+// fe_gemm cache blocking: columns of C and rows of B
+#ifndef FE_GEMM_NB
+#define FE_GEMM_NB 256
+#endif
+
+#ifndef FE_GEMM_KB
+#define FE_GEMM_KB 32
+#endif
+
+// define FE_GEMM_OZAKI for fe_gemm to use the Ozaki scheme backend
+// when all dimensions are at least FE_OZAKI_MIN
+#ifndef FE_OZAKI_MIN
+#define FE_OZAKI_MIN 64
+#endif
+
+#ifndef FE_LA_MAX_THREADS
+#define FE_LA_MAX_THREADS 64
+#endif
+
+
+//**********************************************************
+// SoA pair matrix view
+
+typedef struct {
+  double* hi;
+  double* lo;
+  size_t  m;         // rows
+  size_t  n;         // columns
+  size_t  ld;        // row stride
+} fe_mat_t;
+
+static inline fe_mat_t fe_mat_alloc(size_t m, size_t n)
+{
+  double*  p = calloc(2*m*n+1, sizeof(double));
+  fe_mat_t a = { .hi=p, .lo=p ? p+m*n : NULL, .m=m, .n=n, .ld=n };
+  return a;
+}
+
+static inline void fe_mat_free(fe_mat_t a) { free(a.hi); }
+
+// view of the 'm'x'n' block at (i,j)
+static inline fe_mat_t fe_mat_view(fe_mat_t a, size_t i, size_t j, size_t m, size_t n)
+{
+  size_t   o = i*a.ld+j;
+  fe_mat_t r = { .hi=a.hi+o, .lo=a.lo+o, .m=m, .n=n, .ld=a.ld };
+  return r;
+}
+
+static inline fe_pair_t fe_mat_get(fe_mat_t a, size_t i, size_t j)
+{
+  size_t o = i*a.ld+j;
+  return fe_pair(a.hi[o], a.lo[o]);
+}
+
+static inline void fe_mat_set(fe_mat_t a, size_t i, size_t j, fe_pair_t v)
+{
+  size_t o = i*a.ld+j;
+  a.hi[o] = v.hi;
+  a.lo[o] = v.lo;
+}
+
+// row swap
+static inline void fe_mat_swap_rows(fe_mat_t a, size_t i, size_t k)
+{
+  double* hi = a.hi+i*a.ld, *hk = a.hi+k*a.ld;
+  double* li = a.lo+i*a.ld, *lk = a.lo+k*a.ld;
+
+  for(size_t j=0; j<a.n; j++) {
+    double t;
+    t = hi[j]; hi[j] = hk[j]; hk[j] = t;
+    t = li[j]; li[j] = lk[j]; lk[j] = t;
+  }
+}
+
+
+// overflow/underflow safe 2-norm of the strided pair vector x[0],x[inc],...
+// the elements are scaled by 2^-e (e = exponent of the max |hi|) which
+// is exact (barring underflow of terms far below the max) & then
+// sum of squares with DWTimesDW/AccurateDWPlusDW.
+static inline fe_pair_t fe_nrm2(const double* xh, const double* xl, size_t n, size_t inc)
+{
+  double m = 0;
+
+  for(size_t i=0; i<n; i++) m = fmax(m, fabs(xh[i*inc]));
+
+  if (m == 0 || !isfinite(m)) return fe_set_d(m);
+
+  int e;
+  frexp(m, &e);
+
+  fe_pair_t s = fe_zero();
+
+  for(size_t i=0; i<n; i++) {
+    fe_pair_t v = fe_pair(ldexp(xh[i*inc],-e), ldexp(xl[i*inc],-e));
+    s = fe_add(s, fe_sq(v));
+  }
+
+  s = fe_sqrt(s);
+
+  return fe_pair(ldexp(s.hi,e), ldexp(s.lo,e));
+}
+
+
+//**********************************************************
+// iterative refinement info
+
+typedef struct {
+  uint32_t iterations;   // number of residual/correction steps
+  int      converged;    // correction contracted below double precision
+  double   correction;   // last |d|∞/|x|∞
+} fe_refine_info_t;
+
+// stop when the correction is below this relative to the solution
+#ifndef FE_REFINE_TOL
+#define FE_REFINE_TOL 0x1.0p-104
+#endif
+
+extern int  fe_lu_factor_f64(double* a, size_t lda, size_t n, uint32_t* piv);
+extern void fe_lu_solve_f64(const double* lu, size_t lda, size_t n, const uint32_t* piv, double* x);
+
+extern void fe_residual_f64(const double* a, size_t lda, size_t n,
+                            const double* xh, const double* xl, const double* b,
+                            double* rh, double* rl);
+
+extern int  fe_lu_refine_f64(const double* a, size_t lda, size_t n,
+                             const double* lu, size_t ldlu, const uint32_t* piv,
+                             const double* b, double* xh, double* xl,
+                             uint32_t maxit, fe_refine_info_t* info);
+
+extern int  fe_solve_ir_f64(const double* a, size_t lda, size_t n, const double* b,
+                            double* xh, double* xl, fe_refine_info_t* info);
+
+extern void fe_gemm(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s);
+extern void fe_gemm_direct(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s);
+extern void fe_gemm_ozaki(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s);
+
+extern void fe_trsv_l (fe_mat_t l, int unit, double* xh, double* xl);
+extern void fe_trsv_u (fe_mat_t u, double* xh, double* xl);
+extern void fe_trsv_lt(fe_mat_t l, double* xh, double* xl);
+
+extern int  fe_lu_factor(fe_mat_t a, uint32_t* piv);
+extern void fe_lu_solve(fe_mat_t lu, const uint32_t* piv, double* xh, double* xl);
+
+extern int  fe_chol_factor(fe_mat_t a);
+extern void fe_chol_solve(fe_mat_t l, double* xh, double* xl);
+
+extern int  fe_qr_factor(fe_mat_t a, double* th, double* tl);
+extern void fe_qr_apply_qt(fe_mat_t qr, const double* th, const double* tl, double* bh, double* bl);
+extern void fe_qr_solve(fe_mat_t qr, const double* th, const double* tl, double* bh, double* bl);
+
+#if defined(FE_PAIR_PTHREADS)
+extern void fe_gemm_mt(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s, uint32_t threads);
+extern int  fe_lu_factor_mt(fe_mat_t a, uint32_t* piv, uint32_t threads);
+extern int  fe_chol_factor_mt(fe_mat_t a, uint32_t threads);
+extern int  fe_qr_factor_mt(fe_mat_t a, double* th, double* tl, uint32_t threads);
+#endif
+
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+//**********************************************************
+// double LU (right-looking, partial pivoting)
+
+int fe_lu_factor_f64(double* a, size_t lda, size_t n, uint32_t* piv)
+{
+  int info = 0;
+
+  for(size_t k=0; k<n; k++) {
+    size_t p = k;
+    double m = fabs(a[k*lda+k]);
+
+    for(size_t i=k+1; i<n; i++) {
+      double t = fabs(a[i*lda+k]);
+      if (t > m) { m = t; p = i; }
+    }
+
+    piv[k] = (uint32_t)p;
+
+    if (p != k) {
+      double* rp = a+p*lda;
+      double* rk = a+k*lda;
+      for(size_t j=0; j<n; j++) { double t = rp[j]; rp[j] = rk[j]; rk[j] = t; }
+    }
+
+    double d = a[k*lda+k];
+
+    if (d == 0) { if (!info) info = (int)k+1; continue; }
+
+    const double* rk = a+k*lda;
+
+    for(size_t i=k+1; i<n; i++) {
+      double* ri = a+i*lda;
+      double  l  = ri[k] / d;
+
+      ri[k] = l;
+
+      for(size_t j=k+1; j<n; j++)
+        ri[j] -= l*rk[j];
+    }
+  }
+
+  return info;
+}
+
+void fe_lu_solve_f64(const double* lu, size_t lda, size_t n, const uint32_t* piv, double* x)
+{
+  for(size_t k=0; k<n; k++) {
+    size_t p = piv[k];
+    if (p != k) { double t = x[p]; x[p] = x[k]; x[k] = t; }
+  }
+
+  for(size_t i=1; i<n; i++) {
+    const double* r = lu+i*lda;
+    double        s = x[i];
+    for(size_t j=0; j<i; j++) s -= r[j]*x[j];
+    x[i] = s;
+  }
+
+  for(size_t i=n; i-- > 0;) {
+    const double* r = lu+i*lda;
+    double        s = x[i];
+    for(size_t j=i+1; j<n; j++) s -= r[j]*x[j];
+    x[i] = s/r[i];
+  }
+}
+
+
+//**********************************************************
+// residual: r = b - A(xh+xl)
+//
+// `FE_LA_RB` rows at a time so each column of x is loaded once per
+// block and the rows are independent `fe_add` chains. The products
+// with 'xh' are exact (2Prod) and the products with 'xl' are summed in
+// double (their sum is below u|A||x| so the error is O(nu²|A||x|)).
+
+void fe_residual_f64(const double* a, size_t lda, size_t n,
+                     const double* xh, const double* xl, const double* b,
+                     double* rh, double* rl)
+{
+  size_t i = 0;
+
+  for(; n-i >= FE_LA_RB; i += FE_LA_RB) {
+    fe_pair_t s[FE_LA_RB];
+    double    t[FE_LA_RB];
+
+    for(uint32_t k=0; k<FE_LA_RB; k++) { s[k] = fe_set_d(b[i+k]); t[k] = 0; }
+
+    for(size_t j=0; j<n; j++) {
+      double h = xh[j], l = xl[j];
+
+      for(uint32_t k=0; k<FE_LA_RB; k++) {
+        double v = a[(i+k)*lda+j];
+        s[k] = fe_add(s[k], fe_two_mul(-v,h));
+        t[k] += v*l;
+      }
+    }
+
+    for(uint32_t k=0; k<FE_LA_RB; k++) {
+      fe_pair_t r = fe_sub_d(s[k], t[k]);
+      rh[i+k] = r.hi;
+      rl[i+k] = r.lo;
+    }
+  }
+
+  for(; i<n; i++) {
+    const double* ra = a+i*lda;
+    fe_pair_t     s  = fe_set_d(b[i]);
+    double        t  = 0;
+
+    for(size_t j=0; j<n; j++) {
+      s  = fe_add(s, fe_two_mul(-ra[j],xh[j]));
+      t += ra[j]*xl[j];
+    }
+
+    s = fe_sub_d(s,t);
+    rh[i] = s.hi;
+    rl[i] = s.lo;
+  }
+}
+
+
+//**********************************************************
+// mixed precision iterative refinement
+//
+// Classic three precision scheme (Moler, Wilkinson) with the working
+// precision double, the residual and solution in pair precision: each
+// step solves LU d = RN(r) in double and updates x in pair. Each step
+// gains ~-log2(κu) bits until the pair precision residual limits it.
+// So converges to ~pair accuracy for κ(A) well below 1/u.
+// Stops when |d|∞ <= FE_REFINE_TOL |x|∞, when the correction fails to
+// halve (stagnation: the pair residual noise level is reached) or after
+// 'maxit' steps. Reports converged if the final correction is below
+// double precision of |x|∞ (otherwise κ(A) is too large for the double
+// factorization and the result shouldn't be trusted).
+// On entry (xh,xl) is ignored and on exit holds the solution.
+// Returns the number of steps or negative on allocation failure.
+
+int fe_lu_refine_f64(const double* a, size_t lda, size_t n,
+                     const double* lu, size_t ldlu, const uint32_t* piv,
+                     const double* b, double* xh, double* xl,
+                     uint32_t maxit, fe_refine_info_t* info)
+{
+  double* w = malloc(3*n*sizeof(double)+1);
+
+  if (w == NULL) return -1;
+
+  double*  rh = w;
+  double*  rl = w+n;
+  double*  d  = w+2*n;
+  double   dp = INFINITY;
+  uint32_t it = 0;
+  int      cv = 0;
+  double   dr = 0;
+
+  for(size_t i=0; i<n; i++) { xh[i] = b[i]; xl[i] = 0; }
+
+  fe_lu_solve_f64(lu, ldlu, n, piv, xh);
+
+  while (it < maxit) {
+    it++;
+
+    fe_residual_f64(a, lda, n, xh, xl, b, rh, rl);
+
+    for(size_t i=0; i<n; i++) d[i] = rh[i]+rl[i];
+
+    fe_lu_solve_f64(lu, ldlu, n, piv, d);
+
+    double dn = 0, xn = 0;
+
+    for(size_t i=0; i<n; i++) {
+      fe_pair_t x = fe_add_d(fe_pair(xh[i],xl[i]), d[i]);
+      xh[i] = x.hi;
+      xl[i] = x.lo;
+      dn = fmax(dn, fabs(d[i]));
+      xn = fmax(xn, fabs(x.hi));
+    }
+
+    dr = (xn > 0) ? dn/xn : dn;
+
+    if (dr <= FE_REFINE_TOL) { cv = 1; break; }
+    if (dn >  0.5*dp)        { cv = dr <= 0x1.0p-53; break; }
+
+    dp = dn;
+  }
+
+  free(w);
+
+  if (info) { info->iterations = it; info->converged = cv; info->correction = dr; }
+
+  return (int)it;
+}
+
+// factors a copy of A & refines. Returns the number of steps, -1 on
+// allocation failure and -2 if the double LU has an exactly zero pivot.
+int fe_solve_ir_f64(const double* a, size_t lda, size_t n, const double* b,
+                    double* xh, double* xl, fe_refine_info_t* info)
+{
+  double*   lu  = malloc(n*n*sizeof(double)+1);
+  uint32_t* piv = malloc(n*sizeof(uint32_t)+1);
+  int       r   = -1;
+
+  if (lu && piv) {
+    for(size_t i=0; i<n; i++)
+      memcpy(lu+i*n, a+i*lda, n*sizeof(double));
+
+    int z = fe_lu_factor_f64(lu, n, n, piv);
+
+    r = (z == 0) ? fe_lu_refine_f64(a, lda, n, lu, n, piv, b, xh, xl, 32, info)
+                 : -2;
+  }
+
+  free(lu);
+  free(piv);
+
+  return r;
+}
+
+
+//**********************************************************
+// pair GEMM: C += s A B
+//
+// The inner kernel is an axpy over a row of C (C[i,j] += a B[k,j]) which
+// is elementwise on the SoA arrays so vectorizes (fma/add lanes). The
+// loops are blocked by FE_GEMM_NB columns of C (a row chunk stays in L1)
+// and FE_GEMM_KB rows of B (the panel stays in L2). Each element is
+// accumulated in 'k' order with DWTimesDW3 + AccurateDWPlusDW so the
+// result is independent of the blocking and the thread partition. The
+// scale is applied to each A[i,k] in pair precision (`fe_mul_d`).
+
+static inline void fe_axpy_i(double* restrict ch, double* restrict cl, fe_pair_t a,
+                             const double* restrict bh, const double* restrict bl, size_t n)
+{
+  for(size_t j=0; j<n; j++) {
+    fe_pair_t c = fe_add(fe_pair(ch[j],cl[j]), fe_mul(a, fe_pair(bh[j],bl[j])));
+    ch[j] = c.hi;
+    cl[j] = c.lo;
+  }
+}
+
+void fe_gemm_direct(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s)
+{
+  size_t m = c.m, n = c.n, kn = a.n;
+
+  for(size_t j0=0; j0<n; j0 += FE_GEMM_NB) {
+    size_t nb = (n-j0 < FE_GEMM_NB) ? n-j0 : FE_GEMM_NB;
+
+    for(size_t k0=0; k0<kn; k0 += FE_GEMM_KB) {
+      size_t kb = (kn-k0 < FE_GEMM_KB) ? kn-k0 : FE_GEMM_KB;
+
+      for(size_t i=0; i<m; i++) {
+        double* ch = c.hi + i*c.ld + j0;
+        double* cl = c.lo + i*c.ld + j0;
+
+        for(size_t k=k0; k<k0+kb; k++) {
+          fe_pair_t v = fe_mat_get(a,i,k);
+
+          if (v.hi == 0) continue;
+
+          v = fe_mul_d(v,s);
+
+          fe_axpy_i(ch, cl, v, b.hi + k*b.ld + j0, b.lo + k*b.ld + j0, nb);
+        }
+      }
+    }
+  }
+}
+
+
+//**********************************************************
+// Ozaki scheme GEMM: C += s A B
+//
+// Error-free splitting (Ozaki, Ogita, Oishi, Rump 2012): each row of A
+// (column of B) is split into slices A = A_0 + A_1 + ... where every
+// element of a slice is an integer multiple of 2^(τ+ρ-53) with magnitude
+// at most 2^τ (τ: exponent of the row's max remainder) so has at most
+// β = 53-ρ significant bits. With ρ = ceil((53+log2 K)/2) every dot
+// product of an A slice and a B slice is exact in double so the slice
+// products are plain double GEMMs with no rounding. Products A_p B_q
+// with p+q >= slices are below pair precision and dropped, the rest are
+// summed (smallest first) in pair precision.
+//
+// Each slice carries β bits below the row max so the number of slices
+// is ceil((106 + spread)/β) where spread is the largest exponent range
+// (in bits) between a row's max and its smallest nonzero element. That
+// gives every element ~pair precision (not just relative to |A||B|).
+// Clamped to FE_OZAKI_MAX_SLICES and slicing stops early when the
+// remainders are all zero. Falls back to `fe_gemm_direct` on allocation
+// failure and when the slicing would leave the double range: a row or
+// column max at or above 2^(1024-ρ) (the scale overflows) or slices so
+// small that their products would underflow.
+//
+// The cost is ~ns(ns+1)/2 double GEMMs (15 at K=512 with no spread) plus
+// the splitting. With the internal (portable) double kernel it's more
+// accurate than `fe_gemm_direct` but not faster: the break-even needs a
+// double GEMM ~10x faster than the pair kernel (a tuned BLAS, wide FMA
+// hardware). Replace `fe_dgemm_i` to use one.
+
+#ifndef FE_OZAKI_MAX_SLICES
+#define FE_OZAKI_MAX_SLICES 12
+#endif
+
+// internal double kernel block sizes
+#ifndef FE_DGEMM_NB
+#define FE_DGEMM_NB 128
+#endif
+
+#ifndef FE_DGEMM_KB
+#define FE_DGEMM_KB 128
+#endif
+
+// C = A B in double (overwrites C). cache blocked with a 4x16 register
+// tile micro-kernel. Each B block is packed into NR wide panels ('bp':
+// KB*NB doubles) so the tile loads are unit stride with a fixed step
+// (with runtime strides GCC vectorizes the wrong loop). All the slice
+// products are exact so the fma and the summation order don't change
+// the result.
+#define FE_DGEMM_MR 4
+#define FE_DGEMM_NR 16
+
+static void fe_dgemm_i(double* restrict c, size_t ldc, const double* restrict a, size_t lda,
+                       const double* restrict b, size_t ldb, size_t m, size_t n, size_t kn,
+                       double* restrict bp)
+{
+  for(size_t i=0; i<m; i++)
+    memset(c+i*ldc, 0, n*sizeof(double));
+
+  for(size_t j0=0; j0<n; j0 += FE_DGEMM_NB) {
+    size_t nb = (n-j0 < FE_DGEMM_NB) ? n-j0 : FE_DGEMM_NB;
+    size_t nf = nb & ~(size_t)(FE_DGEMM_NR-1);
+
+    for(size_t k0=0; k0<kn; k0 += FE_DGEMM_KB) {
+      size_t kb = (kn-k0 < FE_DGEMM_KB) ? kn-k0 : FE_DGEMM_KB;
+
+      // pack the full width strips of the B block: kb x NR panels
+      for(size_t j=0; j<nf; j += FE_DGEMM_NR)
+        for(size_t k=0; k<kb; k++)
+          memcpy(bp+j*kb+k*FE_DGEMM_NR, b+(k0+k)*ldb+j0+j, FE_DGEMM_NR*sizeof(double));
+
+      size_t i = 0;
+
+      for(; m-i >= FE_DGEMM_MR; i += FE_DGEMM_MR) {
+        for(size_t j=0; j<nf; j += FE_DGEMM_NR) {
+          const double* restrict p = bp+j*kb;
+          double t[FE_DGEMM_MR][FE_DGEMM_NR];
+
+          for(size_t r=0; r<FE_DGEMM_MR; r++)
+            for(size_t x=0; x<FE_DGEMM_NR; x++)
+              t[r][x] = c[(i+r)*ldc+j0+j+x];
+
+          for(size_t k=0; k<kb; k++, p += FE_DGEMM_NR) {
+            for(size_t r=0; r<FE_DGEMM_MR; r++) {
+              double ar = a[(i+r)*lda+k0+k];
+              for(size_t x=0; x<FE_DGEMM_NR; x++)
+                t[r][x] = fma(ar, p[x], t[r][x]);
+            }
+          }
+
+          for(size_t r=0; r<FE_DGEMM_MR; r++)
+            for(size_t x=0; x<FE_DGEMM_NR; x++)
+              c[(i+r)*ldc+j0+j+x] = t[r][x];
+        }
+      }
+
+      // row & column remainders
+      for(size_t r=0; r<m; r++) {
+        size_t x0 = (r < i) ? j0+nf : j0;
+        for(size_t k=k0; k<k0+kb; k++) {
+          double ar = a[r*lda+k];
+          for(size_t x=x0; x<j0+nb; x++)
+            c[r*ldc+x] = fma(ar, b[k*ldb+x], c[r*ldc+x]);
+        }
+      }
+    }
+  }
+}
+
+// exponent range (bits) between the max |x| and the smallest nonzero
+static inline int fe_ozaki_spread_i(double mx, double mn)
+{
+  if (mx == 0 || mn == INFINITY) return 0;
+
+  int ex, en;
+  frexp(mx,&ex);
+  frexp(mn,&en);
+
+  return ex-en;
+}
+
+// splits (rh,rl) (r x k, stride ld) into slices 'sl' (each r x k, packed)
+// along rows ('rows'=1: per row scale, A) or columns (=0: B). returns
+// the number of nonzero slices generated (at most 'ns').
+static uint32_t fe_ozaki_split_i(double* rh, double* rl, size_t r, size_t k, size_t ld,
+                                 int rows, int rho, uint32_t ns, double* sl, double* sg)
+{
+  size_t   len = rows ? r : k;
+  uint32_t p   = 0;
+
+  for(; p<ns; p++) {
+    double* s  = sl + p*r*k;
+    int     nz = 0;
+
+    // scale per row/column: σ = 0.75 2^(τ+ρ)
+    for(size_t x=0; x<len; x++) sg[x] = 0;
+
+    for(size_t i=0; i<r; i++)
+      for(size_t j=0; j<k; j++) {
+        size_t x = rows ? i : j;
+        sg[x] = fmax(sg[x], fabs(rh[i*ld+j]));
+      }
+
+    for(size_t x=0; x<len; x++) {
+      if (sg[x] != 0) {
+        int e;
+        frexp(sg[x],&e);
+        sg[x] = ldexp(0.75, e+rho);
+        nz = 1;
+      }
+    }
+
+    if (!nz) break;
+
+    for(size_t i=0; i<r; i++) {
+      for(size_t j=0; j<k; j++) {
+        double    g = sg[rows ? i : j];
+        double    h = rh[i*ld+j];
+        double    v = (h+g)-g;
+        fe_pair_t t = fe_two_sum(h-v, rl[i*ld+j]);
+
+        s[i*k+j]   = v;
+        rh[i*ld+j] = t.hi;
+        rl[i*ld+j] = t.lo;
+      }
+    }
+  }
+
+  return p;
+}
+
+void fe_gemm_ozaki(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s)
+{
+  size_t m = c.m, n = c.n, kn = a.n;
+
+  if (m == 0 || n == 0 || kn == 0) return;
+
+  // ρ = ceil((53+log2 K)/2), β = 53-ρ
+  int lk = 0;
+  while (((size_t)1 << lk) < kn) lk++;
+
+  int rho  = (53+lk+1)/2;
+  int beta = 53-rho;
+
+  if (beta < 8) { fe_gemm_direct(c,a,b,s); return; }
+
+  // exponent spreads -> slice counts. and the exponent range of the
+  // row (A) and column (B) maxima for the range check
+  int sa = 0, sb = 0;
+  int a0 = INT_MAX, a1 = INT_MIN, b0 = INT_MAX, b1 = INT_MIN;
+
+  for(size_t i=0; i<m; i++) {
+    double mx = 0, mn = INFINITY;
+    for(size_t k=0; k<kn; k++) {
+      double v = fabs(a.hi[i*a.ld+k]);
+      mx = fmax(mx,v);
+      if (v != 0) mn = fmin(mn,v);
+    }
+    int sp = fe_ozaki_spread_i(mx,mn);
+    sa = sp > sa ? sp : sa;
+
+    if (mx != 0) { int e; frexp(mx,&e); a0 = e < a0 ? e : a0; a1 = e > a1 ? e : a1; }
+  }
+
+  {
+    double* mx = calloc(2*n+1, sizeof(double));
+
+    if (mx == NULL) { fe_gemm_direct(c,a,b,s); return; }
+
+    double* mn = mx+n;
+
+    for(size_t j=0; j<n; j++) mn[j] = INFINITY;
+
+    for(size_t k=0; k<kn; k++)
+      for(size_t j=0; j<n; j++) {
+        double v = fabs(b.hi[k*b.ld+j]);
+        mx[j] = fmax(mx[j],v);
+        if (v != 0) mn[j] = fmin(mn[j],v);
+      }
+
+    for(size_t j=0; j<n; j++) {
+      int sp = fe_ozaki_spread_i(mx[j],mn[j]);
+      sb = sp > sb ? sp : sb;
+
+      if (mx[j] != 0) { int e; frexp(mx[j],&e); b0 = e < b0 ? e : b0; b1 = e > b1 ? e : b1; }
+    }
+
+    free(mx);
+  }
+
+  if (a1 == INT_MIN || b1 == INT_MIN) return;     // A or B is zero
+
+  uint32_t na = (uint32_t)((106+sa+beta-1)/beta);
+  uint32_t nb = (uint32_t)((106+sb+beta-1)/beta);
+
+  if (na > FE_OZAKI_MAX_SLICES) na = FE_OZAKI_MAX_SLICES;
+  if (nb > FE_OZAKI_MAX_SLICES) nb = FE_OZAKI_MAX_SLICES;
+
+  // the scales 0.75·2^(e+ρ) must be finite and the products of the
+  // last slices (lowest bits ~2^(e-nβ)) must not underflow
+  if (a1+rho > 1024 || b1+rho > 1024 || (a0-(int)na*beta)+(b0-(int)nb*beta) < -1074) {
+    fe_gemm_direct(c,a,b,s);
+    return;
+  }
+
+  // workspace: remainders of A & B, slices, scales, double product,
+  // packed B panel & pair sum
+  size_t   ws = 2*m*kn + 2*kn*n + na*m*kn + nb*kn*n + (m > n ? m : n) + m*n
+              + FE_DGEMM_KB*FE_DGEMM_NB;
+  double*  w  = malloc(ws*sizeof(double));
+  fe_mat_t t  = fe_mat_alloc(m,n);
+
+  if (w == NULL || t.hi == NULL) {
+    free(w); fe_mat_free(t);
+    fe_gemm_direct(c,a,b,s);
+    return;
+  }
+
+  double* ah = w;
+  double* al = ah+m*kn;
+  double* bh = al+m*kn;
+  double* bl = bh+kn*n;
+  double* as = bl+kn*n;
+  double* bs = as+na*m*kn;
+  double* sg = bs+nb*kn*n;
+  double* cd = sg+(m > n ? m : n);
+  double* bp = cd+m*n;
+
+  for(size_t i=0; i<m; i++) {
+    memcpy(ah+i*kn, a.hi+i*a.ld, kn*sizeof(double));
+    memcpy(al+i*kn, a.lo+i*a.ld, kn*sizeof(double));
+  }
+
+  for(size_t k=0; k<kn; k++) {
+    memcpy(bh+k*n, b.hi+k*b.ld, n*sizeof(double));
+    memcpy(bl+k*n, b.lo+k*b.ld, n*sizeof(double));
+  }
+
+  na = fe_ozaki_split_i(ah, al, m,  kn, kn, 1, rho, na, as, sg);
+  nb = fe_ozaki_split_i(bh, bl, kn, n,  n,  0, rho, nb, bs, sg);
+
+  uint32_t ns = na > nb ? na : nb;
+
+  // products with p+q < ns, smallest (largest p+q) first
+  for(uint32_t d=ns; d-- > 0;) {
+    for(uint32_t p=0; p<=d; p++) {
+      uint32_t q = d-p;
+
+      if (p >= na || q >= nb) continue;
+
+      fe_dgemm_i(cd, n, as+p*m*kn, kn, bs+q*kn*n, n, m, n, kn, bp);
+
+      for(size_t i=0; i<m*n; i++) {
+        fe_pair_t v = fe_add_d(fe_pair(t.hi[i],t.lo[i]), cd[i]);
+        t.hi[i] = v.hi;
+        t.lo[i] = v.lo;
+      }
+    }
+  }
+
+  for(size_t i=0; i<m; i++) {
+    for(size_t j=0; j<n; j++) {
+      fe_pair_t v = fe_mul_d(fe_pair(t.hi[i*n+j], t.lo[i*n+j]), s);
+      fe_mat_set(c,i,j, fe_add(fe_mat_get(c,i,j), v));
+    }
+  }
+
+  free(w);
+  fe_mat_free(t);
+}
+
+// selects the backend: direct unless FE_GEMM_OZAKI is defined and all
+// dimensions are at least FE_OZAKI_MIN
+void fe_gemm(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s)
+{
+#if defined(FE_GEMM_OZAKI)
+  if (c.m >= FE_OZAKI_MIN && c.n >= FE_OZAKI_MIN && a.n >= FE_OZAKI_MIN) {
+    fe_gemm_ozaki(c,a,b,s);
+    return;
+  }
+#endif
+  fe_gemm_direct(c,a,b,s);
+}
+
+#if defined(FE_PAIR_PTHREADS)
+
+#include <pthread.h>
+
+typedef struct {
+  fe_mat_t c, a, b;
+  double   s;
+} fe_gemm_job_t;
+
+static void* fe_gemm_job(void* data)
+{
+  fe_gemm_job_t* j = (fe_gemm_job_t*)data;
+  fe_gemm(j->c, j->a, j->b, j->s);
+  return NULL;
+}
+
+// splits the rows of C. the calling thread takes the first chunk &
+// a failed thread create runs the chunk directly.
+void fe_gemm_mt(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s, uint32_t threads)
+{
+  fe_gemm_job_t job[FE_LA_MAX_THREADS];
+  pthread_t     tid[FE_LA_MAX_THREADS];
+  int           ok [FE_LA_MAX_THREADS];
+  size_t        m = c.m;
+  uint32_t      t = threads;
+
+  if (t > FE_LA_MAX_THREADS) t = FE_LA_MAX_THREADS;
+  if (t > m/8)               t = (uint32_t)(m/8);   // not worth it for small updates
+
+  if (t <= 1) { fe_gemm(c,a,b,s); return; }
+
+  size_t o = 0;
+
+  for(uint32_t i=0; i<t; i++) {
+    size_t r = (m-o)/(t-i);
+    job[i] = (fe_gemm_job_t){ .c=fe_mat_view(c,o,0,r,c.n), .a=fe_mat_view(a,o,0,r,a.n), .b=b, .s=s };
+    o += r;
+  }
+
+  for(uint32_t i=1; i<t; i++) {
+    ok[i] = pthread_create(tid+i, NULL, fe_gemm_job, job+i) == 0;
+    if (!ok[i]) fe_gemm_job(job+i);
+  }
+
+  fe_gemm_job(job);
+
+  for(uint32_t i=1; i<t; i++)
+    if (ok[i]) pthread_join(tid[i], NULL);
+}
+
+static inline void fe_gemm_t(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s, uint32_t threads)
+{
+  fe_gemm_mt(c,a,b,s,threads);
+}
+
+#else
+
+static inline void fe_gemm_t(fe_mat_t c, fe_mat_t a, fe_mat_t b, double s, uint32_t threads)
+{
+  (void)threads;
+  fe_gemm(c,a,b,s);
+}
+
+#endif
+
+
+//**********************************************************
+// triangular solves (vector right hand side, in-place on x)
+
+// L x = b : lower triangle of 'l', unit diagonal if 'unit'
+void fe_trsv_l(fe_mat_t l, int unit, double* xh, double* xl)
+{
+  for(size_t i=0; i<l.n; i++) {
+    fe_pair_t s = fe_pair(xh[i],xl[i]);
+
+    for(size_t j=0; j<i; j++)
+      s = fe_sub(s, fe_mul(fe_mat_get(l,i,j), fe_pair(xh[j],xl[j])));
+
+    if (!unit) s = fe_div(s, fe_mat_get(l,i,i));
+
+    xh[i] = s.hi; xl[i] = s.lo;
+  }
+}
+
+// U x = b : upper triangle of 'u'
+void fe_trsv_u(fe_mat_t u, double* xh, double* xl)
+{
+  for(size_t i=u.n; i-- > 0;) {
+    fe_pair_t s = fe_pair(xh[i],xl[i]);
+
+    for(size_t j=i+1; j<u.n; j++)
+      s = fe_sub(s, fe_mul(fe_mat_get(u,i,j), fe_pair(xh[j],xl[j])));
+
+    s = fe_div(s, fe_mat_get(u,i,i));
+
+    xh[i] = s.hi; xl[i] = s.lo;
+  }
+}
+
+// Lᵀ x = b : lower triangle of 'l'. column oriented so 'l' is accessed
+// by rows.
+void fe_trsv_lt(fe_mat_t l, double* xh, double* xl)
+{
+  for(size_t i=l.n; i-- > 0;) {
+    fe_pair_t x = fe_div(fe_pair(xh[i],xl[i]), fe_mat_get(l,i,i));
+
+    xh[i] = x.hi; xl[i] = x.lo;
+
+    for(size_t j=0; j<i; j++) {
+      fe_pair_t t = fe_sub(fe_pair(xh[j],xl[j]), fe_mul(fe_mat_get(l,i,j), x));
+      xh[j] = t.hi; xl[j] = t.lo;
+    }
+  }
+}
+
+
+//**********************************************************
+// blocked pair LU (right-looking, partial pivoting on |hi|)
+//
+// For each panel of FE_LA_NB columns:
+//   1) unblocked LU of the panel (rows swaps are applied to full rows)
+//   2) U12 = L11^-1 A12 (row operations)
+//   3) A22 -= L21 U12 (fe_gemm: the O(n³) part)
+
+static int fe_lu_panel_i(fe_mat_t a, size_t k0, size_t kb, uint32_t* piv)
+{
+  size_t n    = a.n;
+  int    info = 0;
+
+  for(size_t k=k0; k<k0+kb; k++) {
+    size_t p = k;
+    double m = fabs(a.hi[k*a.ld+k]);
+
+    for(size_t i=k+1; i<n; i++) {
+      double t = fabs(a.hi[i*a.ld+k]);
+      if (t > m) { m = t; p = i; }
+    }
+
+    piv[k] = (uint32_t)p;
+
+    if (p != k) fe_mat_swap_rows(a,p,k);
+
+    fe_pair_t d = fe_mat_get(a,k,k);
+
+    if (d.hi == 0) { if (!info) info = (int)k+1; continue; }
+
+    fe_pair_t di = fe_inv(d);
+    size_t    w  = k0+kb-(k+1);
+
+    for(size_t i=k+1; i<n; i++) {
+      fe_pair_t l = fe_mul(fe_mat_get(a,i,k), di);
+
+      fe_mat_set(a,i,k,l);
+
+      fe_axpy_i(a.hi+i*a.ld+k+1, a.lo+i*a.ld+k+1, fe_neg(l),
+                a.hi+k*a.ld+k+1, a.lo+k*a.ld+k+1, w);
+    }
+  }
+
+  return info;
+}
+
+static int fe_lu_factor_i(fe_mat_t a, uint32_t* piv, uint32_t threads)
+{
+  size_t n    = a.n;
+  int    info = 0;
+
+  for(size_t k0=0; k0<n; k0 += FE_LA_NB) {
+    size_t kb = (n-k0 < FE_LA_NB) ? n-k0 : FE_LA_NB;
+    size_t k1 = k0+kb;
+    int    r  = fe_lu_panel_i(a, k0, kb, piv);
+
+    if (r && !info) info = r;
+    if (k1 == n) break;
+
+    // U12 = L11^-1 A12
+    for(size_t i=k0+1; i<k1; i++)
+      for(size_t j=k0; j<i; j++)
+        fe_axpy_i(a.hi+i*a.ld+k1, a.lo+i*a.ld+k1, fe_neg(fe_mat_get(a,i,j)),
+                  a.hi+j*a.ld+k1, a.lo+j*a.ld+k1, n-k1);
+
+    // A22 -= L21 U12
+    fe_gemm_t(fe_mat_view(a, k1, k1, n-k1, n-k1),
+              fe_mat_view(a, k1, k0, n-k1, kb),
+              fe_mat_view(a, k0, k1, kb,   n-k1), -1.0, threads);
+  }
+
+  return info;
+}
+
+int fe_lu_factor(fe_mat_t a, uint32_t* piv)
+{
+  return fe_lu_factor_i(a, piv, 1);
+}
+
+void fe_lu_solve(fe_mat_t lu, const uint32_t* piv, double* xh, double* xl)
+{
+  size_t n = lu.n;
+
+  for(size_t k=0; k<n; k++) {
+    size_t p = piv[k];
+    if (p != k) {
+      double t;
+      t = xh[p]; xh[p] = xh[k]; xh[k] = t;
+      t = xl[p]; xl[p] = xl[k]; xl[k] = t;
+    }
+  }
+
+  fe_trsv_l(lu, 1, xh, xl);
+  fe_trsv_u(lu, xh, xl);
+}
+
+
+//**********************************************************
+// blocked pair Cholesky: A = L Lᵀ (lower triangle referenced/overwritten)
+//
+// For each panel of FE_LA_NB columns:
+//   1) unblocked Cholesky of the diagonal block
+//   2) L21 = A21 L11^-ᵀ (on a transposed copy)
+//   3) A22 -= L21 L21ᵀ with fe_gemm against a transposed copy of L21,
+//      only the lower triangle is updated (the diagonal blocks by row).
+// Returns k+1 if the leading minor of order k+1 isn't positive and
+// negative on allocation failure. The strict upper triangle is untouched.
+
+static int fe_chol_factor_i(fe_mat_t a, uint32_t threads)
+{
+  size_t   n = a.n;
+  fe_mat_t t = fe_mat_alloc(FE_LA_NB, n ? n : 1);
+
+  if (t.hi == NULL) return -1;
+
+  int info = 0;
+
+  for(size_t k0=0; k0<n && !info; k0 += FE_LA_NB) {
+    size_t kb = (n-k0 < FE_LA_NB) ? n-k0 : FE_LA_NB;
+    size_t k1 = k0+kb;
+
+    // diagonal block
+    for(size_t k=k0; k<k1; k++) {
+      fe_pair_t d = fe_mat_get(a,k,k);
+
+      for(size_t j=k0; j<k; j++)
+        d = fe_sub(d, fe_sq(fe_mat_get(a,k,j)));
+
+      if (!(d.hi > 0)) { info = (int)k+1; break; }
+
+      d = fe_sqrt(d);
+      fe_mat_set(a,k,k,d);
+
+      for(size_t i=k+1; i<k1; i++) {
+        fe_pair_t s = fe_mat_get(a,i,k);
+
+        for(size_t j=k0; j<k; j++)
+          s = fe_sub(s, fe_mul(fe_mat_get(a,i,j), fe_mat_get(a,k,j)));
+
+        fe_mat_set(a,i,k, fe_div(s,d));
+      }
+    }
+
+    if (info || k1 == n) break;
+
+    // L21 = A21 L11^-ᵀ. solved as L11 L21ᵀ = A21ᵀ on the transposed copy
+    // in 't' so the updates are row axpys. then copied back.
+    size_t w = n-k1;
+
+    for(size_t i=k1; i<n; i++)
+      for(size_t k=k0; k<k1; k++)
+        fe_mat_set(t, k-k0, i-k1, fe_mat_get(a,i,k));
+
+    for(size_t k=k0; k<k1; k++) {
+      double* th = t.hi+(k-k0)*t.ld;
+      double* tl = t.lo+(k-k0)*t.ld;
+
+      for(size_t j=k0; j<k; j++)
+        fe_axpy_i(th, tl, fe_neg(fe_mat_get(a,k,j)), t.hi+(j-k0)*t.ld, t.lo+(j-k0)*t.ld, w);
+
+      fe_pair_t d = fe_mat_get(a,k,k);
+
+      for(size_t i=0; i<w; i++) {
+        fe_pair_t v = fe_div(fe_pair(th[i],tl[i]), d);
+        th[i] = v.hi;
+        tl[i] = v.lo;
+      }
+    }
+
+    for(size_t i=k1; i<n; i++)
+      for(size_t k=k0; k<k1; k++)
+        fe_mat_set(a, i, k, fe_mat_get(t, k-k0, i-k1));
+
+    // A22 -= L21 L21ᵀ (block rows): the blocks left of the diagonal
+    // then the lower triangle of the diagonal block one row at a time
+    for(size_t i0=k1; i0<n; i0 += FE_LA_NB) {
+      size_t ib = (n-i0 < FE_LA_NB) ? n-i0 : FE_LA_NB;
+
+      if (i0 > k1)
+        fe_gemm_t(fe_mat_view(a, i0, k1, ib, i0-k1),
+                  fe_mat_view(a, i0, k0, ib, kb),
+                  fe_mat_view(t, 0,  0,  kb, i0-k1), -1.0, threads);
+
+      for(size_t j=0; j<ib; j++)
+        fe_gemm(fe_mat_view(a, i0+j, i0,    1,  j+1),
+                fe_mat_view(a, i0+j, k0,    1,  kb),
+                fe_mat_view(t, 0,    i0-k1, kb, j+1), -1.0);
+    }
+  }
+
+  fe_mat_free(t);
+
+  return info;
+}
+
+int fe_chol_factor(fe_mat_t a)
+{
+  return fe_chol_factor_i(a, 1);
+}
+
+void fe_chol_solve(fe_mat_t l, double* xh, double* xl)
+{
+  fe_trsv_l (l, 0, xh, xl);
+  fe_trsv_lt(l, xh, xl);
+}
+
+//**********************************************************
+// blocked Householder QR (m >= n)
+//
+// On exit the upper triangle of A is R and below the diagonal are the
+// Householder vectors 'v' (v_k = 1 implied) with H_k = I - τ_k v vᵀ and
+// Q = H_0 H_1 ... (LAPACK dgeqrf layout). For each panel of FE_LA_NB
+// columns:
+//   1) unblocked QR of the panel (vectors from fe_nrm2, row axpys)
+//   2) compact WY: Q_panel = I - V T Vᵀ with T upper triangular from
+//      G = VᵀV (fe_gemm)
+//   3) A2 = Q_panelᵀ A2 = A2 - V (Tᵀ (Vᵀ A2)) : two fe_gemm calls
+// Returns 0 or negative on allocation failure.
+
+// Householder vector for column 'k' of 'a' (rows k..m). returns τ
+static fe_pair_t fe_householder_i(fe_mat_t a, size_t k)
+{
+  size_t    m     = a.m;
+  fe_pair_t alpha = fe_mat_get(a,k,k);
+  fe_pair_t tn    = fe_nrm2(a.hi+(k+1)*a.ld+k, a.lo+(k+1)*a.ld+k, m-k-1, a.ld);
+
+  if (tn.hi == 0) return fe_zero();
+
+  fe_pair_t nrm  = fe_nrm2(a.hi+k*a.ld+k, a.lo+k*a.ld+k, m-k, a.ld);
+  fe_pair_t beta = (alpha.hi >= 0) ? fe_neg(nrm) : nrm;
+  fe_pair_t tau  = fe_div(fe_sub(beta,alpha), beta);
+  fe_pair_t sc   = fe_inv(fe_sub(alpha,beta));
+
+  for(size_t i=k+1; i<m; i++)
+    fe_mat_set(a,i,k, fe_mul(fe_mat_get(a,i,k), sc));
+
+  fe_mat_set(a,k,k,beta);
+
+  return tau;
+}
+
+// apply H_k (vector in column k) to columns [j0,j1) of rows k..m of 'a'
+// w = vᵀA & A -= τ v w. 'wh','wl' is workspace of j1-j0
+static void fe_householder_apply_i(fe_mat_t a, size_t k, fe_pair_t tau, size_t j0, size_t j1,
+                                   double* wh, double* wl)
+{
+  size_t w = j1-j0;
+
+  if (tau.hi == 0 || w == 0) return;
+
+  for(size_t j=0; j<w; j++) { wh[j] = a.hi[k*a.ld+j0+j]; wl[j] = a.lo[k*a.ld+j0+j]; }
+
+  for(size_t i=k+1; i<a.m; i++)
+    fe_axpy_i(wh, wl, fe_mat_get(a,i,k), a.hi+i*a.ld+j0, a.lo+i*a.ld+j0, w);
+
+  fe_pair_t nt = fe_neg(tau);
+
+  fe_axpy_i(a.hi+k*a.ld+j0, a.lo+k*a.ld+j0, nt, wh, wl, w);
+
+  for(size_t i=k+1; i<a.m; i++)
+    fe_axpy_i(a.hi+i*a.ld+j0, a.lo+i*a.ld+j0, fe_mul(nt, fe_mat_get(a,i,k)), wh, wl, w);
+}
+
+static int fe_qr_factor_i(fe_mat_t a, double* th, double* tl, uint32_t threads)
+{
+  size_t m  = a.m;
+  size_t n  = a.n;
+  size_t nb = FE_LA_NB;
+
+  // workspace: V (m x nb), Vᵀ (nb x m), G & T (nb x nb), W & W2 (nb x n)
+  fe_mat_t v  = fe_mat_alloc(m,  nb);
+  fe_mat_t vt = fe_mat_alloc(nb, m);
+  fe_mat_t g  = fe_mat_alloc(nb, nb);
+  fe_mat_t t  = fe_mat_alloc(nb, nb);
+  fe_mat_t w  = fe_mat_alloc(nb, n);
+  fe_mat_t w2 = fe_mat_alloc(nb, n);
+  int      r  = 0;
+
+  if (!v.hi || !vt.hi || !g.hi || !t.hi || !w.hi || !w2.hi) { r = -1; goto done; }
+
+  for(size_t k0=0; k0<n; k0 += nb) {
+    size_t kb = (n-k0 < nb) ? n-k0 : nb;
+    size_t k1 = k0+kb;
+    size_t mr = m-k0;
+
+    // panel
+    for(size_t k=k0; k<k1; k++) {
+      fe_pair_t tau = fe_householder_i(a,k);
+      th[k] = tau.hi;
+      tl[k] = tau.lo;
+      fe_householder_apply_i(a, k, tau, k+1, k1, w.hi, w.lo);
+    }
+
+    if (k1 == n) break;
+
+    // explicit V (unit lower trapezoid) and Vᵀ
+    fe_mat_t vp  = fe_mat_view(v,  0, 0, mr, kb);
+    fe_mat_t vtp = fe_mat_view(vt, 0, 0, kb, mr);
+
+    for(size_t i=0; i<mr; i++) {
+      for(size_t j=0; j<kb; j++) {
+        fe_pair_t e = (i >  j) ? fe_mat_get(a, k0+i, k0+j)
+                    : (i == j) ? fe_one() : fe_zero();
+        fe_mat_set(vp,  i, j, e);
+        fe_mat_set(vtp, j, i, e);
+      }
+    }
+
+    // G = VᵀV & T: T[i][i] = τ_i, T[0:i,i] = -τ_i T[0:i,0:i] G[0:i,i]
+    fe_mat_t gp = fe_mat_view(g, 0, 0, kb, kb);
+    fe_mat_t tp = fe_mat_view(t, 0, 0, kb, kb);
+
+    memset(g.hi, 0, 2*nb*nb*sizeof(double));
+    memset(t.hi, 0, 2*nb*nb*sizeof(double));
+
+    fe_gemm(gp, vtp, vp, 1.0);
+
+    for(size_t i=0; i<kb; i++) {
+      fe_pair_t ti = fe_pair(th[k0+i], tl[k0+i]);
+
+      fe_mat_set(tp, i, i, ti);
+
+      for(size_t r0=0; r0<i; r0++) {
+        fe_pair_t s = fe_zero();
+        for(size_t c=r0; c<i; c++)
+          s = fe_add(s, fe_mul(fe_mat_get(tp,r0,c), fe_mat_get(gp,c,i)));
+        fe_mat_set(tp, r0, i, fe_neg(fe_mul(ti,s)));
+      }
+    }
+
+    // W = Vᵀ A2, W2 = Tᵀ W, A2 -= V W2
+    size_t   n2  = n-k1;
+    fe_mat_t a2  = fe_mat_view(a,  k0, k1, mr, n2);
+    fe_mat_t wp  = fe_mat_view(w,  0,  0,  kb, n2);
+    fe_mat_t w2p = fe_mat_view(w2, 0,  0,  kb, n2);
+
+    memset(w.hi,  0, 2*nb*n*sizeof(double));
+    memset(w2.hi, 0, 2*nb*n*sizeof(double));
+
+    fe_gemm_t(wp, vtp, a2, 1.0, threads);
+
+    for(size_t i=0; i<kb; i++)
+      for(size_t c=0; c<=i; c++)
+        fe_axpy_i(w2p.hi+i*w2p.ld, w2p.lo+i*w2p.ld, fe_mat_get(tp,c,i),
+                  wp.hi+c*wp.ld, wp.lo+c*wp.ld, n2);
+
+    fe_gemm_t(a2, vp, w2p, -1.0, threads);
+  }
+
+ done:
+  fe_mat_free(v);  fe_mat_free(vt);
+  fe_mat_free(g);  fe_mat_free(t);
+  fe_mat_free(w);  fe_mat_free(w2);
+
+  return r;
+}
+
+int fe_qr_factor(fe_mat_t a, double* th, double* tl)
+{
+  return fe_qr_factor_i(a, th, tl, 1);
+}
+
+// b = Qᵀb (b has 'm' elements)
+void fe_qr_apply_qt(fe_mat_t qr, const double* th, const double* tl, double* bh, double* bl)
+{
+  for(size_t k=0; k<qr.n; k++) {
+    fe_pair_t tau = fe_pair(th[k],tl[k]);
+
+    if (tau.hi == 0) continue;
+
+    fe_pair_t s = fe_pair(bh[k],bl[k]);
+
+    for(size_t i=k+1; i<qr.m; i++)
+      s = fe_add(s, fe_mul(fe_mat_get(qr,i,k), fe_pair(bh[i],bl[i])));
+
+    s = fe_mul(s,tau);
+
+    fe_pair_t b = fe_sub(fe_pair(bh[k],bl[k]), s);
+    bh[k] = b.hi; bl[k] = b.lo;
+
+    for(size_t i=k+1; i<qr.m; i++) {
+      b = fe_sub(fe_pair(bh[i],bl[i]), fe_mul(fe_mat_get(qr,i,k), s));
+      bh[i] = b.hi; bl[i] = b.lo;
+    }
+  }
+}
+
+// least squares min |Ax-b|: on exit the first 'n' elements of b are 'x'
+// and the remaining m-n are the residual components of Qᵀb.
+void fe_qr_solve(fe_mat_t qr, const double* th, const double* tl, double* bh, double* bl)
+{
+  fe_qr_apply_qt(qr, th, tl, bh, bl);
+  fe_trsv_u(fe_mat_view(qr, 0, 0, qr.n, qr.n), bh, bl);
+}
+
+#if defined(FE_PAIR_PTHREADS)
+
+int fe_lu_factor_mt(fe_mat_t a, uint32_t* piv, uint32_t threads)
+{
+  return fe_lu_factor_i(a, piv, threads);
+}
+
+int fe_chol_factor_mt(fe_mat_t a, uint32_t threads)
+{
+  return fe_chol_factor_i(a, threads);
+}
+
+int fe_qr_factor_mt(fe_mat_t a, double* th, double* tl, uint32_t threads)
+{
+  return fe_qr_factor_i(a, th, tl, threads);
+}
+
+#endif
+
+#endif
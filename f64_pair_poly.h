@@ -0,0 +1,515 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Quadratic and cubic equations built on `f64_pair.h`
+///
+/// * fe_quadratic_f64: real coefficient quadratic in double using
+///   Kahan's method [^1] with a correctly rounded discriminant
+///   (`mms_cr_f64`) so the number of real roots is exact.
+/// * fe_quadratic: same but the discriminant is computed as a pair from
+///   the exact products and the roots are finished with `fe_sqrt` and
+///   pair divisions.
+/// * fe_cubic_f64, fe_cubic: Kahan's QBC [^2]: one real root by Newton
+///   from a start that (in exact arithmetic) converges monotonically and
+///   the other two from the deflated quadratic. The Newton steps are
+///   kept inside a sign change bracket with bisection as the fallback
+///   since rounding can break the start's guarantee for clustered roots.
+///   The pair version evaluates those residuals in pair (the root is
+///   then within ~an ulp), refines it by Newton in pair arithmetic and
+///   deflates in pair.
+///   The number of real roots is exact for both: it's the sign of the
+///   discriminant which is computed exactly (error-free products and
+///   an expansion sum) when the double evaluation can't decide it.
+/// * fe_*_polish: one Newton step in pair arithmetic
+/// * fe_*_batch: arrays of coefficient tuples
+/// <br>
+/// Return values are the number of real roots. Real roots are in
+/// increasing order. If a pair of roots are complex then their real and
+/// (positive) imaginary parts follow the real roots. Specifically:
+/// * quadratic: 2 = two real roots, 0 = r[0] ± i·r[1]
+/// * cubic:     3 = three real roots, 1 = r[0] and r[1] ± i·r[2]
+/// <br>
+/// The leading coefficient being zero falls back to the lower degree
+/// equation (a linear equation with b=0 returns 0 and NaNs). There's no
+/// scaling so the products of coefficients must not overflow or
+/// underflow. The non-trivial routines are only defined in the
+/// translation unit that defines `FE_PAIR_IMPLEMENTATION`.
+///
+/// [^1]: "On the Cost of Floating-Point Computation Without
+///        Extra-Precise Arithmetic", Kahan, 2004
+/// [^2]: "To Solve a Real Cubic Equation", Kahan, 1986 (lecture notes)
+
+#pragma once
+
+#include <stddef.h>
+#include "f64_pair.h"
+
+// batch mode flags. 0 = double only (FE_POLY_F64)
+enum {
+  FE_POLY_F64    = 0,
+  FE_POLY_PAIR   = 1,     // pair discriminant, sqrt & deflation
+  FE_POLY_POLISH = 2      // one pair Newton step per real root
+};
+
+extern int fe_quadratic_f64(double a, double b, double c, double* r);
+extern int fe_quadratic(double a, double b, double c, fe_pair_t* r);
+extern int fe_cubic_f64(double a, double b, double c, double d, double* r);
+extern int fe_cubic(double a, double b, double c, double d, fe_pair_t* r);
+
+// coef: (a,b,c) triples (quadratic) or (a,b,c,d) quads (cubic). roots
+// are rounded to double in r[2i..2i+1] (r[3i..3i+2]) and the return
+// values in k[i]. mode: FE_POLY_* flags
+extern void fe_quadratic_batch(const double* coef, size_t n, double* r, int8_t* k, uint32_t mode);
+extern void fe_cubic_batch(const double* coef, size_t n, double* r, int8_t* k, uint32_t mode);
+
+// one Newton step for a root of ax²+bx+c with the evaluation in pair
+static inline fe_pair_t fe_quadratic_polish(double a, double b, double c, fe_pair_t x)
+{
+  fe_pair_t p  = fe_add_d(fe_mul(fe_add_d(fe_mul_d(x,a),b),x),c);
+  fe_pair_t dp = fe_add_d(fe_mul_d(x,2.0*a),b);
+
+  return (dp.hi != 0) ? fe_sub(x, fe_div(p,dp)) : x;
+}
+
+// one Newton step for a root of ax³+bx²+cx+d with the evaluation in pair
+static inline fe_pair_t fe_cubic_polish(double a, double b, double c, double d, fe_pair_t x)
+{
+  fe_pair_t t  = fe_add_d(fe_mul_d(x,a),b);
+  fe_pair_t p  = fe_add_d(fe_mul(fe_add_d(fe_mul(t,x),c),x),d);
+  fe_pair_t dp = fe_add_d(fe_mul(fe_add_d(fe_mul_d(x,3.0*a),2.0*b),x),c);
+
+  return (dp.hi != 0) ? fe_sub(x, fe_div(p,dp)) : x;
+}
+
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+static inline int fe_poly_lt_i(fe_pair_t x, fe_pair_t y)
+{
+  return (x.hi < y.hi) || (x.hi == y.hi && x.lo < y.lo);
+}
+
+static inline void fe_poly_sort2_i(fe_pair_t* r)
+{
+  if (fe_poly_lt_i(r[1],r[0])) { fe_pair_t t = r[0]; r[0] = r[1]; r[1] = t; }
+}
+
+static inline void fe_poly_sort3_i(fe_pair_t* r)
+{
+  fe_poly_sort2_i(r);
+  fe_poly_sort2_i(r+1);
+  fe_poly_sort2_i(r);
+}
+
+static inline void fe_poly_sort2_f64_i(double* r)
+{
+  if (r[1] < r[0]) { double t = r[0]; r[0] = r[1]; r[1] = t; }
+}
+
+static inline void fe_poly_sort3_f64_i(double* r)
+{
+  fe_poly_sort2_f64_i(r);
+  fe_poly_sort2_f64_i(r+1);
+  fe_poly_sort2_f64_i(r);
+}
+
+
+//**********************************************************
+// quadratic
+
+// k: number of real roots (2 or 0) if known (the cubic) or -1 to use the
+// sign of the discriminant
+static int fe_quadratic_f64_i(double a, double b, double c, double* r, int k)
+{
+  if (a == 0) {
+    r[0] = -c/b;
+    r[1] = (double)NAN;
+
+    if (b != 0) return 1;
+
+    r[0] = (double)NAN;
+    return 0;
+  }
+
+  // correctly rounded b²-4ac (4a is exact): has the exact sign
+  double d = mms_cr_f64(b,b,4.0*a,c);
+
+  if (k < 0) k = (d < 0) ? 0 : 2;
+
+  d = fabs(d);
+
+  if (k == 0) {
+    r[0] = (-0.5*b)/a;
+    r[1] = fabs((0.5*sqrt(d))/a);
+    return 0;
+  }
+
+  // no cancellation: q = -(b + sign(b)√d)/2
+  double q = -0.5*(b + copysign(sqrt(d),b));
+
+  if (q == 0) {                     // b=0 & d=0 -> c=0
+    r[0] = r[1] = 0;
+    return 2;
+  }
+
+  r[0] = q/a;
+  r[1] = c/q;
+
+  fe_poly_sort2_f64_i(r);
+
+  return 2;
+}
+
+int fe_quadratic_f64(double a, double b, double c, double* r)
+{
+  return fe_quadratic_f64_i(a,b,c,r,-1);
+}
+
+// pair coefficients (the deflated cubic). 'k' as fe_quadratic_f64_i
+static int fe_quadratic_pp_i(fe_pair_t a, fe_pair_t b, fe_pair_t c, fe_pair_t* r, int k)
+{
+  if (a.hi == 0) {
+    r[1] = fe_set_d((double)NAN);
+
+    if (b.hi != 0) {
+      r[0] = fe_neg(fe_div(c,b));
+      return 1;
+    }
+
+    r[0] = r[1];
+    return 0;
+  }
+
+  fe_pair_t d = fe_sub(fe_sq(b), fe_mul(fe_mul_pot(4.0,a),c));
+
+  if (k < 0) k = (d.hi < 0) ? 0 : 2;
+
+  d = fe_abs(d);
+
+  if (k == 0) {
+    fe_pair_t i = fe_div(fe_mul_pot(0.5,fe_sqrt(d)), a);
+
+    r[0] = fe_div(fe_mul_pot(-0.5,b), a);
+    r[1] = fe_abs(i);
+    return 0;
+  }
+
+  fe_pair_t s = fe_sqrt(d);
+  fe_pair_t q = fe_mul_pot(-0.5, (b.hi >= 0) ? fe_add(b,s) : fe_sub(b,s));
+
+  if (q.hi == 0) {
+    r[0] = r[1] = fe_zero();
+    return 2;
+  }
+
+  r[0] = fe_div(q,a);
+  r[1] = fe_div(c,q);
+
+  fe_poly_sort2_i(r);
+
+  return 2;
+}
+
+int fe_quadratic(double a, double b, double c, fe_pair_t* r)
+{
+  // the products of pairs with zero low parts are exact
+  return fe_quadratic_pp_i(fe_set_d(a), fe_set_d(b), fe_set_d(c), r, -1);
+}
+
+
+//**********************************************************
+// cubic (QBC)
+
+// q = p(x), dq = p'(x) and the deflated quadratic ax²+b1 x+c2. if 'm'
+// then q & dq are evaluated in pair (and rounded) so their signs are
+// right inside clustered roots where the double Horner is noise.
+static inline void fe_cubic_eval_i(double x, double a, double b, double c, double d,
+                                   double* q, double* dq, double* b1, double* c2, int m)
+{
+  double q0 = a*x;
+  double t1 = q0+b;
+  double t2 = t1*x+c;
+
+  *dq = (q0+t1)*x+t2;
+  *q  = t2*x+d;
+  *b1 = t1;
+  *c2 = t2;
+
+  if (m) {
+    fe_pair_t Q0 = fe_two_mul(a,x);
+    fe_pair_t T1 = fe_add_d(Q0,b);
+    fe_pair_t T2 = fe_add_d(fe_mul_d(T1,x),c);
+
+    *dq = fe_add(fe_mul_d(fe_add(Q0,T1),x),T2).hi;
+    *q  = fe_add_d(fe_mul_d(T2,x),d).hi;
+  }
+}
+
+// exact product of the expansion 'v' ('m' elements) and 'x' in place.
+// returns the number of elements (2m)
+static inline uint32_t fe_poly_scale_i(double* v, uint32_t m, double x)
+{
+  for(uint32_t i=m; i-- > 0;) {
+    fe_pair_t p = fe_two_mul(v[i],x);
+    v[2*i]   = p.hi;
+    v[2*i+1] = p.lo;
+  }
+
+  return 2*m;
+}
+
+// sign of the discriminant 18abcd - 4b³d + b²c² - 4ac³ - 27a²d² (> 0:
+// three distinct real roots, 0: a multiple root, < 0: one real root).
+// the double evaluation has an error below ~8u Σ|terms| so it's only
+// redone exactly when it's within 2^-48 Σ|terms| of zero.
+static int fe_cubic_disc_sign_i(double a, double b, double c, double d)
+{
+  static const double k[5] = {18,-4,1,-4,-27};
+  const  double f[5][4] = {
+    {a,b,c,d}, {b,b,b,d}, {b,b,c,c}, {a,c,c,c}, {a,a,d,d}
+  };
+
+  double s = 0, m = 0;
+
+  for(int i=0; i<5; i++) {
+    double t = k[i]*f[i][0]*f[i][1]*f[i][2]*f[i][3];
+    s += t;
+    m += fabs(t);
+  }
+
+  if (fabs(s) > 0x1.0p-48*m) return (s > 0) ? 1 : -1;
+
+  // each product of 4 factors is 8 elements. the coefficients ±1, ±4
+  // scale exactly, 18 & -27 double it.
+  double   v[5*16];
+  uint32_t n = 0;
+
+  for(int i=0; i<5; i++) {
+    double*  e = v+n;
+    uint32_t l = 1;
+
+    e[0] = f[i][0];
+
+    for(int j=1; j<4; j++) l = fe_poly_scale_i(e, l, f[i][j]);
+
+    if (fabs(k[i]) == 18 || fabs(k[i]) == 27)
+      l = fe_poly_scale_i(e, l, k[i]);
+    else
+      for(uint32_t j=0; j<l; j++) e[j] *= k[i];
+
+    n += l;
+  }
+
+  return fe_sum_sign_i(v,n);
+}
+
+// real root of ax³+bx²+cx+d (a ≠ 0) & the deflated quadratic. 'm' as
+// fe_cubic_eval_i: the root is then within ~an ulp even when clustered
+static double fe_cubic_root_i(double a, double b, double c, double d, double* b1, double* c2, int m)
+{
+  double x, q, dq;
+
+  if (d == 0) { *b1 = b; *c2 = c; return 0; }
+
+  // start on the far side of a root from the inflection point at a
+  // distance that bounds it: Newton then converges monotonically
+  x = -(b/a)/3.0;
+
+  fe_cubic_eval_i(x,a,b,c,d,&q,&dq,b1,c2,m);
+
+  if (q == 0) return x;
+
+  double t  = q/a;
+  double r  = cbrt(fabs(t));
+  double s  = (t < 0) ? -1.0 : 1.0;
+
+  t = -dq/a;
+
+  if (t > 0) r = 1.324718*fmax(r, sqrt(t));
+
+  // the bound only holds in exact arithmetic (the sign of 'q' can be
+  // noise for clustered roots) so bracket the sign change: (l,h) with
+  // p(l)/a < 0 < p(h)/a. x is one end & the other is pushed out until
+  // the sign differs.
+  double l  = x, h = x;
+  double x0 = x - s*r;
+
+  for(uint32_t i=0; i<64; i++) {
+    fe_cubic_eval_i(x0,a,b,c,d,&q,&dq,b1,c2,m);
+
+    if (q == 0) return x0;
+    if (((q < 0) == (a > 0)) == (s > 0)) break;
+
+    r  += r;
+    x0  = x - s*r;
+  }
+
+  if (s > 0) l = x0; else h = x0;
+
+  // Newton (biased toward monotonic steps) while it stays inside the
+  // bracket and the steps shrink, bisection otherwise. stop when the
+  // step is negligible or the bracket can't shrink.
+  double e = h-l;
+
+  x = x0;
+
+  for(uint32_t i=0; i<256; i++) {
+    if ((q < 0) == (a > 0)) l = x; else h = x;
+
+    double xn = (dq == 0) ? x : x - (q/dq)/1.000000000000001;
+
+    if (fabs(xn-x) <= 0x1.0p-53*fabs(x)) break;
+
+    if (!(xn > l && xn < h && fabs(xn-x) < e)) {
+      xn = l + 0.5*(h-l);
+      if (!(xn > l && xn < h)) break;
+    }
+
+    e = fabs(xn-x);
+    x = xn;
+
+    fe_cubic_eval_i(x,a,b,c,d,&q,&dq,b1,c2,m);
+
+    if (q == 0) break;
+  }
+
+  // the other deflation is more accurate for large |x|
+  if (fabs(a)*x*x > fabs(d/x)) {
+    *c2 = -d/x;
+    *b1 = (*c2-c)/x;
+  }
+
+  return x;
+}
+
+int fe_cubic_f64(double a, double b, double c, double d, double* r)
+{
+  if (a == 0) return fe_quadratic_f64(b,c,d,r);
+
+  double b1, c2;
+
+  r[0] = fe_cubic_root_i(a,b,c,d,&b1,&c2,0);
+
+  int k = fe_quadratic_f64_i(a,b1,c2,r+1, (fe_cubic_disc_sign_i(a,b,c,d) < 0) ? 0 : 2);
+
+  if (k == 2) fe_poly_sort3_f64_i(r);
+
+  return k+1;
+}
+
+int fe_cubic(double a, double b, double c, double d, fe_pair_t* r)
+{
+  if (a == 0) return fe_quadratic(b,c,d,r);
+
+  double    b1, c2;
+  double    x  = fe_cubic_root_i(a,b,c,d,&b1,&c2,1);
+  fe_pair_t X  = fe_set_d(x);
+  fe_pair_t B1 = fe_set_d(b);
+  fe_pair_t C2 = fe_set_d(c);
+
+  if (d != 0) {
+    // pair Newton until the step is below ~u²|x|. the residuals of the
+    // double root were evaluated in pair so it's within ~an ulp even
+    // for clustered roots: Newton only refines (a few steps)
+    for(uint32_t i=0; i<16; i++) {
+      fe_pair_t t = fe_cubic_polish(a,b,c,d,X);
+      double    e = fabs(t.hi-X.hi) + fabs(t.lo-X.lo);
+
+      X = t;
+
+      if (!(e > 0x1.0p-104*fabs(X.hi))) break;
+    }
+
+    if (fabs(a)*x*x > fabs(d/x)) {
+      C2 = fe_neg(fe_d_div(d,X));
+      B1 = fe_div(fe_sub_d(C2,c),X);
+    }
+    else {
+      B1 = fe_add_d(fe_mul_d(X,a),b);
+      C2 = fe_add_d(fe_mul(B1,X),c);
+    }
+  }
+
+  r[0] = X;
+
+  int k = fe_quadratic_pp_i(fe_set_d(a),B1,C2,r+1, (fe_cubic_disc_sign_i(a,b,c,d) < 0) ? 0 : 2);
+
+  if (k == 2) fe_poly_sort3_i(r);
+
+  return k+1;
+}
+
+
+//**********************************************************
+// batch forms
+
+void fe_quadratic_batch(const double* coef, size_t n, double* r, int8_t* k, uint32_t mode)
+{
+  for(size_t i=0; i<n; i++, coef += 3, r += 2) {
+    double a = coef[0], b = coef[1], c = coef[2];
+    int    m;
+
+    if (mode & FE_POLY_PAIR) {
+      fe_pair_t x[2];
+
+      m = fe_quadratic(a,b,c,x);
+
+      for(int j=0; j<m; j++)
+        if (mode & FE_POLY_POLISH) x[j] = fe_quadratic_polish(a,b,c,x[j]);
+
+      r[0] = fe_result(x[0]);
+      r[1] = fe_result(x[1]);
+    }
+    else {
+      m = fe_quadratic_f64(a,b,c,r);
+
+      for(int j=0; j<m; j++)
+        if (mode & FE_POLY_POLISH) r[j] = fe_result(fe_quadratic_polish(a,b,c,fe_set_d(r[j])));
+    }
+
+    if (m == 2) fe_poly_sort2_f64_i(r);
+
+    k[i] = (int8_t)m;
+  }
+}
+
+void fe_cubic_batch(const double* coef, size_t n, double* r, int8_t* k, uint32_t mode)
+{
+  for(size_t i=0; i<n; i++, coef += 4, r += 3) {
+    double a = coef[0], b = coef[1], c = coef[2], d = coef[3];
+    int    m;
+
+    // the degenerate (quadratic) case has a different root layout
+    if (a == 0) {
+      fe_quadratic_batch(coef+1, 1, r, k+i, mode);
+      r[2] = (double)NAN;
+      continue;
+    }
+
+    if (mode & FE_POLY_PAIR) {
+      fe_pair_t x[3];
+
+      m = fe_cubic(a,b,c,d,x);
+
+      for(int j=0; j<m; j++)
+        if (mode & FE_POLY_POLISH) x[j] = fe_cubic_polish(a,b,c,d,x[j]);
+
+      r[0] = fe_result(x[0]);
+      r[1] = fe_result(x[1]);
+      r[2] = fe_result(x[2]);
+    }
+    else {
+      m = fe_cubic_f64(a,b,c,d,r);
+
+      for(int j=0; j<m; j++)
+        if (mode & FE_POLY_POLISH) r[j] = fe_result(fe_cubic_polish(a,b,c,d,fe_set_d(r[j])));
+    }
+
+    if (m == 3) fe_poly_sort3_f64_i(r);
+
+    k[i] = (int8_t)m;
+  }
+}
+
+#endif
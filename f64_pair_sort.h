@@ -0,0 +1,344 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Sorting pair arrays built on `f64_pair.h`
+///
+/// * fe_key_t: order preserving 128-bit unsigned key of a pair
+/// * fe_to_key, fe_from_key: the mapping and its inverse
+/// * fe_sort_soa: LSD radix sort of a pair array given as (hi,lo) planes
+/// * `FE_PAIR_PTHREADS`: fe_sort_soa_mt (same result for any thread count)
+/// <br>
+/// The key of a double is its bit pattern with the sign bit flipped for
+/// non-negative values and all bits flipped for negative values, which
+/// makes unsigned integer order match the floating point order. The key
+/// of a pair is (key(hi),key(lo)) compared lexicographically which is
+/// the value order for normalized pairs ('hi' differs iff the values do
+/// in the same order). So the order is total: -NaN < -∞ < ... < -0 < +0 <
+/// ... < +∞ < +NaN and distinct keys of equal values only occur for
+/// signed zeros (including the sign of a zero 'lo').
+///
+/// The sort works directly on the planes: each pass computes the digit
+/// from the double (a couple of integer ops) and moves both 'hi' and
+/// 'lo', so the only workspace is a second pair of planes. Keys are
+/// 128 bits in `FE_SORT_BITS`-bit digits (12 passes for 11-bit digits)
+/// but passes where every element has the same digit are skipped (which
+/// is common for the top of the 'lo' keys and exponents of 'hi'). Equal
+/// keys are identical bit patterns so the stability of LSD is invisible
+/// and any correct sort gives the same output. The sorts return 0 or
+/// negative on allocation failure (the input is unchanged). The routines
+/// are only defined in the translation unit that defines
+/// `FE_PAIR_IMPLEMENTATION`.
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "f64_pair.h"
+
+// radix sort digit size: histograms are 2^FE_SORT_BITS entries per pass
+#ifndef FE_SORT_BITS
+#define FE_SORT_BITS 11
+#endif
+
+#define FE_SORT_RADIX      (1u << FE_SORT_BITS)
+#define FE_SORT_WORD_PASS  ((64+FE_SORT_BITS-1)/FE_SORT_BITS)
+#define FE_SORT_PASSES     (2*FE_SORT_WORD_PASS)
+
+#ifndef FE_SORT_MAX_THREADS
+#define FE_SORT_MAX_THREADS 64
+#endif
+
+// below this many elements per thread the threaded sort is serial
+#ifndef FE_SORT_MT_MIN
+#define FE_SORT_MT_MIN 0x8000
+#endif
+
+
+//**********************************************************
+// keys
+
+typedef struct { uint64_t hi, lo; } fe_key_t;
+
+static inline uint64_t fe_key_d(double x)
+{
+  uint64_t b = fe_to_bits(x);
+  return b ^ ((uint64_t)((int64_t)b >> 63) | (UINT64_C(1) << 63));
+}
+
+static inline double fe_key_to_d(uint64_t k)
+{
+  uint64_t m = (uint64_t)((int64_t)~k >> 63) | (UINT64_C(1) << 63);
+  return fe_from_bits(k ^ m);
+}
+
+static inline fe_key_t fe_to_key(fe_pair_t x)
+{
+  return (fe_key_t){.hi=fe_key_d(x.hi), .lo=fe_key_d(x.lo)};
+}
+
+static inline fe_pair_t fe_from_key(fe_key_t k)
+{
+  return fe_pair(fe_key_to_d(k.hi), fe_key_to_d(k.lo));
+}
+
+// -1, 0 or 1
+static inline int fe_key_cmp(fe_key_t a, fe_key_t b)
+{
+  int h = (a.hi > b.hi) - (a.hi < b.hi);
+  int l = (a.lo > b.lo) - (a.lo < b.lo);
+
+  return h ? h : l;
+}
+
+extern int fe_sort_soa(double* hi, double* lo, size_t n);
+
+#if defined(FE_PAIR_PTHREADS)
+extern int fe_sort_soa_mt(double* hi, double* lo, size_t n, uint32_t threads);
+#endif
+
+
+//**********************************************************
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+// digit 'p' of element 'i': passes [0,FE_SORT_WORD_PASS) are the 'lo' key
+static inline uint32_t fe_sort_digit_i(const double* hi, const double* lo, size_t i, uint32_t p)
+{
+  uint64_t k = (p < FE_SORT_WORD_PASS) ? fe_key_d(lo[i]) : fe_key_d(hi[i]);
+  uint32_t s = FE_SORT_BITS*(p % FE_SORT_WORD_PASS);
+
+  return (uint32_t)(k >> s) & (FE_SORT_RADIX-1);
+}
+
+// adds the digit counts of all passes of [b,e) to 'c' (FE_SORT_PASSES x FE_SORT_RADIX)
+static void fe_sort_hist_i(const double* hi, const double* lo, size_t b, size_t e, size_t* c)
+{
+  for(size_t i=b; i<e; i++) {
+    uint64_t kl = fe_key_d(lo[i]);
+    uint64_t kh = fe_key_d(hi[i]);
+
+    for(uint32_t p=0; p<FE_SORT_WORD_PASS; p++) {
+      c[ p                   *FE_SORT_RADIX + ((kl >> (FE_SORT_BITS*p)) & (FE_SORT_RADIX-1))]++;
+      c[(p+FE_SORT_WORD_PASS)*FE_SORT_RADIX + ((kh >> (FE_SORT_BITS*p)) & (FE_SORT_RADIX-1))]++;
+    }
+  }
+}
+
+// stable scatter of [b,e) by digit 'p'. 'o' is the next output position of each digit
+static void fe_sort_scatter_i(const double* sh, const double* sl, double* dh, double* dl,
+                              size_t b, size_t e, uint32_t p, size_t* o)
+{
+  const double* s     = (p < FE_SORT_WORD_PASS) ? sl : sh;
+  uint32_t      shift = FE_SORT_BITS*(p % FE_SORT_WORD_PASS);
+
+  for(size_t i=b; i<e; i++) {
+    uint32_t d = (uint32_t)(fe_key_d(s[i]) >> shift) & (FE_SORT_RADIX-1);
+    size_t   j = o[d]++;
+
+    dh[j] = sh[i];
+    dl[j] = sl[i];
+  }
+}
+
+// true if every element has the same digit for pass 'p' (global counts 'c')
+static inline bool fe_sort_skip_i(const double* hi, const double* lo, const size_t* c, size_t n, uint32_t p)
+{
+  return c[p*FE_SORT_RADIX + fe_sort_digit_i(hi,lo,0,p)] == n;
+}
+
+int fe_sort_soa(double* hi, double* lo, size_t n)
+{
+  if (n < 2) return 0;
+
+  // workspace: two planes & the histograms of all passes
+  double* w = malloc(2*n*sizeof(double) + FE_SORT_PASSES*FE_SORT_RADIX*sizeof(size_t));
+
+  if (w == NULL) return -1;
+
+  size_t* c  = (size_t*)(w+2*n);
+  double* sh = hi, *sl = lo;
+  double* dh = w,  *dl = w+n;
+
+  memset(c, 0, FE_SORT_PASSES*FE_SORT_RADIX*sizeof(size_t));
+
+  fe_sort_hist_i(hi,lo,0,n,c);
+
+  for(uint32_t p=0; p<FE_SORT_PASSES; p++) {
+    size_t* h = c + p*FE_SORT_RADIX;
+
+    if (fe_sort_skip_i(sh,sl,c,n,p)) continue;
+
+    // counts -> first output position of each digit
+    for(size_t d=0, s=0; d<FE_SORT_RADIX; d++) { size_t t = h[d]; h[d] = s; s += t; }
+
+    fe_sort_scatter_i(sh,sl,dh,dl,0,n,p,h);
+
+    double* t;
+    t = sh; sh = dh; dh = t;
+    t = sl; sl = dl; dl = t;
+  }
+
+  if (sh != hi) {
+    memcpy(hi, sh, n*sizeof(double));
+    memcpy(lo, sl, n*sizeof(double));
+  }
+
+  free(w);
+
+  return 0;
+}
+
+
+//**********************************************************
+// threaded sort (pthreads)
+//
+// The array is split into contiguous chunks (one per thread). Each pass
+// is two parallel phases: count the digits of each chunk then scatter
+// each chunk to positions from the prefix sum over (digit,chunk). That
+// is the serial scatter order so the result (and every intermediate
+// array) is identical to `fe_sort_soa`. The digit counts of the whole
+// array don't depend on the order so skipped passes are found once
+// up front. 'threads'=0 uses the number of online processors.
+
+#if defined(FE_PAIR_PTHREADS)
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct {
+  const double* sh;
+  const double* sl;
+  double*       dh;
+  double*       dl;
+  size_t        b, e;
+  uint32_t      p;
+  size_t*       c;         // digit counts/positions of the chunk
+} fe_sort_job_t;
+
+// all passes
+static void* fe_sort_hist_job(void* data)
+{
+  fe_sort_job_t* j = (fe_sort_job_t*)data;
+
+  memset(j->c, 0, FE_SORT_PASSES*FE_SORT_RADIX*sizeof(size_t));
+  fe_sort_hist_i(j->sh, j->sl, j->b, j->e, j->c);
+
+  return NULL;
+}
+
+// pass 'p' only
+static void* fe_sort_count_job(void* data)
+{
+  fe_sort_job_t* j = (fe_sort_job_t*)data;
+
+  memset(j->c, 0, FE_SORT_RADIX*sizeof(size_t));
+
+  for(size_t i=j->b; i<j->e; i++)
+    j->c[fe_sort_digit_i(j->sh, j->sl, i, j->p)]++;
+
+  return NULL;
+}
+
+static void* fe_sort_scatter_job(void* data)
+{
+  fe_sort_job_t* j = (fe_sort_job_t*)data;
+  fe_sort_scatter_i(j->sh, j->sl, j->dh, j->dl, j->b, j->e, j->p, j->c);
+  return NULL;
+}
+
+// runs 'f' on the 't' jobs. the calling thread takes the first and a
+// failed thread create runs the job directly.
+static void fe_sort_run(void* (*f)(void*), fe_sort_job_t* job, uint32_t t)
+{
+  pthread_t tid[FE_SORT_MAX_THREADS];
+  int       ok [FE_SORT_MAX_THREADS];
+
+  for(uint32_t i=1; i<t; i++) {
+    ok[i] = pthread_create(tid+i, NULL, f, job+i) == 0;
+    if (!ok[i]) f(job+i);
+  }
+
+  f(job);
+
+  for(uint32_t i=1; i<t; i++)
+    if (ok[i]) pthread_join(tid[i], NULL);
+}
+
+int fe_sort_soa_mt(double* hi, double* lo, size_t n, uint32_t threads)
+{
+  fe_sort_job_t job[FE_SORT_MAX_THREADS];
+  uint32_t      t = threads;
+
+  if (t == 0) {
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    t = (c > 0) ? (uint32_t)c : 1;
+  }
+
+  if (t > FE_SORT_MAX_THREADS)  t = FE_SORT_MAX_THREADS;
+  if (t > n/FE_SORT_MT_MIN)     t = (uint32_t)(n/FE_SORT_MT_MIN);
+
+  if (t <= 1) return fe_sort_soa(hi,lo,n);
+
+  // workspace: two planes, the global counts & the per chunk counts of all passes
+  size_t  hs = FE_SORT_PASSES*FE_SORT_RADIX;
+  double* w  = malloc(2*n*sizeof(double) + (t+1)*hs*sizeof(size_t));
+
+  if (w == NULL) return -1;
+
+  size_t* c  = (size_t*)(w+2*n);
+  double* sh = hi, *sl = lo;
+  double* dh = w,  *dl = w+n;
+
+  for(uint32_t i=0; i<t; i++) {
+    job[i].b = n*i/t;
+    job[i].e = n*(i+1)/t;
+    job[i].c = c + (i+1)*hs;
+  }
+
+  // global counts of all passes
+  for(uint32_t i=0; i<t; i++) { job[i].sh = hi; job[i].sl = lo; }
+
+  fe_sort_run(fe_sort_hist_job, job, t);
+
+  memset(c, 0, hs*sizeof(size_t));
+
+  for(uint32_t i=0; i<t; i++)
+    for(size_t k=0; k<hs; k++) c[k] += job[i].c[k];
+
+  for(uint32_t p=0; p<FE_SORT_PASSES; p++) {
+    if (fe_sort_skip_i(sh,sl,c,n,p)) continue;
+
+    for(uint32_t i=0; i<t; i++) {
+      job[i].sh = sh; job[i].sl = sl;
+      job[i].dh = dh; job[i].dl = dl;
+      job[i].p  = p;
+    }
+
+    fe_sort_run(fe_sort_count_job, job, t);
+
+    // counts -> first output position of each (digit,chunk)
+    size_t s = 0;
+
+    for(size_t d=0; d<FE_SORT_RADIX; d++)
+      for(uint32_t i=0; i<t; i++) { size_t v = job[i].c[d]; job[i].c[d] = s; s += v; }
+
+    fe_sort_run(fe_sort_scatter_job, job, t);
+
+    double* v;
+    v = sh; sh = dh; dh = v;
+    v = sl; sl = dl; dl = v;
+  }
+
+  if (sh != hi) {
+    memcpy(hi, sh, n*sizeof(double));
+    memcpy(lo, sl, n*sizeof(double));
+  }
+
+  free(w);
+
+  return 0;
+}
+
+#endif
+#endif
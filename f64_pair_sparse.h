@@ -0,0 +1,689 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Sparse matrices (double values) with pair precision accumulation
+///
+/// * fe_csr_t:  compressed sparse row view
+/// * fe_sell_t: SELL-C-σ (sliced ELLPACK) built from a CSR matrix
+/// * fe_{csr,sell}_spmv: y = Ax for double x with pair precision rows
+/// * fe_csr_residual: r = b-Ax in pair precision
+/// * fe_cg, fe_bicgstab: Krylov solvers with double vectors, pair
+///   precision reductions and pair precision residual replacement
+/// * `FE_PAIR_PTHREADS`: fe_{csr,sell}_spmv_mt partition the rows by
+///   nonzero count
+/// <br>
+/// The matrix values and 'x' stay in double (SpMV is bandwidth bound)
+/// and each row's dot product is computed with `fe_two_mul` and a
+/// compensated sum (Dot2 [^1]) so the result is as if computed in pair
+/// precision and rounded: error below γ²ₖ Σ|aᵢⱼxⱼ| where k is the row
+/// length and γₖ = ku/(1-ku). The result is returned as separate (hi,lo)
+/// arrays and 'lo' can be NULL to only store the rounded to double value.
+/// Row & column counts must be below 2³². The non-trivial routines are
+/// only defined in the translation unit that defines
+/// `FE_PAIR_IMPLEMENTATION`.
+///
+/// [^1]: "Accurate sum and dot product", Ogita, Rump & Oishi, 2005
+
+#pragma once
+
+#include <stddef.h>
+#include <stdlib.h>
+#include "f64_pair.h"
+
+// independent accumulators per CSR row (breaks the dependency chain)
+#ifndef FE_SPMV_LANES
+#define FE_SPMV_LANES 4
+#endif
+
+// rows per SELL slice: ideally a multiple of the SIMD width
+#ifndef FE_SELL_C
+#define FE_SELL_C 8
+#endif
+
+// Krylov solvers: also replace the recursive residual by the true
+// residual every FE_KRYLOV_REPLACE iterations (0: only on apparent
+// convergence)
+#ifndef FE_KRYLOV_REPLACE
+#define FE_KRYLOV_REPLACE 0
+#endif
+
+#ifndef FE_SP_MAX_THREADS
+#define FE_SP_MAX_THREADS 64
+#endif
+
+
+//**********************************************************
+// matrix formats
+
+// CSR: row 'i' is entries [row[i], row[i+1]) of 'col' and 'v'.
+typedef struct {
+  size_t    m;         // rows
+  size_t    n;         // columns
+  size_t*   row;       // m+1 offsets
+  uint32_t* col;       // column indices
+  double*   v;         // values
+} fe_csr_t;
+
+// SELL-C-σ: rows are sorted by decreasing length within windows of σ
+// rows and then grouped into slices of C rows. Each slice is stored
+// column-major (element 'j' of the slice's row 'r' is at sp[s]+j*C+r)
+// and padded to the length of its longest row with zero values. The
+// sort reduces the padding & 'perm' maps a sorted row back to the
+// original. Padding reads x[0] so 'x' must be finite.
+typedef struct {
+  size_t    m;         // rows
+  size_t    n;         // columns
+  size_t    slices;    // ceil(m/C)
+  size_t*   sp;        // slices+1 offsets
+  uint32_t* sw;        // slice widths
+  uint32_t* perm;      // sorted row -> original row
+  uint32_t* col;
+  double*   v;
+} fe_sell_t;
+
+static inline size_t fe_csr_nnz(fe_csr_t a) { return a.row[a.m]; }
+
+// stored elements including padding
+static inline size_t fe_sell_size(const fe_sell_t* a) { return a->sp[a->slices]; }
+
+typedef struct {
+  uint32_t iterations;   // matrix-vector products (BiCGStab: 2 per step)
+  uint32_t replacements; // residual replacements
+  int      converged;    // true residual below tolerance
+  double   residual;     // final |b-Ax|₂/|b|₂ (true residual)
+} fe_krylov_info_t;
+
+extern int  fe_sell_from_csr(fe_sell_t* s, fe_csr_t a, uint32_t sigma);
+extern void fe_sell_free(fe_sell_t* s);
+
+extern void fe_csr_spmv (fe_csr_t a, const double* x, double* yh, double* yl);
+extern void fe_sell_spmv(const fe_sell_t* a, const double* x, double* yh, double* yl);
+
+extern void fe_csr_residual(fe_csr_t a, const double* b, const double* x, double* rh, double* rl);
+
+extern int  fe_cg      (fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit, fe_krylov_info_t* info);
+extern int  fe_bicgstab(fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit, fe_krylov_info_t* info);
+
+#if defined(FE_PAIR_PTHREADS)
+extern void fe_csr_spmv_mt (fe_csr_t a, const double* x, double* yh, double* yl, uint32_t threads);
+extern void fe_sell_spmv_mt(const fe_sell_t* a, const double* x, double* yh, double* yl, uint32_t threads);
+#endif
+
+
+//**********************************************************
+// row kernels
+//
+// Dot2 step: (s,c) += a*b. The product is exact (`fe_two_mul`), the high
+// part goes through `fe_two_sum` and both error terms are accumulated
+// in 'c'. Lanes are combined the same way & the final (s,c) is
+// normalized. The lane loops are independent so GCC/clang vectorize
+// them (with a gather of 'x').
+
+static inline void fe_csr_rows_i(fe_csr_t a, const double* restrict x,
+                                 double* restrict yh, double* restrict yl,
+                                 size_t r0, size_t r1)
+{
+  const uint32_t* restrict col = a.col;
+  const double*   restrict v   = a.v;
+
+  for(size_t i=r0; i<r1; i++) {
+    size_t k = a.row[i];
+    size_t e = a.row[i+1];
+    double s[FE_SPMV_LANES];
+    double c[FE_SPMV_LANES];
+
+    for(uint32_t j=0; j<FE_SPMV_LANES; j++) { s[j] = 0; c[j] = 0; }
+
+    for(; e-k >= FE_SPMV_LANES; k += FE_SPMV_LANES) {
+      for(uint32_t j=0; j<FE_SPMV_LANES; j++) {
+        fe_pair_t p = fe_two_mul(v[k+j], x[col[k+j]]);
+        fe_pair_t t = fe_two_sum(s[j], p.hi);
+        s[j]  = t.hi;
+        c[j] += t.lo + p.lo;
+      }
+    }
+
+    for(uint32_t j=0; j<e-k; j++) {
+      fe_pair_t p = fe_two_mul(v[k+j], x[col[k+j]]);
+      fe_pair_t t = fe_two_sum(s[j], p.hi);
+      s[j]  = t.hi;
+      c[j] += t.lo + p.lo;
+    }
+
+    for(uint32_t j=1; j<FE_SPMV_LANES; j++) {
+      fe_pair_t t = fe_two_sum(s[0], s[j]);
+      s[0]  = t.hi;
+      c[0] += t.lo + c[j];
+    }
+
+    fe_pair_t r = fe_two_sum(s[0], c[0]);
+
+    yh[i] = r.hi;
+    if (yl) yl[i] = r.lo;
+  }
+}
+
+static inline void fe_sell_slices_i(const fe_sell_t* a, const double* restrict x,
+                                    double* restrict yh, double* restrict yl,
+                                    size_t s0, size_t s1)
+{
+  const uint32_t* restrict col = a->col;
+  const double*   restrict v   = a->v;
+
+  for(size_t sl=s0; sl<s1; sl++) {
+    size_t o = a->sp[sl];
+    double s[FE_SELL_C];
+    double c[FE_SELL_C];
+
+    for(uint32_t r=0; r<FE_SELL_C; r++) { s[r] = 0; c[r] = 0; }
+
+    for(uint32_t j=0; j<a->sw[sl]; j++, o += FE_SELL_C) {
+      for(uint32_t r=0; r<FE_SELL_C; r++) {
+        fe_pair_t p = fe_two_mul(v[o+r], x[col[o+r]]);
+        fe_pair_t t = fe_two_sum(s[r], p.hi);
+        s[r]  = t.hi;
+        c[r] += t.lo + p.lo;
+      }
+    }
+
+    size_t b = sl*FE_SELL_C;
+
+    for(uint32_t r=0; r<FE_SELL_C && b+r<a->m; r++) {
+      fe_pair_t y = fe_two_sum(s[r], c[r]);
+      uint32_t  i = a->perm[b+r];
+
+      yh[i] = y.hi;
+      if (yl) yl[i] = y.lo;
+    }
+  }
+}
+
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+void fe_csr_spmv(fe_csr_t a, const double* x, double* yh, double* yl)
+{
+  fe_csr_rows_i(a,x,yh,yl,0,a.m);
+}
+
+void fe_sell_spmv(const fe_sell_t* a, const double* x, double* yh, double* yl)
+{
+  fe_sell_slices_i(a,x,yh,yl,0,a->slices);
+}
+
+//**********************************************************
+// SELL-C-σ construction
+
+typedef struct {
+  uint32_t len;
+  uint32_t row;
+} fe_sell_key_t;
+
+// decreasing length, ties by row (so the layout is deterministic)
+static int fe_sell_key_cmp(const void* pa, const void* pb)
+{
+  const fe_sell_key_t* a = (const fe_sell_key_t*)pa;
+  const fe_sell_key_t* b = (const fe_sell_key_t*)pb;
+
+  if (a->len != b->len) return a->len < b->len ? 1 : -1;
+
+  return (a->row > b->row) - (a->row < b->row);
+}
+
+void fe_sell_free(fe_sell_t* s)
+{
+  free(s->sp);
+  free(s->sw);
+  free(s->perm);
+  free(s->col);
+  free(s->v);
+
+  s->sp = NULL; s->sw = NULL; s->perm = NULL; s->col = NULL; s->v = NULL;
+}
+
+// builds 's' from 'a' with sort windows of 'sigma' rows (0 or 1: no
+// sorting). σ is usually a multiple of C. returns 0 on success and
+// -1 on allocation failure.
+int fe_sell_from_csr(fe_sell_t* s, fe_csr_t a, uint32_t sigma)
+{
+  size_t m  = a.m;
+  size_t ns = (m + FE_SELL_C-1)/FE_SELL_C;
+
+  s->m      = m;
+  s->n      = a.n;
+  s->slices = ns;
+  s->sp     = malloc((ns+1)*sizeof(size_t));
+  s->sw     = malloc((ns+1)*sizeof(uint32_t));
+  s->perm   = malloc((m+1)*sizeof(uint32_t));
+  s->col    = NULL;
+  s->v      = NULL;
+
+  fe_sell_key_t* key = malloc((m+1)*sizeof(fe_sell_key_t));
+
+  if (!s->sp || !s->sw || !s->perm || !key) goto fail;
+
+  for(size_t i=0; i<m; i++)
+    key[i] = (fe_sell_key_t){ .len=(uint32_t)(a.row[i+1]-a.row[i]), .row=(uint32_t)i };
+
+  if (sigma > 1) {
+    for(size_t i=0; i<m; i += sigma) {
+      size_t w = (m-i < sigma) ? m-i : sigma;
+      qsort(key+i, w, sizeof(fe_sell_key_t), fe_sell_key_cmp);
+    }
+  }
+
+  size_t o = 0;
+
+  for(size_t sl=0; sl<ns; sl++) {
+    uint32_t w = 0;
+
+    for(size_t i=sl*FE_SELL_C; i<m && i<(sl+1)*FE_SELL_C; i++)
+      w = key[i].len > w ? key[i].len : w;
+
+    s->sp[sl] = o;
+    s->sw[sl] = w;
+    o += (size_t)w*FE_SELL_C;
+  }
+
+  s->sp[ns] = o;
+
+  s->col = calloc(o+1, sizeof(uint32_t));
+  s->v   = calloc(o+1, sizeof(double));
+
+  if (!s->col || !s->v) goto fail;
+
+  for(size_t i=0; i<m; i++) {
+    size_t   b = s->sp[i/FE_SELL_C] + i%FE_SELL_C;
+    uint32_t r = key[i].row;
+
+    s->perm[i] = r;
+
+    for(size_t k=a.row[r], j=0; k<a.row[r+1]; k++, j++) {
+      s->col[b+j*FE_SELL_C] = a.col[k];
+      s->v  [b+j*FE_SELL_C] = a.v[k];
+    }
+  }
+
+  free(key);
+
+  return 0;
+
+ fail:
+  free(key);
+  fe_sell_free(s);
+  return -1;
+}
+
+
+//**********************************************************
+// Krylov solvers
+//
+// The vectors (and so the memory traffic) stay in double. What changes
+// vs. plain double versions is:
+//   * every inner product is a compensated (Dot2) sum of exact products
+//     so the scalars (α, β, ω) carry ~full double precision instead of
+//     losing bits to cancellation (which is what destroys the
+//     A-orthogonality of the directions in ill-conditioned CG)
+//   * the products Ap are pair precision rows rounded once to double
+//   * the recursive residual drifts from b-Ax and is replaced by the
+//     pair precision true residual whenever it claims convergence (and
+//     every FE_KRYLOV_REPLACE iterations if nonzero. van der Vorst &
+//     Ye, 2000)
+// The iteration savings (vs. double on ill-conditioned SPD systems)
+// come mostly from the accurate Ap; the reductions alone change little.
+// Periodic replacement perturbs the CG recurrences & costs iterations
+// so it's off by default.
+// 'x' is the initial guess on entry. The tolerance is relative to |b|₂.
+// returns the number of matrix-vector products or -1 on allocation
+// failure.
+
+// Dot2 inner product
+static inline fe_pair_t fe_krylov_dot_i(const double* restrict x, const double* restrict y, size_t n)
+{
+  double s[FE_SPMV_LANES];
+  double c[FE_SPMV_LANES];
+  size_t i = 0;
+
+  for(uint32_t j=0; j<FE_SPMV_LANES; j++) { s[j] = 0; c[j] = 0; }
+
+  for(; n-i >= FE_SPMV_LANES; i += FE_SPMV_LANES) {
+    for(uint32_t j=0; j<FE_SPMV_LANES; j++) {
+      fe_pair_t p = fe_two_mul(x[i+j], y[i+j]);
+      fe_pair_t t = fe_two_sum(s[j], p.hi);
+      s[j]  = t.hi;
+      c[j] += t.lo + p.lo;
+    }
+  }
+
+  for(uint32_t j=0; j<n-i; j++) {
+    fe_pair_t p = fe_two_mul(x[i+j], y[i+j]);
+    fe_pair_t t = fe_two_sum(s[j], p.hi);
+    s[j]  = t.hi;
+    c[j] += t.lo + p.lo;
+  }
+
+  for(uint32_t j=1; j<FE_SPMV_LANES; j++) {
+    fe_pair_t t = fe_two_sum(s[0], s[j]);
+    s[0]  = t.hi;
+    c[0] += t.lo + c[j];
+  }
+
+  return fe_two_sum(s[0], c[0]);
+}
+
+static inline double fe_krylov_nrm_i(const double* x, size_t n)
+{
+  return sqrt(fe_krylov_dot_i(x,x,n).hi);
+}
+
+// r = b-Ax: Ax in pair precision then one pair subtraction
+void fe_csr_residual(fe_csr_t a, const double* b, const double* x, double* rh, double* rl)
+{
+  double* t = rl;
+
+  if (rl == NULL && (t = malloc(a.m*sizeof(double))) == NULL) {
+    // fallback: rounded Ax
+    fe_csr_spmv(a,x,rh,NULL);
+    for(size_t i=0; i<a.m; i++) rh[i] = b[i]-rh[i];
+    return;
+  }
+
+  fe_csr_spmv(a,x,rh,t);
+
+  for(size_t i=0; i<a.m; i++) {
+    fe_pair_t r = fe_d_sub(b[i], fe_pair(rh[i],t[i]));
+    rh[i] = r.hi;
+    t[i]  = r.lo;
+  }
+
+  if (rl == NULL) free(t);
+}
+
+static inline void fe_krylov_info_i(fe_krylov_info_t* info, uint32_t it, uint32_t rep, int conv, double res)
+{
+  if (info) *info = (fe_krylov_info_t){ .iterations=it, .replacements=rep, .converged=conv, .residual=res };
+}
+
+// conjugate gradient (A symmetric positive definite)
+int fe_cg(fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit, fe_krylov_info_t* info)
+{
+  size_t  n = a.m;
+  double* w = malloc(4*n*sizeof(double));
+
+  if (w == NULL) return -1;
+
+  double* r = w;
+  double* p = r+n;
+  double* q = p+n;
+  double* t = q+n;
+
+  double   bn  = fe_krylov_nrm_i(b,n);
+  double   eps = tol*bn;
+  uint32_t it  = 0;
+  uint32_t rep = 0;
+  int      cnv = 0;
+
+  if (bn == 0) bn = 1;
+
+  fe_csr_residual(a,b,x,r,t);
+
+  double rho = fe_krylov_dot_i(r,r,n).hi;
+
+  memcpy(p, r, n*sizeof(double));
+
+  while (it < maxit) {
+    if (sqrt(rho) <= eps) {
+      // apparent convergence: check (& replace with) the true residual
+      fe_csr_residual(a,b,x,r,t);
+      rho = fe_krylov_dot_i(r,r,n).hi;
+      if (sqrt(rho) <= eps) { cnv = 1; break; }
+      rep++;
+    }
+
+    fe_csr_spmv(a,p,q,NULL);
+    it++;
+
+    double pq = fe_krylov_dot_i(p,q,n).hi;
+
+    if (pq <= 0) break;                 // not SPD (or breakdown)
+
+    double alpha = rho/pq;
+
+    for(size_t i=0; i<n; i++) {
+      x[i] += alpha*p[i];
+      r[i] -= alpha*q[i];
+    }
+
+    if (FE_KRYLOV_REPLACE && it % FE_KRYLOV_REPLACE == 0) {
+      fe_csr_residual(a,b,x,r,t);
+      rep++;
+    }
+
+    double rn   = fe_krylov_dot_i(r,r,n).hi;
+    double beta = rn/rho;
+
+    rho = rn;
+
+    for(size_t i=0; i<n; i++)
+      p[i] = r[i] + beta*p[i];
+  }
+
+  if (!cnv) {
+    fe_csr_residual(a,b,x,r,t);
+    rho = fe_krylov_dot_i(r,r,n).hi;
+    cnv = sqrt(rho) <= eps;
+  }
+
+  fe_krylov_info_i(info, it, rep, cnv, sqrt(rho)/bn);
+
+  free(w);
+
+  return (int)it;
+}
+
+// BiCGStab (general A)
+int fe_bicgstab(fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit, fe_krylov_info_t* info)
+{
+  size_t  n = a.m;
+  double* w = malloc(7*n*sizeof(double));
+
+  if (w == NULL) return -1;
+
+  double* r  = w;
+  double* r0 = r+n;
+  double* p  = r0+n;
+  double* v  = p+n;
+  double* s  = v+n;
+  double* t  = s+n;
+  double* e  = t+n;
+
+  double   bn  = fe_krylov_nrm_i(b,n);
+  double   eps = tol*bn;
+  uint32_t it  = 0;
+  uint32_t rep = 0;
+  uint32_t k   = 0;
+  int      cnv = 0;
+
+  if (bn == 0) bn = 1;
+
+  fe_csr_residual(a,b,x,r,e);
+
+  memcpy(r0, r, n*sizeof(double));
+  memset(p,  0, n*sizeof(double));
+  memset(v,  0, n*sizeof(double));
+
+  double rho = 1, alpha = 1, omega = 1;
+  double rn  = fe_krylov_nrm_i(r,n);
+
+  while (it < maxit) {
+    if (rn <= eps) {
+      fe_csr_residual(a,b,x,r,e);
+      rn = fe_krylov_nrm_i(r,n);
+      if (rn <= eps) { cnv = 1; break; }
+      rep++;
+    }
+
+    double rh = fe_krylov_dot_i(r0,r,n).hi;
+
+    if (rh == 0 || omega == 0) break;   // breakdown
+
+    double beta = (rh/rho)*(alpha/omega);
+
+    rho = rh;
+
+    for(size_t i=0; i<n; i++)
+      p[i] = r[i] + beta*(p[i] - omega*v[i]);
+
+    fe_csr_spmv(a,p,v,NULL);
+    it++;
+
+    double rv = fe_krylov_dot_i(r0,v,n).hi;
+
+    if (rv == 0) break;
+
+    alpha = rho/rv;
+
+    for(size_t i=0; i<n; i++)
+      s[i] = r[i] - alpha*v[i];
+
+    fe_csr_spmv(a,s,t,NULL);
+    it++;
+
+    fe_pair_t tt = fe_krylov_dot_i(t,t,n);
+
+    omega = (tt.hi != 0) ? fe_div(fe_krylov_dot_i(t,s,n), tt).hi : 0;
+
+    for(size_t i=0; i<n; i++) {
+      x[i] += alpha*p[i] + omega*s[i];
+      r[i]  = s[i] - omega*t[i];
+    }
+
+    if (FE_KRYLOV_REPLACE && ++k % FE_KRYLOV_REPLACE == 0) {
+      fe_csr_residual(a,b,x,r,e);
+      rep++;
+    }
+
+    rn = fe_krylov_nrm_i(r,n);
+  }
+
+  if (!cnv) {
+    fe_csr_residual(a,b,x,r,e);
+    rn  = fe_krylov_nrm_i(r,n);
+    cnv = rn <= eps;
+  }
+
+  fe_krylov_info_i(info, it, rep, cnv, rn/bn);
+
+  free(w);
+
+  return (int)it;
+}
+
+
+//**********************************************************
+// threaded SpMV (pthreads)
+//
+// Each thread gets a contiguous block of rows (CSR) or slices (SELL)
+// with about the same number of stored elements (found by binary search
+// of the offsets). Every row is computed by exactly one thread with the
+// same kernel so the results don't depend on the thread count.
+// 'threads'=0 uses the number of online processors.
+
+#if defined(FE_PAIR_PTHREADS)
+
+#include <pthread.h>
+#include <unistd.h>
+
+typedef struct {
+  const void*   a;
+  const double* x;
+  double*       yh;
+  double*       yl;
+  size_t        b0, b1;
+} fe_spmv_job_t;
+
+static void* fe_csr_job(void* data)
+{
+  fe_spmv_job_t* j = (fe_spmv_job_t*)data;
+  fe_csr_rows_i(*(const fe_csr_t*)j->a, j->x, j->yh, j->yl, j->b0, j->b1);
+  return NULL;
+}
+
+static void* fe_sell_job(void* data)
+{
+  fe_spmv_job_t* j = (fe_spmv_job_t*)data;
+  fe_sell_slices_i((const fe_sell_t*)j->a, j->x, j->yh, j->yl, j->b0, j->b1);
+  return NULL;
+}
+
+// first index 'i' in [0,n] with off[i] >= v
+static size_t fe_sp_lower_bound(const size_t* off, size_t n, size_t v)
+{
+  size_t lo = 0, hi = n;
+
+  while (lo < hi) {
+    size_t mid = lo + (hi-lo)/2;
+    if (off[mid] < v) lo = mid+1; else hi = mid;
+  }
+
+  return lo;
+}
+
+// splits [0,n) (blocks with element offsets 'off') into 't' nonzero
+// balanced ranges and runs 'f'. the calling thread takes the first
+// range and a failed thread create runs the range directly.
+static void fe_spmv_run(void* (*f)(void*), fe_spmv_job_t* proto, const size_t* off, size_t n, uint32_t threads)
+{
+  fe_spmv_job_t job[FE_SP_MAX_THREADS];
+  pthread_t     tid[FE_SP_MAX_THREADS];
+  int           ok [FE_SP_MAX_THREADS];
+  uint32_t      t = threads;
+
+  if (t == 0) {
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    t = (c > 0) ? (uint32_t)c : 1;
+  }
+
+  if (t > FE_SP_MAX_THREADS) t = FE_SP_MAX_THREADS;
+  if (t > n)                 t = (uint32_t)(n ? n : 1);
+
+  size_t total = off[n] - off[0];
+  size_t b     = 0;
+
+  for(uint32_t i=0; i<t; i++) {
+    size_t e = (i == t-1) ? n : fe_sp_lower_bound(off, n, off[0] + (size_t)((double)total*(i+1)/t));
+
+    if (e < b) e = b;
+
+    job[i]    = *proto;
+    job[i].b0 = b;
+    job[i].b1 = e;
+    b = e;
+  }
+
+  for(uint32_t i=1; i<t; i++) {
+    ok[i] = pthread_create(tid+i, NULL, f, job+i) == 0;
+    if (!ok[i]) f(job+i);
+  }
+
+  f(job);
+
+  for(uint32_t i=1; i<t; i++)
+    if (ok[i]) pthread_join(tid[i], NULL);
+}
+
+void fe_csr_spmv_mt(fe_csr_t a, const double* x, double* yh, double* yl, uint32_t threads)
+{
+  fe_spmv_job_t p = { .a=&a, .x=x, .yh=yh, .yl=yl };
+  fe_spmv_run(fe_csr_job, &p, a.row, a.m, threads);
+}
+
+void fe_sell_spmv_mt(const fe_sell_t* a, const double* x, double* yh, double* yl, uint32_t threads)
+{
+  fe_spmv_job_t p = { .a=a, .x=x, .yh=yh, .yl=yl };
+  fe_spmv_run(fe_sell_job, &p, a->sp, a->slices, threads);
+}
+
+#endif
+#endif
@@ -0,0 +1,635 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+/// Summation and accumulation built on `f64_pair.h`
+///
+/// * fe_sum{_d}:  reference sums (each element via `fe_add`/`fe_add_d`)
+/// * fr_accum_t:  lazy normalization accumulator (CPair arithmetic)
+/// * fr_sum{_d}:  array sums using `fr_accum_t`
+/// * fe_accum_t:  mergeable multiple chain accumulator (for parallel reductions)
+/// * fe_rsum_t:   reproducible (order independent) binned accumulator
+/// * fe_{sum,dot}_d_mt, fe_{rsum,rdot}_d_mt: threaded array reductions (requires `FE_PAIR_PTHREADS`)
+/// <br>
+/// All sums return a normalized `fe_pair_t`.
+
+#pragma once
+
+#include <stddef.h>
+#include "f64_pair.h"
+
+
+//**********************************************************
+// reference sums: each element is added with the 'fe' op
+
+static inline fe_pair_t fe_sum_d(const double* x, size_t n)
+{
+  // DWPlusFP: 10 adds per element
+  fe_pair_t s = fe_zero();
+
+  for(size_t i=0; i<n; i++)
+    s = fe_add_d(s,x[i]);
+
+  return s;
+}
+
+static inline fe_pair_t fe_sum(const fe_pair_t* x, size_t n)
+{
+  // AccurateDWPlusDW: 20 adds per element
+  fe_pair_t s = fe_zero();
+
+  for(size_t i=0; i<n; i++)
+    s = fe_add(s,x[i]);
+
+  return s;
+}
+
+
+//**********************************************************
+// lazy normalization accumulator
+//
+// Runs a chain of CPairSum ops (`fr_add_d`: 7 adds, `fr_add`: 8 adds)
+// and only normalizes (`fr_normalize`: 3 adds) every `FR_ACCUM_PERIOD`
+// ops. The result is converted to a `fe_pair_t` once at the end.
+//
+// Error bound. Let u=2^-53, 'n' the number of elements added, A the sum
+// of their magnitudes & K=FR_ACCUM_PERIOD. For the state (h,l):
+//   * directly after a normalization |l| <= u|h| <= uA
+//   * `fr_add_d` computes (h',e) = 2Sum(h,x) exactly with |e| <= u|h'|
+//     and l' = RN(l+e). So after j ops since the last normalization
+//     |l| <= (j+1)uA(1+u)^j and the rounding error of the op is
+//     bounded by u|l'| <= (j+1)u²A(1+u)^j.
+//   * `fr_normalize` is exact if |h| >= |l| otherwise ([^6]) its error
+//     is bounded by u|h+l| <= 2(K+1)u²A.
+//   * summed over a period: ((K+3)/2 + 2(K+1)/K) K u²A and over 'n' ops:
+//
+//        |S - r| <= ((K+3)/2 + 2(K+1)/K) n u²A (1+u)^K
+//
+//   K=8 gives 7.75 n u²A vs. 2 n u²A for `fe_sum_d` (DWPlusFP 2u² per op).
+//   For pair elements (`fr_add`) each op can grow |l| by 2uA and rounds
+//   twice which gives the constant 2(K+1) + 2(2K+1)/K. (K=8: 22.25 vs. 3
+//   for `fe_sum`)
+// The bounds are relative to A (not the result) like all recursive
+// summation bounds. Larger K are cheaper and the bound grows linearly
+// in K.
+
+#ifndef FR_ACCUM_PERIOD
+#define FR_ACCUM_PERIOD 8
+#endif
+
+typedef struct {
+  fr_pair_t s;     // running sum
+  uint32_t  n;     // ops since last normalization
+} fr_accum_t;
+
+static inline fr_accum_t fr_accum(void)
+{
+  return (fr_accum_t){.s=fr_zero(), .n=0};
+}
+
+static inline fr_accum_t fr_accum_normalize(fr_accum_t a)
+{
+  a.s = fr_normalize(a.s);
+  a.n = 0;
+  return a;
+}
+
+static inline fr_accum_t fr_accum_add_d(fr_accum_t a, double x)
+{
+  a.s = fr_add_d(a.s,x);
+
+  if (++a.n == FR_ACCUM_PERIOD) a = fr_accum_normalize(a);
+
+  return a;
+}
+
+static inline fr_accum_t fr_accum_add(fr_accum_t a, fr_pair_t x)
+{
+  a.s = fr_add(a.s,x);
+
+  if (++a.n == FR_ACCUM_PERIOD) a = fr_accum_normalize(a);
+
+  return a;
+}
+
+// array versions: the inner loops are period sized and have no test
+static inline fr_accum_t fr_accum_add_array_d(fr_accum_t a, const double* x, size_t n)
+{
+  size_t i = 0;
+
+  while (i < n) {
+    size_t e = i + (FR_ACCUM_PERIOD - a.n);
+
+    if (e > n) e = n;
+
+    a.n += (uint32_t)(e-i);
+
+    for(; i<e; i++)
+      a.s = fr_add_d(a.s,x[i]);
+
+    if (a.n == FR_ACCUM_PERIOD) a = fr_accum_normalize(a);
+  }
+
+  return a;
+}
+
+static inline fr_accum_t fr_accum_add_array(fr_accum_t a, const fe_pair_t* x, size_t n)
+{
+  size_t i = 0;
+
+  while (i < n) {
+    size_t e = i + (FR_ACCUM_PERIOD - a.n);
+
+    if (e > n) e = n;
+
+    a.n += (uint32_t)(e-i);
+
+    for(; i<e; i++)
+      a.s = fr_add(a.s,fe2fr(x[i]));
+
+    if (a.n == FR_ACCUM_PERIOD) a = fr_accum_normalize(a);
+  }
+
+  return a;
+}
+
+// the state isn't required to be normalized (or |h| >= |l|)
+// so 2Sum instead of fr_normalize
+static inline fe_pair_t fr_accum_result(fr_accum_t a)
+{
+  return fe_two_sum(a.s.hi, a.s.lo);
+}
+
+static inline fe_pair_t fr_sum_d(const double* x, size_t n)
+{
+  return fr_accum_result(fr_accum_add_array_d(fr_accum(),x,n));
+}
+
+static inline fe_pair_t fr_sum(const fe_pair_t* x, size_t n)
+{
+  return fr_accum_result(fr_accum_add_array(fr_accum(),x,n));
+}
+
+
+//**********************************************************
+// mergeable accumulator
+//
+// Holds `FE_ACCUM_LANES` independent 'fe' accumulators to break the
+// dependency chain of the adds (the latency of a single chain is the
+// bottleneck). Single element adds round-robin the lanes & the array
+// versions add to all lanes in lockstep. Independent accumulators
+// (per thread, per shard, etc) are combined with `fe_accum_merge`.
+// Every op is an 'fe' op so the error bound is that of recursive
+// summation with `fe_add` (3u² per op) over the lanes & merges.
+
+#ifndef FE_ACCUM_LANES
+#define FE_ACCUM_LANES 4
+#endif
+
+typedef struct {
+  fe_pair_t s[FE_ACCUM_LANES];
+  uint32_t  i;                  // next lane for single element adds
+} fe_accum_t;
+
+static inline fe_accum_t fe_accum(void)
+{
+  fe_accum_t a;
+
+  for(uint32_t j=0; j<FE_ACCUM_LANES; j++) a.s[j] = fe_zero();
+
+  a.i = 0;
+
+  return a;
+}
+
+static inline fe_accum_t fe_accum_add_d(fe_accum_t a, double x)
+{
+  a.s[a.i] = fe_add_d(a.s[a.i],x);
+  a.i      = (a.i+1) % FE_ACCUM_LANES;
+  return a;
+}
+
+static inline fe_accum_t fe_accum_add(fe_accum_t a, fe_pair_t x)
+{
+  a.s[a.i] = fe_add(a.s[a.i],x);
+  a.i      = (a.i+1) % FE_ACCUM_LANES;
+  return a;
+}
+
+// adds the exact product xy
+static inline fe_accum_t fe_accum_add_mul_dd(fe_accum_t a, double x, double y)
+{
+  return fe_accum_add(a, fe_two_mul(x,y));
+}
+
+static inline fe_accum_t fe_accum_add_array_d(fe_accum_t a, const double* x, size_t n)
+{
+  size_t i = 0;
+
+  for(; n-i >= FE_ACCUM_LANES; i += FE_ACCUM_LANES)
+    for(uint32_t j=0; j<FE_ACCUM_LANES; j++)
+      a.s[j] = fe_add_d(a.s[j], x[i+j]);
+
+  for(uint32_t j=0; j<n-i; j++) a.s[j] = fe_add_d(a.s[j], x[i+j]);
+
+  return a;
+}
+
+static inline fe_accum_t fe_accum_add_array(fe_accum_t a, const fe_pair_t* x, size_t n)
+{
+  size_t i = 0;
+
+  for(; n-i >= FE_ACCUM_LANES; i += FE_ACCUM_LANES)
+    for(uint32_t j=0; j<FE_ACCUM_LANES; j++)
+      a.s[j] = fe_add(a.s[j], x[i+j]);
+
+  for(uint32_t j=0; j<n-i; j++) a.s[j] = fe_add(a.s[j], x[i+j]);
+
+  return a;
+}
+
+// adds sum of x[i]y[i] (products are exact)
+static inline fe_accum_t fe_accum_add_dot_d(fe_accum_t a, const double* x, const double* y, size_t n)
+{
+  size_t i = 0;
+
+  for(; n-i >= FE_ACCUM_LANES; i += FE_ACCUM_LANES)
+    for(uint32_t j=0; j<FE_ACCUM_LANES; j++)
+      a.s[j] = fe_add(a.s[j], fe_two_mul(x[i+j],y[i+j]));
+
+  for(uint32_t j=0; j<n-i; j++) a.s[j] = fe_add(a.s[j], fe_two_mul(x[i+j],y[i+j]));
+
+  return a;
+}
+
+static inline fe_accum_t fe_accum_merge(fe_accum_t a, fe_accum_t b)
+{
+  for(uint32_t j=0; j<FE_ACCUM_LANES; j++)
+    a.s[j] = fe_add(a.s[j], b.s[j]);
+
+  return a;
+}
+
+// pairwise reduction of the lanes
+static inline fe_pair_t fe_accum_result(fe_accum_t a)
+{
+  for(uint32_t w=FE_ACCUM_LANES>>1; w>0; w >>= 1)
+    for(uint32_t j=0; j<w; j++)
+      a.s[j] = fe_add(a.s[j], a.s[j+w]);
+
+  return a.s[0];
+}
+
+
+//**********************************************************
+// reproducible binned accumulator
+//
+// Like ReproBLAS the exponent range is split into fixed boundary bins
+// (independent of the data) but here each bin holds an integer partial
+// sum. A double x = m 2^(k-1075) (53 bit integer 'm') is deposited as
+// the three 32-bit digits of m 2^(k-1 mod 32) into bins (k-1)/32 + {0,1,2}.
+// Since integer adds are associative the state only depends on the
+// multiset of inputs (not order, chunking or merge tree) and the result
+// is a fixed function of the exact sum. So the result is bit identical
+// for any permutation & thread count. Additionally the final conversion
+// works on the exact sum so the error is relative to the result:
+//   |S - r| <= 2u²|S|  (vs. n u²A of the recursive sums)
+// at a cost of ~3 integer adds per double (no sort and no data
+// dependent passes). The state is ~530 bytes so (unlike the other
+// accumulators) the functions take a pointer.
+//
+// Digits are on [-2^32,2^32] so the carries are propagated every
+// `FE_RSUM_CARRY` adds (must be <= 2^30). Infinities and NaNs are
+// summed separately (in float) and dominate the result.
+
+#define FE_RSUM_W     32
+#define FE_RSUM_BINS  (2046/FE_RSUM_W + 3)
+
+#ifndef FE_RSUM_CARRY
+#define FE_RSUM_CARRY (UINT32_C(1)<<30)
+#endif
+
+typedef struct {
+  int64_t  b[FE_RSUM_BINS];  // b[j] has weight 2^(32j-1074)
+  uint32_t n;                // adds since last carry propagation
+  double   sp;               // sum of non-finite inputs
+} fe_rsum_t;
+
+// propagate carries: b[j] on [0,2^32) except the top bin (canonical)
+static inline void fe_rsum_carry(fe_rsum_t* r)
+{
+  for(uint32_t j=0; j<FE_RSUM_BINS-1; j++) {
+    int64_t c = r->b[j] >> FE_RSUM_W;   // floor
+    r->b[j]   -= (int64_t)((uint64_t)c << FE_RSUM_W);
+    r->b[j+1] += c;
+  }
+
+  r->n = 0;
+}
+
+static inline void fe_rsum_init(fe_rsum_t* r)
+{
+  memset(r, 0, sizeof(fe_rsum_t));
+}
+
+static inline void fe_rsum_add_d(fe_rsum_t* r, double x)
+{
+  uint64_t u = fe_to_bits(x);
+  uint64_t k = (u >> 52) & 0x7ff;
+  uint64_t m = u & UINT64_C(0xfffffffffffff);
+
+  if (fe_unlikely(k == 0x7ff)) { r->sp += x; return; }
+
+  // subnormals have the same scale as k=1 w/o the implied bit
+  m |= (uint64_t)(k != 0) << 52;
+  k += (k == 0);
+  k -= 1;
+
+  uint32_t j  = (uint32_t)(k >> 5);
+  uint32_t sh = (uint32_t)(k & 31);
+  int64_t  sx = (int64_t)(u >> 63);          // 0 or 1
+  uint64_t d0 = (m << sh) & 0xffffffff;
+  uint64_t t  = (m >> 1) >> (31-sh);
+  uint64_t d1 = t & 0xffffffff;
+  uint64_t d2 = t >> 32;
+
+  // conditional negate: (d^-s)+s
+  r->b[j  ] += ((int64_t)d0 ^ -sx) + sx;
+  r->b[j+1] += ((int64_t)d1 ^ -sx) + sx;
+  r->b[j+2] += ((int64_t)d2 ^ -sx) + sx;
+
+  if (fe_unlikely(++r->n == FE_RSUM_CARRY)) fe_rsum_carry(r);
+}
+
+static inline void fe_rsum_add(fe_rsum_t* r, fe_pair_t x)
+{
+  fe_rsum_add_d(r, x.hi);
+  fe_rsum_add_d(r, x.lo);
+}
+
+// adds the exact product xy (barring underflow of the error term)
+static inline void fe_rsum_add_mul_dd(fe_rsum_t* r, double x, double y)
+{
+  fe_rsum_add(r, fe_two_mul(x,y));
+}
+
+static inline void fe_rsum_add_array_d(fe_rsum_t* r, const double* x, size_t n)
+{
+  for(size_t i=0; i<n; i++) fe_rsum_add_d(r, x[i]);
+}
+
+static inline void fe_rsum_add_array(fe_rsum_t* r, const fe_pair_t* x, size_t n)
+{
+  for(size_t i=0; i<n; i++) fe_rsum_add(r, x[i]);
+}
+
+static inline void fe_rsum_add_dot_d(fe_rsum_t* r, const double* x, const double* y, size_t n)
+{
+  for(size_t i=0; i<n; i++) fe_rsum_add_mul_dd(r, x[i], y[i]);
+}
+
+// r += s
+static inline void fe_rsum_merge(fe_rsum_t* r, const fe_rsum_t* s)
+{
+  fe_rsum_t t = *s;
+
+  fe_rsum_carry(r);
+  fe_rsum_carry(&t);
+
+  for(uint32_t j=0; j<FE_RSUM_BINS; j++)
+    r->b[j] += t.b[j];
+
+  r->sp += t.sp;
+  r->n   = 2;
+}
+
+static inline fe_pair_t fe_rsum_result(const fe_rsum_t* s)
+{
+  if (s->sp != 0 || s->sp != s->sp)
+    return fe_pair(s->sp, 0);
+
+  fe_rsum_t r = *s;
+  int       m = 1;
+
+  fe_rsum_carry(&r);
+
+  // sign-magnitude: all digits non-negative
+  if (r.b[FE_RSUM_BINS-1] < 0) {
+    for(uint32_t j=0; j<FE_RSUM_BINS; j++) r.b[j] = -r.b[j];
+    fe_rsum_carry(&r);
+    m = -1;
+  }
+
+  // digits are exact doubles and all terms are the same sign
+  fe_pair_t z = fe_zero();
+
+  for(uint32_t j=0; j<FE_RSUM_BINS; j++) {
+    if (r.b[j] != 0)
+      z = fe_add_d(z, ldexp((double)r.b[j], (int)(FE_RSUM_W*j)-1074));
+  }
+
+  return (m > 0) ? z : fe_neg(z);
+}
+
+static inline fe_pair_t fe_rsum_d(const double* x, size_t n)
+{
+  fe_rsum_t r;
+  fe_rsum_init(&r);
+  fe_rsum_add_array_d(&r,x,n);
+  return fe_rsum_result(&r);
+}
+
+static inline fe_pair_t fe_rsum(const fe_pair_t* x, size_t n)
+{
+  fe_rsum_t r;
+  fe_rsum_init(&r);
+  fe_rsum_add_array(&r,x,n);
+  return fe_rsum_result(&r);
+}
+
+static inline fe_pair_t fe_rdot_d(const double* x, const double* y, size_t n)
+{
+  fe_rsum_t r;
+  fe_rsum_init(&r);
+  fe_rsum_add_dot_d(&r,x,y,n);
+  return fe_rsum_result(&r);
+}
+
+
+//**********************************************************
+// threaded reductions (pthreads)
+//
+// The array is split into 'threads' contiguous chunks which are reduced
+// in parallel and merged in chunk order. 'threads'=0 uses the number of
+// online processors.
+// * fe_{sum,dot}_d_mt:   `fe_accum_t` per chunk. The result depends on
+//                        the thread count (but is otherwise deterministic)
+// * fe_{rsum,rdot}_d_mt: `fe_rsum_t` per chunk. The result is bit
+//                        identical to `fe_rsum_d`/`fe_rdot_d` for any
+//                        thread count.
+
+#if defined(FE_PAIR_PTHREADS)
+
+#include <pthread.h>
+
+extern fe_pair_t fe_sum_d_mt (const double* x, size_t n, uint32_t threads);
+extern fe_pair_t fe_dot_d_mt (const double* x, const double* y, size_t n, uint32_t threads);
+extern fe_pair_t fe_rsum_d_mt(const double* x, size_t n, uint32_t threads);
+extern fe_pair_t fe_rdot_d_mt(const double* x, const double* y, size_t n, uint32_t threads);
+
+#if defined(FE_PAIR_IMPLEMENTATION)
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#ifndef FE_PAIR_MAX_THREADS
+#define FE_PAIR_MAX_THREADS 256
+#endif
+
+typedef struct {
+  const double* x;
+  const double* y;     // NULL for sums
+  size_t        n;
+  union {
+    fe_accum_t  a;
+    fe_rsum_t   r;
+  };
+} fe_reduce_job_t;
+
+static void* fe_accum_job(void* data)
+{
+  fe_reduce_job_t* job = (fe_reduce_job_t*)data;
+
+  if (job->y == NULL)
+    job->a = fe_accum_add_array_d(fe_accum(), job->x, job->n);
+  else
+    job->a = fe_accum_add_dot_d(fe_accum(), job->x, job->y, job->n);
+
+  return NULL;
+}
+
+static void* fe_rsum_job(void* data)
+{
+  fe_reduce_job_t* job = (fe_reduce_job_t*)data;
+
+  fe_rsum_init(&job->r);
+
+  if (job->y == NULL)
+    fe_rsum_add_array_d(&job->r, job->x, job->n);
+  else
+    fe_rsum_add_dot_d(&job->r, job->x, job->y, job->n);
+
+  return NULL;
+}
+
+static uint32_t fe_pair_thread_count(uint32_t threads, size_t n)
+{
+  if (threads == 0) {
+    long c = sysconf(_SC_NPROCESSORS_ONLN);
+    threads = (c > 0) ? (uint32_t)c : 1;
+  }
+
+  if (threads > FE_PAIR_MAX_THREADS) threads = FE_PAIR_MAX_THREADS;
+  if (threads > n)                   threads = (uint32_t)(n ? n : 1);
+
+  return threads;
+}
+
+// splits [0,n) into 't' chunks & runs 'f' on each. The calling thread
+// takes the first chunk and a failed thread create falls back to
+// running the job directly.
+static void fe_reduce_run(void* (*f)(void*), fe_reduce_job_t* job, uint32_t t,
+                          const double* x, const double* y, size_t n)
+{
+  pthread_t tid[FE_PAIR_MAX_THREADS];
+  int       ok [FE_PAIR_MAX_THREADS];
+  size_t    c = n / t;
+  size_t    o = 0;
+
+  for(uint32_t i=0; i<t; i++) {
+    size_t len = (i == t-1) ? n-o : c;
+
+    job[i].x = x+o;
+    job[i].y = y ? y+o : NULL;
+    job[i].n = len;
+    o       += len;
+  }
+
+  for(uint32_t i=1; i<t; i++) {
+    ok[i] = pthread_create(tid+i, NULL, f, job+i) == 0;
+    if (!ok[i]) f(job+i);
+  }
+
+  f(job);
+
+  for(uint32_t i=1; i<t; i++)
+    if (ok[i]) pthread_join(tid[i], NULL);
+}
+
+static fe_pair_t fe_accum_mt(const double* x, const double* y, size_t n, uint32_t threads)
+{
+  uint32_t         t   = fe_pair_thread_count(threads,n);
+  fe_reduce_job_t* job = malloc(t*sizeof(fe_reduce_job_t));
+
+  if (job == NULL) t = 1;
+
+  fe_accum_t a;
+
+  if (t > 1) {
+    fe_reduce_run(fe_accum_job, job, t, x, y, n);
+
+    a = job[0].a;
+
+    for(uint32_t i=1; i<t; i++)
+      a = fe_accum_merge(a, job[i].a);
+  }
+  else
+    a = y ? fe_accum_add_dot_d(fe_accum(),x,y,n) : fe_accum_add_array_d(fe_accum(),x,n);
+
+  free(job);
+
+  return fe_accum_result(a);
+}
+
+static fe_pair_t fe_rsum_mt(const double* x, const double* y, size_t n, uint32_t threads)
+{
+  uint32_t         t   = fe_pair_thread_count(threads,n);
+  fe_reduce_job_t* job = malloc(t*sizeof(fe_reduce_job_t));
+
+  // the result doesn't depend on the chunking so serial is a valid fallback
+  if (job == NULL) return y ? fe_rdot_d(x,y,n) : fe_rsum_d(x,n);
+
+  fe_reduce_run(fe_rsum_job, job, t, x, y, n);
+
+  for(uint32_t i=1; i<t; i++)
+    fe_rsum_merge(&job[0].r, &job[i].r);
+
+  fe_pair_t r = fe_rsum_result(&job[0].r);
+
+  free(job);
+
+  return r;
+}
+
+fe_pair_t fe_sum_d_mt(const double* x, size_t n, uint32_t threads)
+{
+  return fe_accum_mt(x,NULL,n,threads);
+}
+
+fe_pair_t fe_dot_d_mt(const double* x, const double* y, size_t n, uint32_t threads)
+{
+  return fe_accum_mt(x,y,n,threads);
+}
+
+fe_pair_t fe_rsum_d_mt(const double* x, size_t n, uint32_t threads)
+{
+  return fe_rsum_mt(x,NULL,n,threads);
+}
+
+fe_pair_t fe_rdot_d_mt(const double* x, const double* y, size_t n, uint32_t threads)
+{
+  return fe_rsum_mt(x,y,n,threads);
+}
+
+#endif
+#endif
@@ -0,0 +1,163 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Correctness & contention benchmark of f64_pair_atomic.h. Every add is
+// (1+2^-70) so all partial sums are exact & the final totals must
+// match bit for bit regardless of interleaving.
+
+#include "common.h"
+#include "../f64_pair_atomic.h"
+
+#include <pthread.h>
+#include <time.h>
+#include <unistd.h>
+
+#define OPS  0x40000
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+static const fe_pair_t one_eps = { .hi=1.0, .lo=0x1.0p-70 };
+
+fe_atomic_pair_t  shared_a;
+fe_sharded_pair_t shared_s;
+
+typedef struct {
+  pthread_t tid;
+  uint32_t  id;
+  int       mode;
+} worker_t;
+
+enum { MODE_ATOMIC, MODE_SHARDED, MODE_SHARDED_SLOT, MODE_LENGTH };
+
+static const char* mode_name[] = { "fe_atomic", "fe_sharded", "fe_sharded(slot)" };
+
+void* worker(void* data)
+{
+  worker_t* w = (worker_t*)data;
+
+  switch(w->mode) {
+    case MODE_ATOMIC:
+      for(int i=0; i<OPS; i++) fe_atomic_fetch_add(&shared_a, one_eps);
+      break;
+    case MODE_SHARDED:
+      for(int i=0; i<OPS; i++) fe_sharded_add(&shared_s, one_eps);
+      break;
+    default:
+      for(int i=0; i<OPS; i++) fe_sharded_add_slot(&shared_s, one_eps, w->id);
+  }
+
+  return NULL;
+}
+
+static inline int same(fe_pair_t a, fe_pair_t b)
+{
+  return fe_to_bits(a.hi) == fe_to_bits(b.hi) && fe_to_bits(a.lo) == fe_to_bits(b.lo);
+}
+
+uint64_t basic_tests(void)
+{
+  uint64_t         errors = 0;
+  fe_atomic_pair_t a;
+
+  fe_atomic_init(&a, fe_zero());
+
+  for(int i=0; i<100; i++) {
+    fe_pair_t o = fe_atomic_fetch_add(&a, one_eps);
+    errors += !same(o, fe_pair((double)i, i*0x1.0p-70));
+  }
+
+  errors += !same(fe_atomic_load(&a), fe_pair(100.0, 100*0x1.0p-70));
+  errors += !same(fe_atomic_fetch_add_d(&a, 0.5), fe_pair(100.0, 100*0x1.0p-70));
+  errors += !same(fe_atomic_exchange(&a, fe_one()), fe_add_d(fe_pair(100.0, 100*0x1.0p-70), 0.5));
+  errors += !same(fe_atomic_load(&a), fe_one());
+
+  fe_sharded_init(&shared_s);
+
+  for(uint32_t i=0; i<3*FE_SHARDED_SLOTS; i++) fe_sharded_add_d_slot(&shared_s, 1.0, i);
+
+  errors += !same(fe_sharded_exchange_zero(&shared_s), fe_pair(3*FE_SHARDED_SLOTS, 0));
+  errors += !same(fe_sharded_load(&shared_s), fe_zero());
+
+  return errors;
+}
+
+uint64_t contention_tests(void)
+{
+  uint64_t errors = 0;
+  long     cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t tmax = (uint32_t)(cpus > 8 ? cpus : 8);
+  worker_t w[256];
+
+  if (tmax > 256) tmax = 256;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\ncontention: %d adds per thread, %ld online cpus, lock-free=%d\n" SGR_RESET,
+         OPS, cpus, FE_ATOMIC_LOCK_FREE);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("method",16), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("threads",3) },
+      { REPORT_TABLE_F("ns/add",3,3) },
+      { REPORT_TABLE_F("Madd/s",4,2) },
+      { REPORT_TABLE_STR("total",5) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int mode=0; mode<MODE_LENGTH; mode++) {
+    for(uint32_t t=1; t<=tmax; t*=2) {
+      fe_atomic_init(&shared_a, fe_zero());
+      fe_sharded_init(&shared_s);
+
+      double t0 = timer_ns();
+
+      for(uint32_t i=0; i<t; i++) {
+        w[i] = (worker_t){.id=i, .mode=mode};
+        pthread_create(&w[i].tid, NULL, worker, w+i);
+      }
+
+      for(uint32_t i=0; i<t; i++) pthread_join(w[i].tid, NULL);
+
+      double    t1 = timer_ns();
+      double    m  = (double)t*OPS;
+      fe_pair_t r  = (mode == MODE_ATOMIC) ? fe_atomic_load(&shared_a) : fe_sharded_load(&shared_s);
+
+      int       ok = same(r, fe_pair(m, m*0x1.0p-70));
+
+      errors += !ok;
+
+      report_table_row(stdout, &table, mode_name[mode], (uint64_t)t,
+                       (t1-t0)/m, 1e3*m/(t1-t0), ok ? "ok" : "FAIL");
+    }
+  }
+
+  report_table_end(stdout, &table);
+
+  return errors;
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, 128);
+  mpfr_init2(mp_t, 128);
+
+  uint64_t errors = basic_tests();
+
+  printf("basic: %s\n", errors ? "FAIL" : "ok");
+
+  errors += contention_tests();
+
+  return errors != 0;
+}
@@ -0,0 +1,68 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// C++ (constexpr) version of FE_CONST vs. MPFR: every constant must be
+// correctly rounded. The test harness headers are C only so this is
+// standalone.
+
+#include "../f64_pair_const.h"
+#include "f64_pair_const_list.h"
+
+#include <stdio.h>
+#include <mpfr.h>
+
+#define MP_PREC 4096
+
+// evaluated at compile time (constexpr) or this doesn't build
+#define K(X) FE_CONST(X),
+#define S(X) #X,
+
+static constexpr fe_pair_t   consts[] = { FE_CONST_TEST_LIST(K) };
+static const     char* const names[]  = { FE_CONST_TEST_LIST(S) };
+
+#undef K
+#undef S
+
+// a few spot checks against f64_pair.h's hand typed hex constants
+static_assert(fe_const("3.14159265358979323846264338327950288").hi == 0x1.921fb54442d18p1,  "pi");
+static_assert(fe_const("3.14159265358979323846264338327950288").lo == 0x1.1a62633145c07p-53, "pi");
+static_assert(fe_const("0.693147180559945309417232121458176568").lo == 0x1.abc9e3b39803fp-56, "log(2)");
+static_assert(fe_const("-1.41421356237309504880168872420969808").lo == 0x1.bdd3413b26456p-54, "-sqrt(2)");
+static_assert(fe_const("0x1.8p1").hi == 3.0 && fe_const("0x1.8p1").lo == 0, "hex");
+
+static inline uint64_t bits(double x)
+{
+  uint64_t u = 0;
+  memcpy(&u, &x, sizeof(u));
+  return u;
+}
+
+int main(void)
+{
+  mpfr_t   k;
+  uint64_t errors = 0;
+  uint32_t n = (uint32_t)(sizeof(consts)/sizeof(consts[0]));
+
+  mpfr_init2(k, MP_PREC);
+
+  for(uint32_t i=0; i<n; i++) {
+    mpfr_set_str(k, names[i], 0, MPFR_RNDN);
+
+    double hi = mpfr_get_d(k, MPFR_RNDN);
+    mpfr_sub_d(k, k, hi, MPFR_RNDN);
+    double lo = mpfr_get_d(k, MPFR_RNDN);
+
+    if (bits(consts[i].hi) != bits(hi) || bits(consts[i].lo) != bits(lo)) {
+      errors++;
+      printf("  %s: got {%a,%a} expected {%a,%a}\n", names[i], consts[i].hi, consts[i].lo, hi, lo);
+    }
+  }
+
+  mpfr_clear(k);
+
+  printf("\nFE_CONST (C++ constexpr): %u constants, %lu not correctly rounded\n", n, (unsigned long)errors);
+  printf("\nerrors: %lu\n", (unsigned long)errors);
+
+  return errors != 0;
+}
@@ -0,0 +1,66 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// literals for the FE_CONST tests (X-macro): mathematical and physical
+// constants, polynomial coefficients and edge cases. Shared by the C
+// (f64_pair_const_test.c) and C++ (f64_pair_const_cxx_test.cpp) tests.
+
+#define FE_CONST_TEST_LIST(X)                                               \
+  X(3.14159265358979323846264338327950288419716939937510582097494459)     \
+  X(0.31830988618379067153776752674502872406891929148091289749533468)     \
+  X(2.71828182845904523536028747135266249775724709369995957496696763)     \
+  X(0.36787944117144232159552377016146086744581113103176783450783680)     \
+  X(0.69314718055994530941723212145817656807550013436025525412068001)     \
+  X(1.44269504088896340735992468100189213742664595415298593413544940)     \
+  X(2.30258509299404568401799145468436420760110148862877297603332790)     \
+  X(0.43429448190325182765112891891660508229439700580366656611445378)     \
+  X(1.41421356237309504880168872420969807856967187537694807317667974)     \
+  X(0.70710678118654752440084436210484903928483593768847403658833987)     \
+  X(1.73205080756887729352744634150587236694280525381038062805580698)     \
+  X(0.57721566490153286060651209008240243104215933593992359880576723)     \
+  X(1.61803398874989484820458683436563811772030917980576286213544862)     \
+  X(0.91596559417721901505460351493238411077414937428167213426649811)     \
+  X(1.20205690315959428539973816151144999076498629234049888179227155)     \
+  X(0.78539816339744830961566084581987572104929234984377645524373614)     \
+  X(6.28318530717958647692528676655900576839433879875021164194988918)     \
+  X(1.12837916709551257389615890312154517168810125865799771368817144)     \
+  X(2.50662827463100050241576528481104525300698674060993831662992357)     \
+  X(0.39894228040143267793994605993438186847585863116493465766592583)     \
+  X(0.33333333333333333333333333333333333333333333333333333333333333)     \
+  X(0.14285714285714285714285714285714285714285714285714285714285714)     \
+  X(0.16666666666666666666666666666666666666666666666666666666666667)     \
+  X(0.00833333333333333333333333333333333333333333333333333333333333)     \
+  X(-0.00019841269841269841269841269841269841269841269841269841269841)    \
+  X(2.75573192239858906525573192239858906525573192239858906525573192e-6)  \
+  X(-2.50521083854417187750521083854417187750521083854417187750521084e-8) \
+  X(1.60590438368216145993923771701549479327257105034882940256742361e-10) \
+  X(6.62607015e-34)                                                       \
+  X(1.054571817646156391262428003302280744722e-34)                       \
+  X(299792458.0)                                                          \
+  X(1.602176634e-19)                                                      \
+  X(1.380649e-23)                                                         \
+  X(6.02214076e23)                                                        \
+  X(8.314462618153240)                                                    \
+  X(6.67430e-11)                                                          \
+  X(9.1093837015e-31)                                                     \
+  X(1.67262192369e-27)                                                    \
+  X(7.2973525693e-3)                                                      \
+  X(1.25663706212e-6)                                                     \
+  X(0.1)                                                                  \
+  X(-0.1)                                                                 \
+  X(0.2)                                                                  \
+  X(0.3)                                                                  \
+  X(1.0e23)                                                               \
+  X(9007199254740993.0)                                                   \
+  X(1.7976931348623157e308)                                               \
+  X(2.2250738585072014e-308)                                              \
+  X(4.9406564584124654e-324)                                              \
+  X(1.0e-310)                                                             \
+  X(1.2345678901234567890123456789012345678901234567890e-300)             \
+  X(9.8765432109876543210987654321098765432109876543210e+300)             \
+  X(0x1.921fb54442d18469898cc51701b8p1)                                   \
+  X(0x1.62e42fefa39ef35793c7673007e6p-1)                                  \
+  X(0x1.0000000000000800000000000001p0)                                   \
+  X(0x1.00000000000008p0)                                                 \
+  X(-0x1.fffffffffffff7ffffffffffffffp-2)
@@ -0,0 +1,92 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// C version of FE_CONST (binary128 evaluated) vs. MPFR. The constexpr
+// C++ version is tested by f64_pair_const_cxx_test.cpp
+
+#include "common.h"
+#include "../f64_pair_const.h"
+#include "f64_pair_const_list.h"
+
+#define MP_PREC 4096
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+typedef struct {
+  fe_pair_t   k;
+  const char* s;
+} const_test_t;
+
+#define K(X) { FE_CONST(X), #X },
+
+static const const_test_t consts[] = { FE_CONST_TEST_LIST(K) };
+
+#undef K
+
+// correctly rounded pair of the decimal string 's'
+static fe_pair_t mp_const(const char* s)
+{
+  fe_pair_t r;
+
+  mpfr_set_str(mp_e, s, 0, MPFR_RNDN);
+  r.hi = mpfr_get_d(mp_e, MPFR_RNDN);
+  mpfr_sub_d(mp_e, mp_e, r.hi, MPFR_RNDN);
+  r.lo = mpfr_get_d(mp_e, MPFR_RNDN);
+
+  return r;
+}
+
+// distance of 'x' from 'r' in ulps of 'r' (0 if equal)
+static double lo_ulps(double x, double r)
+{
+  if (x == r) return 0;
+
+  double u = (r != 0) ? ldexp(1.0, ilogb(r)-52) : 0x1.0p-1074;
+
+  return fabs(x-r)/fmax(u, 0x1.0p-1074);
+}
+
+int main(void)
+{
+  mpfr_init2(mp_e, MP_PREC);
+  mpfr_init2(mp_t, MP_PREC);
+
+  uint64_t errors = 0, hi_ok = 0, lo_ok = 0;
+  double   lo_max = 0;
+  uint32_t n = (uint32_t)LENGTHOF(consts);
+
+  for(uint32_t i=0; i<n; i++) {
+    fe_pair_t r = mp_const(consts[i].s);
+    fe_pair_t k = consts[i].k;
+    double    d = lo_ulps(k.lo, r.lo);
+
+    hi_ok += fe_to_bits(k.hi) == fe_to_bits(r.hi);
+    lo_ok += fe_to_bits(k.lo) == fe_to_bits(r.lo);
+
+    // 'hi' must be correct & 'lo' faithful
+    if (fe_to_bits(k.hi) != fe_to_bits(r.hi) || d > 1) {
+      errors++;
+      printf("  %s: got {%a,%a} expected {%a,%a}\n", consts[i].s, k.hi, k.lo, r.hi, r.lo);
+    }
+
+    if (d > lo_max) lo_max = d;
+  }
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nFE_CONST (C, %s)\n" SGR_RESET,
+#if defined(__GNUC__) && !defined(__clang__) && defined(__SIZEOF_FLOAT128__)
+         "__float128"
+#else
+         "long double"
+#endif
+         );
+
+  printf("  constants: %u, correct hi: %lu, correct lo: %lu, max lo error: %f ulp\n",
+         n, (unsigned long)hi_ok, (unsigned long)lo_ok, lo_max);
+
+  printf("\nerrors: %lu\n", (unsigned long)errors);
+
+  return errors != 0;
+}
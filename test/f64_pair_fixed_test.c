@@ -0,0 +1,244 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Correctness (vs. MPFR) & rough throughput of the Qm.n fixed-point
+// conversions in f64_pair.h. Timings are single measurements & only
+// meant to show relative costs.
+
+#include "common.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define TRIALS_Q  0x40000
+#define BENCH_LEN 0x100000
+#define REPS      8
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static mpfr_t mp_x, mp_r, mp_c, mp_min, mp_max;
+
+double sink;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+static void mp_set_u128(mpfr_t r, unsigned __int128 x)
+{
+  mpfr_set_d(r, 0.0, MPFR_RNDN);
+
+  for(int i=3; i>=0; i--) {
+    mpfr_mul_2si(r, r, 32, MPFR_RNDN);
+    mpfr_add_d  (r, r, (double)(uint32_t)(x >> (32*i)), MPFR_RNDN);
+  }
+}
+
+static void mp_set_i128(mpfr_t r, __int128 x)
+{
+  mp_set_u128(r, (x < 0) ? -(unsigned __int128)x : (unsigned __int128)x);
+
+  if (x < 0) mpfr_neg(r, r, MPFR_RNDN);
+}
+
+static inline fe_pair_t prng_fe_sign(fe_pair_t x)
+{
+  return (prng_u32() & 1) ? fe_neg(x) : x;
+}
+
+// signed with 0 to 127 significant bits
+static __int128 prng_i128(void)
+{
+  unsigned __int128 x = ((unsigned __int128)prng_u64() << 64) | prng_u64();
+  uint32_t          k = prng_u32() % 128;
+  __int128          s = (k == 0) ? 0 : (__int128)(x >> (128-k));
+
+  return (prng_u32() & 1) ? -s : s;
+}
+
+// 'c' vs. 'mp_r' correctly rounded to a pair
+static uint64_t pair_check(fe_pair_t c)
+{
+  double h = mpfr_get_d(mp_r, MPFR_RNDN);
+
+  mpfr_sub_d(mp_c, mp_r, h, MPFR_RNDN);
+
+  return (c.hi != h) || (c.lo != mpfr_get_d(mp_c, MPFR_RNDN));
+}
+
+static const int frac[] = { 0, 1, 32, 63, 64, 65, 96, 127 };
+
+// values for fe_to_q with 'f' fraction bits:
+//   0: ±[0,1)·2^k with k up to 2 past the top of the range
+//   1: ties: x·2^f is an integer plus 1/2
+//   2: edges of the range, infinities & NaN
+static fe_pair_t prng_fe_q(int c, int f)
+{
+  uint32_t u = prng_u32();
+
+  switch(c) {
+    case 0: return prng_fe_sign(fe_ldexp(prng_fe(), (int)(u % (uint32_t)(130-f+f/2)) - f/2));
+
+    case 1: {
+      fe_pair_t x = fe_from_i128(prng_i128() >> (u % 24));
+      return fe_ldexp(fe_add_d(fe_add(x,x), 1.0), -f-1);
+    }
+
+    default: {
+      static const fe_pair_t edge[] = {
+        {0x1.0p127,0}, {0x1.0p127,-1}, {0x1.0p127,-0.5}, {0x1.0p127,-0x1.0p-20}, {0x1.fffffffffffffp126,0x1.0p72},
+        {INFINITY,0}, {NAN,NAN}, {0,0}, {0.5,0}, {1.5,0}, {2.5,0},
+      };
+
+      return prng_fe_sign(fe_ldexp(edge[u % LENGTHOF(edge)], -f));
+    }
+  }
+}
+
+void q_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nQm.n conversions : failures/trials (f = fraction bits)\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_U64("f",3) },
+      { REPORT_TABLE_U64("from",10) },
+      { REPORT_TABLE_U64("round trip",10) },
+      { REPORT_TABLE_U64("to",10) },
+      { REPORT_TABLE_U64("to ties",10) },
+      { REPORT_TABLE_U64("to edges",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  // saturation bounds
+  mp_set_i128(mp_max, (__int128)(~(unsigned __int128)0 >> 1));
+  mpfr_neg(mp_min, mp_max, MPFR_RNDN);
+  mpfr_sub_d(mp_min, mp_min, 1.0, MPFR_RNDN);
+
+  for(size_t i=0; i<LENGTHOF(frac); i++) {
+    int      f = frac[i];
+    uint64_t fails[5] = {0};
+
+    for(int j=0; j<TRIALS_Q; j++) {
+      __int128 q = prng_i128();
+
+      mp_set_i128(mp_r, q);
+      mpfr_mul_2si(mp_r, mp_r, -f, MPFR_RNDN);
+      fails[0] += pair_check(fe_from_q(q,f));
+
+      if ((q < 0 ? -(unsigned __int128)q : (unsigned __int128)q) >> 106 == 0)
+        fails[1] += fe_to_q(fe_from_q(q,f),f) != q;
+
+      for(int c=0; c<3; c++) {
+        fe_pair_t x = prng_fe_q(c,f);
+        __int128  r = fe_to_q(x,f);
+
+        if (isnan(x.hi)) { fails[2+c] += r != -(__int128)(~(unsigned __int128)0 >> 1)-1; continue; }
+
+        mp_set(mp_x, x);
+        mpfr_mul_2si(mp_x, mp_x, f, MPFR_RNDN);
+        mpfr_rint(mp_r, mp_x, MPFR_RNDN);
+
+        if (mpfr_cmp(mp_r, mp_min) < 0) mpfr_set(mp_r, mp_min, MPFR_RNDN);
+        if (mpfr_cmp(mp_r, mp_max) > 0) mpfr_set(mp_r, mp_max, MPFR_RNDN);
+
+        mp_set_i128(mp_c, r);
+        fails[2+c] += mpfr_cmp(mp_c, mp_r) != 0;
+      }
+    }
+
+    report_table_row(stdout, &table, (uint64_t)f, fails[0], fails[1], fails[2], fails[3], fails[4], (uint64_t)TRIALS_Q);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+
+// MPFR baseline: Q64.64 to a correctly rounded pair
+static fe_pair_t mp_from_q64(__int128 x)
+{
+  mp_set_i128(mp_r, x);
+  mpfr_mul_2si(mp_r, mp_r, -64, MPFR_RNDN);
+
+  double h = mpfr_get_d(mp_r, MPFR_RNDN);
+
+  mpfr_sub_d(mp_c, mp_r, h, MPFR_RNDN);
+
+  return fe_pair(h, mpfr_get_d(mp_c, MPFR_RNDN));
+}
+
+void bench(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nQ64.64 throughput: n=%d\n" SGR_RESET, BENCH_LEN);
+
+  __int128*  q = malloc(BENCH_LEN*sizeof(__int128));
+  __int128*  b = malloc(BENCH_LEN*sizeof(__int128));
+  fe_pair_t* x = malloc(BENCH_LEN*sizeof(fe_pair_t));
+
+  if (!q || !b || !x) { printf("  allocation failed\n"); goto done; }
+
+  for(int i=0; i<BENCH_LEN; i++) q[i] = prng_i128() >> 1;
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",16), .just=report_table_justify_left },
+      { REPORT_TABLE_F("ns/elem",4,3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  double t0, t1;
+
+  t0 = timer_ns();
+  for(int r=0; r<REPS; r++) fe_from_q_batch(q, BENCH_LEN, x, 64);
+  t1 = timer_ns();
+  report_table_row(stdout, &table, "fe_from_q_batch", (t1-t0)/(REPS*(double)BENCH_LEN));
+
+  t0 = timer_ns();
+  for(int r=0; r<REPS; r++) fe_to_q_batch(x, BENCH_LEN, b, 64);
+  t1 = timer_ns();
+  report_table_row(stdout, &table, "fe_to_q_batch", (t1-t0)/(REPS*(double)BENCH_LEN));
+
+  t0 = timer_ns();
+  for(int i=0; i<BENCH_LEN; i++) sink += mp_from_q64(q[i]).lo;
+  t1 = timer_ns();
+  report_table_row(stdout, &table, "MPFR from", (t1-t0)/(double)BENCH_LEN);
+
+  report_table_end(stdout, &table);
+
+  uint64_t e = 0;
+
+  for(int i=0; i<BENCH_LEN; i++) e += (b[i] != q[i]) && ((q[i] < 0 ? -(unsigned __int128)q[i] : (unsigned __int128)q[i]) >> 106 == 0);
+
+  printf("  round trip mismatches (|x| < 2^106): %lu\n", e);
+
+ done:
+  free(q); free(b); free(x);
+}
+
+int main(void)
+{
+  mpfr_init2(mp_e,   128);
+  mpfr_init2(mp_t,   128);
+  mpfr_init2(mp_x,   320);
+  mpfr_init2(mp_r,   320);
+  mpfr_init2(mp_c,   320);
+  mpfr_init2(mp_min, 320);
+  mpfr_init2(mp_max, 320);
+
+  q_tests();
+  bench();
+
+  return 0;
+}
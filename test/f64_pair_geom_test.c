@@ -0,0 +1,778 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Sign correctness (vs. MPFR), escalation rates and throughput of the
+// geometric predicates in f64_pair_geom.h on random and (nearly)
+// degenerate point sets. Then errors (vs. MPFR) and throughput of the
+// vector/matrix routines vs. plain double. Timings are single
+// measurements.
+
+#include "common.h"
+#include "../f64_pair_geom.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define MP_PREC  1024
+#define NPTS     1024
+#define NQUERY   200000
+#define NVERIFY  20000
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+static inline int sgn(double x) { return (x > 0) - (x < 0); }
+
+//**********************************************************
+// plain double versions (the stage 1 expressions)
+
+static int naive_orient2d(const double* a, const double* b, const double* c)
+{
+  return sgn((a[0]-c[0])*(b[1]-c[1]) - (a[1]-c[1])*(b[0]-c[0]));
+}
+
+static int naive_orient3d(const double* a, const double* b, const double* c, const double* d)
+{
+  double adx = a[0]-d[0], ady = a[1]-d[1], adz = a[2]-d[2];
+  double bdx = b[0]-d[0], bdy = b[1]-d[1], bdz = b[2]-d[2];
+  double cdx = c[0]-d[0], cdy = c[1]-d[1], cdz = c[2]-d[2];
+
+  return sgn(adz*(bdx*cdy-cdx*bdy) + bdz*(cdx*ady-adx*cdy) + cdz*(adx*bdy-bdx*ady));
+}
+
+static int naive_incircle(const double* a, const double* b, const double* c, const double* d)
+{
+  double adx = a[0]-d[0], ady = a[1]-d[1];
+  double bdx = b[0]-d[0], bdy = b[1]-d[1];
+  double cdx = c[0]-d[0], cdy = c[1]-d[1];
+
+  return sgn((adx*adx+ady*ady)*(bdx*cdy-cdx*bdy)
+           + (bdx*bdx+bdy*bdy)*(cdx*ady-adx*cdy)
+           + (cdx*cdx+cdy*cdy)*(adx*bdy-bdx*ady));
+}
+
+static double naive_det3(const double* p, const double* q, const double* r)
+{
+  return p[2]*(q[0]*r[1]-r[0]*q[1]) + q[2]*(r[0]*p[1]-p[0]*r[1]) + r[2]*(p[0]*q[1]-q[0]*p[1]);
+}
+
+static int naive_insphere(const double* a, const double* b, const double* c, const double* d, const double* e)
+{
+  double x[4][3];
+  double l[4];
+  const double* p[4] = {a,b,c,d};
+
+  for(int i=0; i<4; i++) {
+    for(int j=0; j<3; j++) x[i][j] = p[i][j]-e[j];
+    l[i] = x[i][0]*x[i][0] + x[i][1]*x[i][1] + x[i][2]*x[i][2];
+  }
+
+  return sgn(-l[0]*naive_det3(x[1],x[2],x[3]) + l[1]*naive_det3(x[2],x[3],x[0])
+             -l[2]*naive_det3(x[3],x[0],x[1]) + l[3]*naive_det3(x[0],x[1],x[2]));
+}
+
+
+//**********************************************************
+// MPFR reference: same expressions on the exact differences
+
+mpfr_t mp_x[5][3];
+mpfr_t mp_l[4];
+mpfr_t mp_d;
+
+static void mp_init(void)
+{
+  for(int i=0; i<5; i++)
+    for(int j=0; j<3; j++) mpfr_init2(mp_x[i][j], MP_PREC);
+
+  for(int i=0; i<4; i++) mpfr_init2(mp_l[i], MP_PREC);
+
+  mpfr_init2(mp_d, MP_PREC);
+}
+
+// mp_x[i] = p[i]-o
+static void mp_diffs(const double** p, int n, const double* o, int dim)
+{
+  for(int i=0; i<n; i++)
+    for(int j=0; j<dim; j++) {
+      mpfr_set_d(mp_x[i][j], p[i][j], MPFR_RNDN);
+      mpfr_sub_d(mp_x[i][j], mp_x[i][j], o[j], MPFR_RNDN);
+    }
+}
+
+// r = ad-bc
+static void mp_det2(mpfr_t r, mpfr_t a, mpfr_t b, mpfr_t c, mpfr_t d)
+{
+  mpfr_mul(mp_e, a, d, MPFR_RNDN);
+  mpfr_mul(mp_t, b, c, MPFR_RNDN);
+  mpfr_sub(r, mp_e, mp_t, MPFR_RNDN);
+}
+
+// r = det of rows mp_x[p], mp_x[q], mp_x[r] (r can't be mp_e/mp_t)
+static void mp_det3(mpfr_t res, int p, int q, int r)
+{
+  mpfr_t m;
+  mpfr_init2(m, MP_PREC);
+
+  mpfr_set_d(res, 0, MPFR_RNDN);
+
+  int o[3][3] = {{p,q,r},{q,r,p},{r,p,q}};
+
+  for(int i=0; i<3; i++) {
+    mp_det2(m, mp_x[o[i][1]][0], mp_x[o[i][2]][0], mp_x[o[i][1]][1], mp_x[o[i][2]][1]);
+    mpfr_mul(m, m, mp_x[o[i][0]][2], MPFR_RNDN);
+    mpfr_add(res, res, m, MPFR_RNDN);
+  }
+
+  mpfr_clear(m);
+}
+
+static void mp_lift(mpfr_t r, int i, int dim)
+{
+  mpfr_set_d(r, 0, MPFR_RNDN);
+
+  for(int j=0; j<dim; j++) {
+    mpfr_mul(mp_e, mp_x[i][j], mp_x[i][j], MPFR_RNDN);
+    mpfr_add(r, r, mp_e, MPFR_RNDN);
+  }
+}
+
+static int mp_orient2d(const double* a, const double* b, const double* c)
+{
+  const double* p[2] = {a,b};
+  mp_diffs(p,2,c,2);
+  mp_det2(mp_d, mp_x[0][0], mp_x[0][1], mp_x[1][0], mp_x[1][1]);
+  return mpfr_sgn(mp_d);
+}
+
+static int mp_orient3d(const double* a, const double* b, const double* c, const double* d)
+{
+  const double* p[3] = {a,b,c};
+  mp_diffs(p,3,d,3);
+  mp_det3(mp_d,0,1,2);
+  return mpfr_sgn(mp_d);
+}
+
+static int mp_incircle(const double* a, const double* b, const double* c, const double* d)
+{
+  const double* p[3] = {a,b,c};
+  mp_diffs(p,3,d,2);
+
+  // put the lifts in the z column & reuse det3
+  for(int i=0; i<3; i++) mp_lift(mp_x[i][2], i, 2);
+
+  mp_det3(mp_d,0,1,2);
+  return mpfr_sgn(mp_d);
+}
+
+static int mp_insphere(const double* a, const double* b, const double* c, const double* d, const double* e)
+{
+  const double* p[4] = {a,b,c,d};
+  mp_diffs(p,4,e,3);
+
+  mpfr_t m;
+  mpfr_init2(m, MP_PREC);
+  mpfr_set_d(mp_d, 0, MPFR_RNDN);
+
+  for(int i=0; i<4; i++) {
+    mp_lift(mp_l[i], i, 3);
+    mp_det3(m, (i+1)&3, (i+2)&3, (i+3)&3);
+    mpfr_mul(m, m, mp_l[i], MPFR_RNDN);
+    if (i & 1) mpfr_add(mp_d, mp_d, m, MPFR_RNDN);
+    else       mpfr_sub(mp_d, mp_d, m, MPFR_RNDN);
+  }
+
+  mpfr_clear(m);
+
+  return mpfr_sgn(mp_d);
+}
+
+
+//**********************************************************
+// point sets
+
+enum { PRED_O2, PRED_O3, PRED_IC, PRED_IS };
+
+static const int pred_dim[]  = { 2, 3, 2, 3 };
+static const int pred_args[] = { 3, 4, 4, 5 };
+
+static const char* pred_name[] = { "orient2d", "orient3d", "incircle", "insphere" };
+
+double   pts[NPTS*3];
+uint32_t idx[NQUERY*5];
+int8_t   res[NQUERY];
+int8_t   nres[NQUERY];
+
+static inline double urand(void) { return prng_f64(); }
+
+// random on [0,1)^dim
+static void gen_random(int dim)
+{
+  for(int i=0; i<NPTS*dim; i++) pts[i] = urand();
+}
+
+// rounded points on a random line (2D) or plane (3D)
+static void gen_flat(int dim)
+{
+  double o[3], u[3], v[3];
+
+  for(int j=0; j<3; j++) { o[j] = urand(); u[j] = urand()-0.5; v[j] = urand()-0.5; }
+
+  for(int i=0; i<NPTS; i++) {
+    double s = 4*urand()-2, t = 4*urand()-2;
+    for(int j=0; j<dim; j++)
+      pts[i*dim+j] = o[j] + s*u[j] + (dim == 3 ? t*v[j] : 0);
+  }
+}
+
+// rounded points on a circle/sphere (center (0.3,0.7,0.2), radius 1.5)
+static void gen_round(int dim)
+{
+  static const double c[3] = {0.3, 0.7, 0.2};
+
+  for(int i=0; i<NPTS; i++) {
+    double x[3], n = 0;
+
+    for(int j=0; j<dim; j++) { x[j] = 2*urand()-1; n += x[j]*x[j]; }
+
+    n = 1.5/sqrt(n);
+
+    for(int j=0; j<dim; j++) pts[i*dim+j] = c[j] + n*x[j];
+  }
+}
+
+// small integer coordinates: exactly degenerate configurations.
+// 2D: 4x4 grid for orients, points on x²+y²=25 for incircle
+// 3D: 3x3x3 grid for orient3d, points on x²+y²+z²=9 for insphere
+static void gen_int(int pred)
+{
+  static const int c2[12][2] = {{5,0},{-5,0},{0,5},{0,-5},{3,4},{3,-4},{-3,4},{-3,-4},{4,3},{4,-3},{-4,3},{-4,-3}};
+
+  int dim = pred_dim[pred];
+
+  for(int i=0; i<NPTS; i++) {
+    double* p = pts+i*dim;
+
+    switch(pred) {
+      case PRED_O2: p[0] = i&3; p[1] = (i>>2)&3; break;
+      case PRED_O3: p[0] = i%3; p[1] = (i/3)%3; p[2] = (i/9)%3; break;
+      case PRED_IC: p[0] = 7+c2[i%12][0]; p[1] = -3+c2[i%12][1]; break;
+      default: {
+        // perms & signs of (1,2,2) and (3,0,0)
+        int k = i%30;
+        if (k < 6) {
+          p[0] = p[1] = p[2] = 0;
+          p[k>>1] = (k&1) ? -3 : 3;
+        } else {
+          k -= 6;
+          int o = k/8;
+          p[o]       = (k&1) ? -1 : 1;
+          p[(o+1)%3] = (k&2) ? -2 : 2;
+          p[(o+2)%3] = (k&4) ? -2 : 2;
+        }
+        p[0] += 5; p[1] -= 1; p[2] += 2;
+      }
+    }
+  }
+}
+
+// orient2d(p, q, r) with p on a 256x256 ulp grid at (0.5,0.5) and q,r
+// = (12,12),(24,24) (Kettner et al. "Classroom examples of robustness
+// problems in geometric computations")
+static void gen_ulp(void)
+{
+  for(int i=0; i<NPTS-2; i++) {
+    pts[2*i  ] = 0.5 + (prng_u32() & 255)*0x1.0p-53;
+    pts[2*i+1] = 0.5 + (prng_u32() & 255)*0x1.0p-53;
+  }
+
+  pts[2*(NPTS-2)] = 12; pts[2*(NPTS-2)+1] = 12;
+  pts[2*(NPTS-1)] = 24; pts[2*(NPTS-1)+1] = 24;
+}
+
+static void gen_queries(int pred, int ulp)
+{
+  int k = pred_args[pred];
+
+  for(int i=0; i<NQUERY; i++) {
+    for(int j=0; j<k; j++)
+      idx[i*k+j] = prng_u32() % (uint32_t)(ulp ? NPTS-2 : NPTS);
+
+    if (ulp) { idx[i*k+1] = NPTS-2; idx[i*k+2] = NPTS-1; }
+  }
+}
+
+#define P(J) (pts + (uint32_t)pred_dim[pred]*q[J])
+
+static int eval_naive(int pred, const uint32_t* q)
+{
+  switch(pred) {
+    case PRED_O2: return naive_orient2d(P(0),P(1),P(2));
+    case PRED_O3: return naive_orient3d(P(0),P(1),P(2),P(3));
+    case PRED_IC: return naive_incircle(P(0),P(1),P(2),P(3));
+    default:      return naive_insphere(P(0),P(1),P(2),P(3),P(4));
+  }
+}
+
+static int eval_mp(int pred, const uint32_t* q)
+{
+  switch(pred) {
+    case PRED_O2: return mp_orient2d(P(0),P(1),P(2));
+    case PRED_O3: return mp_orient3d(P(0),P(1),P(2),P(3));
+    case PRED_IC: return mp_incircle(P(0),P(1),P(2),P(3));
+    default:      return mp_insphere(P(0),P(1),P(2),P(3),P(4));
+  }
+}
+
+#undef P
+
+static void run_batch(int pred, uint64_t* stats)
+{
+  switch(pred) {
+    case PRED_O2: fe_orient2d_batch(pts, idx, NQUERY, res, stats); break;
+    case PRED_O3: fe_orient3d_batch(pts, idx, NQUERY, res, stats); break;
+    case PRED_IC: fe_incircle_batch(pts, idx, NQUERY, res, stats); break;
+    default:      fe_insphere_batch(pts, idx, NQUERY, res, stats); break;
+  }
+}
+
+
+//**********************************************************
+
+enum { DATA_RANDOM, DATA_FLAT, DATA_ROUND, DATA_INT, DATA_ULP };
+
+static const char* data_name[] = { "random", "flat", "round", "integer", "ulp grid" };
+
+uint64_t predicate_tests(void)
+{
+  uint64_t errors = 0;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255)
+         "\npredicates: %d queries (%d verified vs. MPFR), decided by stage in %%\n" SGR_RESET,
+         NQUERY, NVERIFY);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("predicate",8), .just=report_table_justify_left },
+      { REPORT_TABLE_STR("data",8),      .just=report_table_justify_left },
+      { REPORT_TABLE_F("filter",3,2) },
+      { REPORT_TABLE_F("pair",3,2) },
+      { REPORT_TABLE_F("exact",3,2) },
+      { REPORT_TABLE_U64("zero",6) },
+      { REPORT_TABLE_U64("naive wrong",6) },
+      { REPORT_TABLE_U64("errors",3) },
+      { REPORT_TABLE_F("Mq/s",3,2) },
+      { REPORT_TABLE_F("naive Mq/s",3,2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int pred=0; pred<4; pred++) {
+    int dim = pred_dim[pred];
+    int k   = pred_args[pred];
+
+    for(int data=0; data<5; data++) {
+      // the ulp grid is an orient2d set & 'flat' is for the orients
+      // and 'round' for incircle/insphere
+      if (data == DATA_ULP   && pred != PRED_O2) continue;
+      if (data == DATA_FLAT  && (pred == PRED_IC || pred == PRED_IS)) continue;
+      if (data == DATA_ROUND && (pred == PRED_O2 || pred == PRED_O3)) continue;
+
+      switch(data) {
+        case DATA_RANDOM: gen_random(dim); break;
+        case DATA_FLAT:   gen_flat(dim);   break;
+        case DATA_ROUND:  gen_round(dim);  break;
+        case DATA_INT:    gen_int(pred);   break;
+        default:          gen_ulp();       break;
+      }
+
+      gen_queries(pred, data == DATA_ULP);
+
+      uint64_t stats[FE_GEOM_STAGES] = {0};
+
+      double t0 = timer_ns();
+      run_batch(pred, stats);
+      double t1 = timer_ns();
+
+      for(int i=0; i<NQUERY; i++) nres[i] = (int8_t)eval_naive(pred, idx+i*k);
+      double t2 = timer_ns();
+
+      uint64_t err = 0, wrong = 0, zero = 0;
+
+      for(int i=0; i<NQUERY; i++) zero += res[i] == 0;
+
+      for(int i=0; i<NVERIFY; i++) {
+        int r = eval_mp(pred, idx+i*k);
+        err   += res[i] != r;
+        wrong += nres[i] != r;
+      }
+
+      // single query forms must agree with the batch
+      for(int i=0; i<NVERIFY; i++) {
+        const uint32_t* q = idx+i*k;
+        const double*   p = pts;
+        int r;
+
+        switch(pred) {
+          case PRED_O2: r = fe_orient2d(p+2*q[0],p+2*q[1],p+2*q[2]); break;
+          case PRED_O3: r = fe_orient3d(p+3*q[0],p+3*q[1],p+3*q[2],p+3*q[3]); break;
+          case PRED_IC: r = fe_incircle(p+2*q[0],p+2*q[1],p+2*q[2],p+2*q[3]); break;
+          default:      r = fe_insphere(p+3*q[0],p+3*q[1],p+3*q[2],p+3*q[3],p+3*q[4]); break;
+        }
+
+        err += res[i] != r;
+      }
+
+      errors += err;
+
+      double n = (double)NQUERY;
+
+      report_table_row(stdout, &table, pred_name[pred], data_name[data],
+                       100.0*(double)stats[0]/n, 100.0*(double)stats[1]/n, 100.0*(double)stats[2]/n,
+                       zero, wrong, err, 1e3*n/(t1-t0), 1e3*n/(t2-t1));
+    }
+  }
+
+  report_table_end(stdout, &table);
+
+  return errors;
+}
+
+
+//**********************************************************
+// vec3/mat3
+
+#define NVEC 65536
+
+double vx[NVEC], vy[NVEC], vz[NVEC];
+double wx[NVEC], wy[NVEC], wz[NVEC];
+double ox[NVEC], oy[NVEC], oz[NVEC];
+
+// |a-e|/|e| (or |a-e| if 'e' is zero) with 'e' in mp_d
+static double mp_rel(fe_pair_t a)
+{
+  mpfr_set_d(mp_e, a.hi, MPFR_RNDN);
+  mpfr_add_d(mp_e, mp_e, a.lo, MPFR_RNDN);
+  mpfr_sub(mp_e, mp_e, mp_d, MPFR_RNDN);
+
+  if (!mpfr_zero_p(mp_d))
+    mpfr_div(mp_e, mp_e, mp_d, MPFR_RNDN);
+
+  return fabs(mpfr_get_d(mp_e, MPFR_RNDN));
+}
+
+// mp_d = ab-cd
+static void mp_fd2(double a, double b, double c, double d)
+{
+  mpfr_set_d(mp_x[0][0], a, MPFR_RNDN); mpfr_mul_d(mp_x[0][0], mp_x[0][0], b, MPFR_RNDN);
+  mpfr_set_d(mp_x[0][1], c, MPFR_RNDN); mpfr_mul_d(mp_x[0][1], mp_x[0][1], d, MPFR_RNDN);
+  mpfr_sub(mp_d, mp_x[0][0], mp_x[0][1], MPFR_RNDN);
+}
+
+// mp_d = det of rows 'm' (exact)
+static void mp_mat3_det(const double* m)
+{
+  for(int i=0; i<3; i++)
+    for(int j=0; j<3; j++) mpfr_set_d(mp_x[i][j], m[3*i+j], MPFR_RNDN);
+
+  mp_det3(mp_d, 0,1,2);
+}
+
+// random on [-1,1) with exponents down to 2^-e
+static inline double rand_scaled(int e)
+{
+  return ldexp(2*urand()-1, -(int)(prng_u32() % (uint32_t)(e+1)));
+}
+
+static double naive_det(const double* m)
+{
+  return naive_det3(m+3,m+6,m) ;
+}
+
+typedef struct {
+  const char* name;
+  double      err[2];     // max error: double, pair
+  double      t[2];       // ns per op: double, pair
+} vec_result_t;
+
+uint64_t vec3_tests(void)
+{
+  uint64_t     errors = 0;
+  vec_result_t res[6];
+  int          rn = 0;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255)
+         "\nvec3/mat3: max errors (vs. MPFR) over %d samples\n" SGR_RESET, NVEC);
+
+  // nearly parallel vectors: b = a(1+small)
+  for(int i=0; i<NVEC; i++) {
+    vx[i] = rand_scaled(8); vy[i] = rand_scaled(8); vz[i] = rand_scaled(8);
+    wx[i] = vx[i]*(1+rand_scaled(20)*0x1.0p-30);
+    wy[i] = vy[i]*(1+rand_scaled(20)*0x1.0p-30);
+    wz[i] = vz[i]*(1+rand_scaled(20)*0x1.0p-30);
+  }
+
+  // cross products
+  {
+    vec_result_t* r = res+rn++; *r = (vec_result_t){.name="cross (f64 out)"};
+    vec_result_t* q = res+rn++; *q = (vec_result_t){.name="cross (pair out)"};
+
+    double t0 = timer_ns();
+    for(int i=0; i<NVEC; i++) {
+      ox[i] = vy[i]*wz[i]-vz[i]*wy[i];
+      oy[i] = vz[i]*wx[i]-vx[i]*wz[i];
+      oz[i] = vx[i]*wy[i]-vy[i]*wx[i];
+    }
+    double t1 = timer_ns();
+
+    for(int i=0; i<NVEC; i++) {
+      double a[3] = {vx[i],vy[i],vz[i]}, b[3] = {wx[i],wy[i],wz[i]}, c[3];
+      fe_vec3_cross_f64(c,a,b);
+      fe_vec3_t e = fe_vec3_cross_d(a,b);
+      double cd[3] = {ox[i],oy[i],oz[i]};
+      fe_pair_t ep[3] = {e.x,e.y,e.z};
+
+      for(int j=0; j<3; j++) {
+        int u = (j+1)%3, v = (j+2)%3;
+        mp_fd2(a[u],b[v],a[v],b[u]);
+
+        double ra = mp_rel(fe_set_d(cd[j]));
+        double rb = mp_rel(fe_set_d(c[j]));
+        double rc = mp_rel(ep[j]);
+
+        if (ra > r->err[0]) r->err[0] = ra;
+        if (rb > r->err[1]) r->err[1] = rb;
+        if (rc > q->err[1]) q->err[1] = rc;
+
+        // must be correctly rounded
+        errors += fe_to_bits(c[j]) != fe_to_bits(mpfr_get_d(mp_d, MPFR_RNDN));
+      }
+    }
+
+    double t2 = timer_ns();
+    for(int i=0; i<NVEC; i++) {
+      double a[3] = {vx[i],vy[i],vz[i]}, b[3] = {wx[i],wy[i],wz[i]}, c[3];
+      fe_vec3_cross_f64(c,a,b);
+      ox[i] = c[0]; oy[i] = c[1]; oz[i] = c[2];
+    }
+    double t3 = timer_ns();
+
+    q->err[0] = r->err[0];
+    r->t[0] = q->t[0] = (t1-t0)/NVEC;
+    r->t[1] = q->t[1] = (t3-t2)/NVEC;
+  }
+
+  // normalize: absolute error of the components (the result is unit)
+  {
+    vec_result_t* r = res+rn++; *r = (vec_result_t){.name="normalize SoA"};
+
+    for(int i=0; i<NVEC; i++) {
+      vx[i] = rand_scaled(30); vy[i] = rand_scaled(30); vz[i] = rand_scaled(30);
+    }
+
+    double t0 = timer_ns();
+    for(int i=0; i<NVEC; i++) {
+      double s = 1.0/sqrt(vx[i]*vx[i]+vy[i]*vy[i]+vz[i]*vz[i]);
+      wx[i] = s*vx[i]; wy[i] = s*vy[i]; wz[i] = s*vz[i];
+    }
+    double t1 = timer_ns();
+    fe_vec3_normalize_soa(NVEC, vx,vy,vz, ox,oy,oz);
+    double t2 = timer_ns();
+
+    mpfr_t n;
+    mpfr_init2(n, MP_PREC);
+
+    for(int i=0; i<NVEC; i++) {
+      double p[3] = {vx[i],vy[i],vz[i]};
+      double a[3] = {wx[i],wy[i],wz[i]};
+      double b[3] = {ox[i],oy[i],oz[i]};
+
+      mpfr_set_d(n, 0, MPFR_RNDN);
+      for(int j=0; j<3; j++) {
+        mpfr_set_d(mp_t, p[j], MPFR_RNDN);
+        mpfr_mul(mp_t, mp_t, mp_t, MPFR_RNDN);
+        mpfr_add(n, n, mp_t, MPFR_RNDN);
+      }
+      mpfr_rec_sqrt(n, n, MPFR_RNDN);
+
+      for(int j=0; j<3; j++) {
+        mpfr_mul_d(mp_d, n, p[j], MPFR_RNDN);
+        mpfr_set_d(mp_e, a[j], MPFR_RNDN); mpfr_sub(mp_e, mp_e, mp_d, MPFR_RNDN);
+        double ea = fabs(mpfr_get_d(mp_e, MPFR_RNDN));
+        mpfr_set_d(mp_e, b[j], MPFR_RNDN); mpfr_sub(mp_e, mp_e, mp_d, MPFR_RNDN);
+        double eb = fabs(mpfr_get_d(mp_e, MPFR_RNDN));
+        if (ea > r->err[0]) r->err[0] = ea;
+        if (eb > r->err[1]) r->err[1] = eb;
+      }
+    }
+
+    mpfr_clear(n);
+
+    r->t[0] = (t1-t0)/NVEC;
+    r->t[1] = (t2-t1)/NVEC;
+  }
+
+  // transform: rotation-like matrix, translation & points far from the
+  // origin so the results cancel
+  {
+    vec_result_t* r = res+rn++; *r = (vec_result_t){.name="transform SoA"};
+
+    double m[9], t[3];
+
+    for(int j=0; j<9; j++) m[j] = 2*urand()-1;
+    for(int j=0; j<3; j++) t[j] = 0;
+
+    double c[3] = {1e6*urand(), 1e6*urand(), 1e6*urand()};
+
+    // translation that maps 'c' close to the origin
+    for(int k=0; k<3; k++) t[k] = -(m[3*k]*c[0] + m[3*k+1]*c[1] + m[3*k+2]*c[2]);
+
+    for(int i=0; i<NVEC; i++) {
+      vx[i] = c[0] + 2*urand()-1; vy[i] = c[1] + 2*urand()-1; vz[i] = c[2] + 2*urand()-1;
+    }
+
+    fe_mat3_t fm = fe_mat3_load_d(m);
+    fe_vec3_t ft = fe_vec3_load_d(t);
+
+    double t0 = timer_ns();
+    for(int i=0; i<NVEC; i++) {
+      double px = vx[i], py = vy[i], pz = vz[i];
+      wx[i] = m[0]*px + m[1]*py + m[2]*pz + t[0];
+      wy[i] = m[3]*px + m[4]*py + m[5]*pz + t[1];
+      wz[i] = m[6]*px + m[7]*py + m[8]*pz + t[2];
+    }
+    double t1 = timer_ns();
+    fe_mat3_transform_soa(&fm, &ft, NVEC, vx,vy,vz, ox,oy,oz);
+    double t2 = timer_ns();
+
+    for(int i=0; i<NVEC; i++) {
+      double p[3] = {vx[i],vy[i],vz[i]};
+      double a[3] = {wx[i],wy[i],wz[i]};
+      double b[3] = {ox[i],oy[i],oz[i]};
+
+      for(int k=0; k<3; k++) {
+        mpfr_set_d(mp_d, t[k], MPFR_RNDN);
+        for(int j=0; j<3; j++) {
+          mpfr_set_d(mp_t, m[3*k+j], MPFR_RNDN);
+          mpfr_mul_d(mp_t, mp_t, p[j], MPFR_RNDN);
+          mpfr_add(mp_d, mp_d, mp_t, MPFR_RNDN);
+        }
+        double ea = mp_rel(fe_set_d(a[k]));
+        double eb = mp_rel(fe_set_d(b[k]));
+        if (ea > r->err[0]) r->err[0] = ea;
+        if (eb > r->err[1]) r->err[1] = eb;
+      }
+    }
+
+    r->t[0] = (t1-t0)/NVEC;
+    r->t[1] = (t2-t1)/NVEC;
+  }
+
+  // determinant & inverse of ill-conditioned matrices: third row is
+  // nearly a combination of the first two
+  {
+    vec_result_t* r = res+rn++; *r = (vec_result_t){.name="det"};
+    vec_result_t* q = res+rn++; *q = (vec_result_t){.name="inverse residual"};
+
+    for(int i=0; i<NVEC/16; i++) {
+      double m[9];
+
+      for(int j=0; j<6; j++) m[j] = 2*urand()-1;
+
+      double s = 2*urand()-1, u = 2*urand()-1;
+
+      for(int j=0; j<3; j++) m[6+j] = s*m[j] + u*m[3+j] + rand_scaled(4)*0x1.0p-30;
+
+      mp_mat3_det(m);
+
+      double    da = naive_det(m);
+      fe_mat3_t fm = fe_mat3_load_d(m);
+      fe_pair_t db = fe_mat3_det(fm);
+
+      double ea = mp_rel(fe_set_d(da));
+      double eb = mp_rel(db);
+
+      if (ea > r->err[0]) r->err[0] = ea;
+      if (eb > r->err[1]) r->err[1] = eb;
+
+      // residual max|mi - I| (computed in pair) with the double
+      // adjugate inverse and fe_mat3_inverse
+      double c[9];
+      double* c0 = c, *c1 = c+3, *c2 = c+6;
+      c0[0] = m[4]*m[8]-m[5]*m[7]; c0[1] = m[5]*m[6]-m[3]*m[8]; c0[2] = m[3]*m[7]-m[4]*m[6];
+      c1[0] = m[7]*m[2]-m[8]*m[1]; c1[1] = m[8]*m[0]-m[6]*m[2]; c1[2] = m[6]*m[1]-m[7]*m[0];
+      c2[0] = m[1]*m[5]-m[2]*m[4]; c2[1] = m[2]*m[3]-m[0]*m[5]; c2[2] = m[0]*m[4]-m[1]*m[3];
+
+      fe_mat3_t ia;
+
+      for(int k=0; k<3; k++) {
+        ia.r[k] = fe_vec3_d(c[k]/da, c[3+k]/da, c[6+k]/da);
+      }
+
+      fe_mat3_t ib;
+      fe_mat3_inverse(&ib, fm);
+
+      fe_mat3_t ra = fe_mat3_mul(fm, ia);
+      fe_mat3_t rb = fe_mat3_mul(fm, ib);
+
+      for(int k=0; k<3; k++) {
+        fe_pair_t a[3] = {ra.r[k].x, ra.r[k].y, ra.r[k].z};
+        fe_pair_t b[3] = {rb.r[k].x, rb.r[k].y, rb.r[k].z};
+
+        for(int j=0; j<3; j++) {
+          double ea = fabs(fe_result(fe_sub_d(a[j], (j==k) ? 1.0 : 0.0)));
+          double eb = fabs(fe_result(fe_sub_d(b[j], (j==k) ? 1.0 : 0.0)));
+          if (ea > q->err[0]) q->err[0] = ea;
+          if (eb > q->err[1]) q->err[1] = eb;
+        }
+      }
+    }
+  }
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("op",16), .just=report_table_justify_left },
+      { REPORT_TABLE_E("double err",3) },
+      { REPORT_TABLE_E("pair err",3) },
+      { REPORT_TABLE_F("double ns",3,2) },
+      { REPORT_TABLE_F("pair ns",3,2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int i=0; i<rn; i++)
+    report_table_row(stdout, &table, res[i].name, res[i].err[0], res[i].err[1], res[i].t[0], res[i].t[1]);
+
+  report_table_end(stdout, &table);
+
+  printf("  cross, transform & det: relative errors. normalize: absolute errors.\n"
+         "  inverse: max|MA-I|. times per element (0 = not timed)\n");
+
+  return errors;
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, MP_PREC);
+  mpfr_init2(mp_t, MP_PREC);
+  mp_init();
+
+  uint64_t errors = predicate_tests();
+
+  errors += vec3_tests();
+
+  printf("\nerrors: %lu\n", (unsigned long)errors);
+
+  return errors != 0;
+}
@@ -0,0 +1,698 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Accuracy (vs. MPFR) and rough timings of the routines in
+// f64_pair_linalg.h. Timings are single measurements & only meant to
+// show relative costs.
+
+#define FE_PAIR_PTHREADS
+
+#include "common.h"
+#include "../f64_pair_linalg.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define MAXN  256
+#define MP_PREC 320
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+//**********************************************************
+// problems: double A (row-major, ld=n) and b
+
+double a_d[MAXN*MAXN];
+double b_d[MAXN];
+
+fe_pair_t x_ref[MAXN];
+
+enum { PROB_RAND, PROB_GRADED, PROB_HILBERT, PROB_SPD };
+
+typedef struct {
+  int    type;
+  size_t n;
+  char*  name;
+} problem_t;
+
+problem_t problems[] =
+{
+  { PROB_RAND,    64, "random"  },
+  { PROB_RAND,   256, "random"  },
+  { PROB_GRADED,  64, "graded"  },
+  { PROB_HILBERT, 10, "hilbert" },
+  { PROB_HILBERT, 13, "hilbert" },
+  { PROB_SPD,    128, "spd"     },
+};
+
+void problem_init(problem_t* p)
+{
+  size_t n = p->n;
+
+  for(size_t i=0; i<n; i++) {
+    for(size_t j=0; j<n; j++) {
+      double v;
+
+      switch(p->type) {
+        case PROB_RAND:   v = 2.0*prng_f64()-1.0; break;
+        case PROB_GRADED: v = ldexp(2.0*prng_f64()-1.0, -(int)((40*j)/n)); break;
+        case PROB_SPD:    v = 2.0*prng_f64()-1.0; break;
+        default:          v = 1.0/(double)(i+j+1);
+      }
+      a_d[i*n+j] = v;
+    }
+    b_d[i] = 2.0*prng_f64()-1.0;
+  }
+
+  // MMᵀ with a graded diagonal (κ ~ 2^30): symmetric in double
+  if (p->type == PROB_SPD) {
+    static double m[MAXN*MAXN];
+    memcpy(m, a_d, n*n*sizeof(double));
+
+    for(size_t i=0; i<n; i++)
+      for(size_t j=0; j<=i; j++) {
+        double s = 0;
+        for(size_t k=0; k<n; k++) s += m[i*n+k]*m[j*n+k];
+        if (i == j) s += ldexp(1.0, -(int)((30*i)/n));
+        a_d[i*n+j] = a_d[j*n+i] = s/(double)n;
+      }
+  }
+}
+
+static inline int problem_spd(problem_t* p) { return p->type == PROB_SPD || p->type == PROB_HILBERT; }
+
+// augmented system [M|c] for the MPFR reference solves
+mpfr_t mp_m[MAXN][MAXN+1];
+
+void mp_m_init(void)
+{
+  for(size_t i=0; i<MAXN; i++)
+    for(size_t j=0; j<=MAXN; j++)
+      mpfr_init2(mp_m[i][j], MP_PREC);
+}
+
+// Gaussian elimination w/ partial pivoting in MPFR: x_ref = M^-1 c
+void mp_ge(size_t n)
+{
+  for(size_t k=0; k<n; k++) {
+    size_t p = k;
+
+    for(size_t i=k+1; i<n; i++)
+      if (mpfr_cmpabs(mp_m[i][k], mp_m[p][k]) > 0) p = i;
+
+    if (p != k)
+      for(size_t j=k; j<=n; j++) mpfr_swap(mp_m[p][j], mp_m[k][j]);
+
+    for(size_t i=k+1; i<n; i++) {
+      mpfr_div(mp_t, mp_m[i][k], mp_m[k][k], MPFR_RNDN);
+      for(size_t j=k+1; j<=n; j++) {
+        mpfr_mul(mp_e, mp_t, mp_m[k][j], MPFR_RNDN);
+        mpfr_sub(mp_m[i][j], mp_m[i][j], mp_e, MPFR_RNDN);
+      }
+    }
+  }
+
+  for(size_t i=n; i-- > 0;) {
+    for(size_t j=i+1; j<n; j++) {
+      mpfr_mul(mp_e, mp_m[i][j], mp_m[j][n], MPFR_RNDN);
+      mpfr_sub(mp_m[i][n], mp_m[i][n], mp_e, MPFR_RNDN);
+    }
+    mpfr_div(mp_m[i][n], mp_m[i][n], mp_m[i][i], MPFR_RNDN);
+    x_ref[i] = mp2fe(mp_m[i][n]);
+  }
+}
+
+// x_ref = A^-1 b
+void mp_solve(size_t n)
+{
+  for(size_t i=0; i<n; i++) {
+    for(size_t j=0; j<n; j++) mpfr_set_d(mp_m[i][j], a_d[i*n+j], MPFR_RNDN);
+    mpfr_set_d(mp_m[i][n], b_d[i], MPFR_RNDN);
+  }
+
+  mp_ge(n);
+}
+
+// |x-x_ref|∞/|x_ref|∞ as bits of accuracy
+double fwd_bits(const double* xh, const double* xl, size_t n)
+{
+  double e = 0, m = 0;
+
+  for(size_t i=0; i<n; i++) {
+    e = fmax(e, fabs(fe_sub(fe_pair(xh[i], xl ? xl[i] : 0), x_ref[i]).hi));
+    m = fmax(m, fabs(x_ref[i].hi));
+  }
+
+  if (e == 0) return 106;
+
+  return fmin(106, -log2(e/m));
+}
+
+
+//**********************************************************
+// iterative refinement vs. double & pair LU
+
+double    lu_d[MAXN*MAXN];
+double    xh[MAXN], xl[MAXN];
+uint32_t  piv[MAXN];
+
+void solve_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nsolve Ax=b: accuracy in bits (|x-x*|∞/|x*|∞), time in ms\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("problem",8), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("n",3) },
+      { REPORT_TABLE_F("lu_f64",3,1) },
+      { REPORT_TABLE_F("ir",3,1) },
+      { REPORT_TABLE_U64("steps",2) },
+      { REPORT_TABLE_STR("conv",3) },
+      { REPORT_TABLE_F("fe_lu",3,1) },
+      { REPORT_TABLE_F("fe_chol",3,1) },
+      { REPORT_TABLE_F("ms(f64)",4,3) },
+      { REPORT_TABLE_F("ms(ir)",4,3) },
+      { REPORT_TABLE_F("ms(lu)",4,3) },
+      { REPORT_TABLE_F("ms(chol)",4,3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  fe_mat_t a_fe  = fe_mat_alloc(MAXN, MAXN);
+  uint64_t upper = 0;
+
+  for(size_t pi=0; pi<LENGTHOF(problems); pi++) {
+    problem_t* p = problems+pi;
+    size_t     n = p->n;
+    double     t0,t1,t2,t3,t4,t5;
+
+    problem_init(p);
+    mp_solve(n);
+
+    // double LU
+    t0 = timer_ns();
+    memcpy(lu_d, a_d, n*n*sizeof(double));
+    fe_lu_factor_f64(lu_d, n, n, piv);
+    memcpy(xh, b_d, n*sizeof(double));
+    fe_lu_solve_f64(lu_d, n, n, piv, xh);
+    t1 = timer_ns();
+
+    double bits_d = fwd_bits(xh, NULL, n);
+
+    // iterative refinement
+    fe_refine_info_t info = {0};
+
+    t2 = timer_ns();
+    fe_solve_ir_f64(a_d, n, n, b_d, xh, xl, &info);
+    t3 = timer_ns();
+
+    double bits_ir = fwd_bits(xh, xl, n);
+
+    // pair LU
+    fe_mat_t a = fe_mat_view(a_fe, 0, 0, n, n);
+    a.ld = n;
+
+    t4 = timer_ns();
+    for(size_t i=0; i<n*n; i++) { a.hi[i] = a_d[i]; a.lo[i] = 0; }
+    fe_lu_factor(a, piv);
+    for(size_t i=0; i<n; i++) { xh[i] = b_d[i]; xl[i] = 0; }
+    fe_lu_solve(a, piv, xh, xl);
+    t5 = timer_ns();
+
+    double bits_fe = fwd_bits(xh, xl, n);
+
+    // pair Cholesky
+    double bits_ch = NAN, t6 = 0, t7 = 0;
+
+    if (problem_spd(p)) {
+      t6 = timer_ns();
+      for(size_t i=0; i<n*n; i++) { a.hi[i] = a_d[i]; a.lo[i] = 0; }
+      int r = fe_chol_factor(a);
+
+      // the strict upper triangle must be untouched
+      for(size_t i=0; i<n; i++)
+        for(size_t j=i+1; j<n; j++)
+          upper += (a.hi[i*n+j] != a_d[i*n+j]) || (a.lo[i*n+j] != 0);
+
+      for(size_t i=0; i<n; i++) { xh[i] = b_d[i]; xl[i] = 0; }
+      fe_chol_solve(a, xh, xl);
+      t7 = timer_ns();
+      bits_ch = r ? 0 : fwd_bits(xh, xl, n);
+    }
+
+    report_table_row(stdout, &table, p->name, (uint64_t)n, bits_d, bits_ir,
+                     (uint64_t)info.iterations, info.converged ? "yes" : "no", bits_fe, bits_ch,
+                     1e-6*(t1-t0), 1e-6*(t3-t2), 1e-6*(t5-t4), 1e-6*(t7-t6));
+  }
+
+  report_table_end(stdout, &table);
+
+  printf("  fe_chol_factor: strict upper triangle entries modified: %lu\n", (unsigned long)upper);
+
+  fe_mat_free(a_fe);
+}
+
+
+//**********************************************************
+// GEMM: accuracy vs. MPFR & throughput
+
+#define GEMM_N 48
+
+// error of C=sAB in u² |s|(|A||B|)ij for the backends & bitwise compare
+// of the threaded version. the data sets scale elements by 2^[-e,e] and
+// 's' isn't always a power of two (so it must be applied in pair precision)
+mpfr_t gemm_ref[GEMM_N*GEMM_N];
+double gemm_mag[GEMM_N*GEMM_N];
+
+double gemm_error(fe_mat_t c)
+{
+  double e = 0;
+
+  for(size_t i=0; i<GEMM_N*GEMM_N; i++) {
+    mp_set(mp_t, fe_pair(c.hi[i], c.lo[i]));
+    mpfr_sub(mp_t, mp_t, gemm_ref[i], MPFR_RNDN);
+
+    double d = fabs(mpfr_get_d(mp_t,MPFR_RNDN))*0x1.0p106/gemm_mag[i];
+
+    if (isnan(d)) return INFINITY;   // (fmax would drop it)
+
+    e = fmax(e, d);
+  }
+
+  return e;
+}
+
+static inline fe_pair_t prng_gemm_elem(int e)
+{
+  int x = e ? (int)(prng_u64() >> 33) % (2*e+1) - e : 0;
+  return fe_mul_pot(ldexp(1.0,x), fe_mul_d(prng_fe(), 2.0*prng_f64()-1.0));
+}
+
+void gemm_tests(void)
+{
+  // the last two scale A & B by 2^sa & 2^sb: the Ozaki scales would
+  // overflow and the slice products underflow (both fall back)
+  static const int    spread[] = { 0, 20, 60, 0,    0    };
+  static const int    sa[]     = { 0, 0,  0,  1000, -420 };
+  static const int    sb[]     = { 0, 0,  0, -1000, -420 };
+  static const double scale[]  = { 1.0, 3.0, -0.1 };
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nfe_gemm n=%d: error in u²(|A||B|)ij\n" SGR_RESET, GEMM_N);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("data",10), .just=report_table_justify_left },
+      { REPORT_TABLE_STR("s",5) },
+      { REPORT_TABLE_F("direct",3,3) },
+      { REPORT_TABLE_F("ozaki",3,3) },
+      { REPORT_TABLE_U64("mt diff",4) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  size_t   n = GEMM_N;
+  fe_mat_t a = fe_mat_alloc(n,n);
+  fe_mat_t b = fe_mat_alloc(n,n);
+  fe_mat_t c = fe_mat_alloc(n,n);
+  fe_mat_t d = fe_mat_alloc(n,n);
+
+  mpfr_t x,y;
+  mpfr_init2(x, MP_PREC); mpfr_init2(y, MP_PREC);
+
+  for(size_t i=0; i<n*n; i++) mpfr_init2(gemm_ref[i], MP_PREC);
+
+  for(size_t si=0; si<LENGTHOF(spread); si++) {
+    for(size_t i=0; i<n*n; i++) {
+      fe_pair_t u = fe_ldexp(prng_gemm_elem(spread[si]), sa[si]);
+      fe_pair_t v = fe_ldexp(prng_gemm_elem(spread[si]), sb[si]);
+      a.hi[i] = u.hi; a.lo[i] = u.lo;
+      b.hi[i] = v.hi; b.lo[i] = v.lo;
+    }
+
+    for(size_t sj=0; sj<LENGTHOF(scale); sj++) {
+      double s = scale[sj];
+
+      for(size_t i=0; i<n; i++) {
+        for(size_t j=0; j<n; j++) {
+          mpfr_t* r = gemm_ref+i*n+j;
+          double  m = 0;
+
+          mpfr_set_d(*r,0,MPFR_RNDN);
+
+          for(size_t k=0; k<n; k++) {
+            mp_set(x, fe_mat_get(a,i,k));
+            mp_set(y, fe_mat_get(b,k,j));
+            mpfr_mul(x,x,y,MPFR_RNDN);
+            mpfr_add(*r,*r,x,MPFR_RNDN);
+            m += fabs(a.hi[i*n+k]*b.hi[k*n+j]);
+          }
+          mpfr_mul_d(*r,*r,s,MPFR_RNDN);
+          gemm_mag[i*n+j] = fabs(s)*m;
+        }
+      }
+
+      char name[16], sname[16];
+      if      (sa[si] != sb[si]) sprintf(name, "A·2^%d",   sa[si]);
+      else if (sa[si] != 0)      sprintf(name, "A,B·2^%d", sa[si]);
+      else                       sprintf(name, "2^±%d",    spread[si]);
+      sprintf(sname, "%g", s);
+
+      memset(c.hi, 0, 2*n*n*sizeof(double));
+      memset(d.hi, 0, 2*n*n*sizeof(double));
+      fe_gemm_direct(c,a,b,s);
+      fe_gemm_mt(d,a,b,s,4);
+
+      uint64_t diff = (uint64_t)(memcmp(c.hi, d.hi, 2*n*n*sizeof(double)) != 0);
+      double   ed   = gemm_error(c);
+
+      memset(c.hi, 0, 2*n*n*sizeof(double));
+      fe_gemm_ozaki(c,a,b,s);
+
+      report_table_row(stdout, &table, name, sname, ed, gemm_error(c), diff);
+    }
+  }
+
+  report_table_end(stdout, &table);
+
+  for(size_t i=0; i<n*n; i++) mpfr_clear(gemm_ref[i]);
+  mpfr_clear(x); mpfr_clear(y);
+
+  fe_mat_free(a); fe_mat_free(b); fe_mat_free(c); fe_mat_free(d);
+
+  // backend throughput
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nfe_gemm backends: time in ms (square, random on [-1,1])\n" SGR_RESET);
+
+  report_table_t bt = {
+    .col = {
+      { REPORT_TABLE_U64("n",4) },
+      { REPORT_TABLE_F("direct",5,2) },
+      { REPORT_TABLE_F("ozaki",5,2) },
+      { REPORT_TABLE_F("speedup",3,2) },
+    }
+  };
+
+  report_table_header(stdout, &bt);
+
+  for(size_t sz=64; sz<=512; sz*=2) {
+    a = fe_mat_alloc(sz,sz);
+    b = fe_mat_alloc(sz,sz);
+    c = fe_mat_alloc(sz,sz);
+
+    for(size_t i=0; i<sz*sz; i++) {
+      fe_pair_t u = prng_gemm_elem(0), v = prng_gemm_elem(0);
+      a.hi[i] = u.hi; a.lo[i] = u.lo;
+      b.hi[i] = v.hi; b.lo[i] = v.lo;
+    }
+
+    double t0 = timer_ns();
+    fe_gemm_direct(c,a,b,1.0);
+    double t1 = timer_ns();
+    fe_gemm_ozaki(c,a,b,1.0);
+    double t2 = timer_ns();
+
+    report_table_row(stdout, &bt, (uint64_t)sz, 1e-6*(t1-t0), 1e-6*(t2-t1), (t1-t0)/(t2-t1));
+
+    fe_mat_free(a); fe_mat_free(b); fe_mat_free(c);
+  }
+
+  report_table_end(stdout, &bt);
+}
+
+// factorization throughput & thread scaling (bitwise compare to 1 thread)
+#define FACT_N 512
+
+void factor_bench(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nfactorization n=%d: time in ms\n" SGR_RESET, FACT_N);
+
+  size_t    n   = FACT_N;
+  fe_mat_t  a   = fe_mat_alloc(n,n);
+  fe_mat_t  r   = fe_mat_alloc(n,n);
+  fe_mat_t  g   = fe_mat_alloc(n,n);
+  uint32_t* p   = malloc(n*sizeof(uint32_t));
+  double*   ad  = malloc(n*n*sizeof(double));
+  uint32_t* pd  = malloc(n*sizeof(uint32_t));
+
+  for(size_t i=0; i<n*n; i++) { r.hi[i] = 2.0*prng_f64()-1.0; r.lo[i] = 0; }
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("routine",16), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("threads",3) },
+      { REPORT_TABLE_F("ms",5,2) },
+      { REPORT_TABLE_F("ns/madd",3,2) },
+      { REPORT_TABLE_STR("same",3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  double t0 = timer_ns();
+  memcpy(ad, r.hi, n*n*sizeof(double));
+  fe_lu_factor_f64(ad, n, n, pd);
+  double t1 = timer_ns();
+  double mn = (double)n*(double)n*(double)n/3.0;
+
+  report_table_row(stdout, &table, "fe_lu_factor_f64", (uint64_t)1, 1e-6*(t1-t0), (t1-t0)/mn, "-");
+
+  fe_mat_t ref = fe_mat_alloc(n,n);
+
+  for(uint32_t t=1; t<=4; t*=2) {
+    memcpy(a.hi, r.hi, 2*n*n*sizeof(double));
+    t0 = timer_ns();
+    fe_lu_factor_mt(a, p, t);
+    t1 = timer_ns();
+
+    if (t == 1) memcpy(ref.hi, a.hi, 2*n*n*sizeof(double));
+
+    int same = memcmp(ref.hi, a.hi, 2*n*n*sizeof(double)) == 0;
+
+    report_table_row(stdout, &table, "fe_lu_factor", (uint64_t)t, 1e-6*(t1-t0), (t1-t0)/mn, same ? "yes" : "NO");
+  }
+
+  // gemm n³ multiply-adds
+  for(uint32_t t=1; t<=4; t*=2) {
+    memset(g.hi, 0, 2*n*n*sizeof(double));
+    t0 = timer_ns();
+    fe_gemm_mt(g, r, r, 1.0, t);
+    t1 = timer_ns();
+    report_table_row(stdout, &table, "fe_gemm", (uint64_t)t, 1e-6*(t1-t0), (t1-t0)/(3.0*mn), "-");
+  }
+
+  report_table_end(stdout, &table);
+
+  fe_mat_free(a); fe_mat_free(r); fe_mat_free(g); fe_mat_free(ref);
+  free(p); free(ad); free(pd);
+}
+
+
+//**********************************************************
+// QR & least squares
+
+// 2-norm of 64 random pairs scaled by 2^sc vs. MPFR: relative error in u²
+// (the squares over/underflow for the extreme scales w/o fe_nrm2's scaling)
+double nrm2_check(int sc)
+{
+  static double xh[64], xl[64];
+
+  mpfr_set_d(mp_e, 0, MPFR_RNDN);
+
+  for(int i=0; i<64; i++) {
+    fe_pair_t v = prng_fe();
+    xh[i] = ldexp(v.hi, sc);
+    xl[i] = ldexp(v.lo, sc);
+    mp_set(mp_t, fe_pair(xh[i], xl[i]));
+    mpfr_mul(mp_t, mp_t, mp_t, MPFR_RNDN);
+    mpfr_add(mp_e, mp_e, mp_t, MPFR_RNDN);
+  }
+
+  mpfr_sqrt(mp_e, mp_e, MPFR_RNDN);
+
+  mp_set(mp_t, fe_nrm2(xh, xl, 64, 1));
+  mpfr_sub(mp_t, mp_t, mp_e, MPFR_RNDN);
+  mpfr_div(mp_t, mp_t, mp_e, MPFR_RNDN);
+
+  return fabs(mpfr_get_d(mp_t, MPFR_RNDN))*0x1.0p106;
+}
+
+// unblocked Householder QR least squares in double (comparison)
+void qr_lstsq_f64(double* a, size_t m, size_t n, double* b)
+{
+  for(size_t k=0; k<n; k++) {
+    double s = 0;
+    for(size_t i=k; i<m; i++) s += a[i*n+k]*a[i*n+k];
+
+    double nrm  = sqrt(s);
+    double alfa = a[k*n+k];
+    double beta = alfa >= 0 ? -nrm : nrm;
+
+    if (nrm == 0) continue;
+
+    double tau = (beta-alfa)/beta;
+    double sc  = 1.0/(alfa-beta);
+
+    for(size_t i=k+1; i<m; i++) a[i*n+k] *= sc;
+    a[k*n+k] = beta;
+
+    for(size_t j=k+1; j<n; j++) {
+      double w = a[k*n+j];
+      for(size_t i=k+1; i<m; i++) w += a[i*n+k]*a[i*n+j];
+      w *= tau;
+      a[k*n+j] -= w;
+      for(size_t i=k+1; i<m; i++) a[i*n+j] -= a[i*n+k]*w;
+    }
+
+    double w = b[k];
+    for(size_t i=k+1; i<m; i++) w += a[i*n+k]*b[i];
+    w *= tau;
+    b[k] -= w;
+    for(size_t i=k+1; i<m; i++) b[i] -= a[i*n+k]*w;
+  }
+
+  for(size_t i=n; i-- > 0;) {
+    double s = b[i];
+    for(size_t j=i+1; j<n; j++) s -= a[i*n+j]*b[j];
+    b[i] = s/a[i*n+i];
+  }
+}
+
+typedef struct {
+  size_t m, n;
+  int    vander;
+  char*  name;
+} lstsq_t;
+
+lstsq_t lstsq_problems[] =
+{
+  { 100,  12, 1, "poly fit" },
+  { 100,  16, 1, "poly fit" },
+  { 200,  80, 0, "random"   },
+};
+
+#define LS_M 200
+
+void qr_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nfe_nrm2: relative error in u²\n" SGR_RESET);
+
+  printf("  scale 2^0: %f, 2^1000: %f, 2^-950: %f\n", nrm2_check(0), nrm2_check(1000), nrm2_check(-950));
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nleast squares: accuracy in bits (vs. MPFR normal equations)\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("problem",8), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("m",3) },
+      { REPORT_TABLE_U64("n",3) },
+      { REPORT_TABLE_F("qr_f64",3,1) },
+      { REPORT_TABLE_F("fe_qr",3,1) },
+      { REPORT_TABLE_F("ms(fe)",4,3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  static double a[LS_M*MAXN], ac[LS_M*MAXN], b[LS_M], bh[LS_M], bl[LS_M], th[MAXN], tl[MAXN];
+
+  for(size_t pi=0; pi<LENGTHOF(lstsq_problems); pi++) {
+    size_t m = lstsq_problems[pi].m;
+    size_t n = lstsq_problems[pi].n;
+
+    for(size_t i=0; i<m; i++) {
+      double t = (double)i/(double)(m-1);
+      double v = 1;
+      for(size_t j=0; j<n; j++) {
+        if (lstsq_problems[pi].vander) { a[i*n+j] = v; v *= t; }
+        else                             a[i*n+j] = 2.0*prng_f64()-1.0;
+      }
+      b[i] = lstsq_problems[pi].vander ? exp(t) : 2.0*prng_f64()-1.0;
+    }
+
+    // reference: (AᵀA)x = Aᵀb
+    for(size_t r=0; r<n; r++) {
+      for(size_t c=0; c<=n; c++) {
+        mpfr_set_d(mp_m[r][c], 0, MPFR_RNDN);
+        for(size_t i=0; i<m; i++) {
+          mpfr_set_d(mp_t, a[i*n+r], MPFR_RNDN);
+          mpfr_mul_d(mp_t, mp_t, (c < n) ? a[i*n+c] : b[i], MPFR_RNDN);
+          mpfr_add(mp_m[r][c], mp_m[r][c], mp_t, MPFR_RNDN);
+        }
+      }
+    }
+
+    mp_ge(n);
+
+    memcpy(ac, a, m*n*sizeof(double));
+    memcpy(bh, b, m*sizeof(double));
+    qr_lstsq_f64(ac, m, n, bh);
+
+    double bits_d = fwd_bits(bh, NULL, n);
+
+    fe_mat_t q = fe_mat_alloc(m,n);
+
+    for(size_t i=0; i<m*n; i++) q.hi[i] = a[i];
+    for(size_t i=0; i<m; i++) { bh[i] = b[i]; bl[i] = 0; }
+
+    double t0 = timer_ns();
+    fe_qr_factor(q, th, tl);
+    fe_qr_solve(q, th, tl, bh, bl);
+    double t1 = timer_ns();
+
+    double bits_fe = fwd_bits(bh, bl, n);
+
+    fe_mat_free(q);
+
+    report_table_row(stdout, &table, lstsq_problems[pi].name, (uint64_t)m, (uint64_t)n,
+                     bits_d, bits_fe, 1e-6*(t1-t0));
+  }
+
+  report_table_end(stdout, &table);
+
+  // threaded trailing updates: timing & bitwise compare
+  size_t   m = 512, n = 256;
+  fe_mat_t a0 = fe_mat_alloc(m,n), q = fe_mat_alloc(m,n), ref = fe_mat_alloc(m,n);
+  double*  t2 = malloc(2*n*sizeof(double));
+
+  for(size_t i=0; i<m*n; i++) a0.hi[i] = 2.0*prng_f64()-1.0;
+
+  printf("  fe_qr_factor %zux%zu:", m, n);
+
+  for(uint32_t t=1; t<=4; t*=2) {
+    memcpy(q.hi, a0.hi, 2*m*n*sizeof(double));
+    double t0 = timer_ns();
+    fe_qr_factor_mt(q, t2, t2+n, t);
+    double t1 = timer_ns();
+    if (t == 1) memcpy(ref.hi, q.hi, 2*m*n*sizeof(double));
+    printf(" %u thread(s) %.2f ms%s", t, 1e-6*(t1-t0), memcmp(ref.hi, q.hi, 2*m*n*sizeof(double)) ? " (MISMATCH)" : "");
+  }
+
+  printf("\n");
+
+  fe_mat_free(a0); fe_mat_free(q); fe_mat_free(ref); free(t2);
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, MP_PREC);
+  mpfr_init2(mp_t, MP_PREC);
+  mp_m_init();
+
+  solve_tests();
+  gemm_tests();
+  factor_bench();
+  qr_tests();
+
+  return 0;
+}
@@ -0,0 +1,397 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Root counts, errors (vs. MPFR) and timings of the quadratic and cubic
+// solvers in f64_pair_poly.h vs. the textbook formulas. Timings are
+// single measurements.
+
+#include "common.h"
+#include "../f64_pair_poly.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define MP_PREC 1024
+#define NEQ     20000
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+// random with sign & exponent on [-e,e]
+static inline double rand_val(int e)
+{
+  double r = ldexp(prng_f64()+0.5, (int)(prng_u32() % (uint32_t)(2*e+1)) - e);
+  return (prng_u32() & 1) ? r : -r;
+}
+
+
+//**********************************************************
+// textbook formulas
+
+static int naive_quadratic(double a, double b, double c, double* r)
+{
+  double d = b*b-4*a*c;
+
+  if (d < 0) {
+    r[0] = -b/(2*a);
+    r[1] = fabs(sqrt(-d)/(2*a));
+    return 0;
+  }
+
+  double s = sqrt(d);
+
+  r[0] = (-b-s)/(2*a);
+  r[1] = (-b+s)/(2*a);
+
+  if (r[1] < r[0]) { double t = r[0]; r[0] = r[1]; r[1] = t; }
+
+  return 2;
+}
+
+// Cardano/trigonometric
+static int naive_cubic(double a, double b, double c, double d, double* r)
+{
+  double B = b/a, C = c/a, D = d/a;
+  double p = C - B*B/3;
+  double q = 2*B*B*B/27 - B*C/3 + D;
+  double s = B/3;
+  double e = q*q/4 + p*p*p/27;
+
+  if (e > 0) {
+    double t = sqrt(e);
+    double u = cbrt(-q/2 + t);
+    double v = cbrt(-q/2 - t);
+
+    r[0] = u+v-s;
+    r[1] = -(u+v)/2-s;
+    r[2] = fabs(u-v)*0.8660254037844386;
+    return 1;
+  }
+
+  if (p == 0) { r[0] = r[1] = r[2] = -s; return 3; }
+
+  double m = 2*sqrt(-p/3);
+  double x = fmin(fmax(3*q/(p*m), -1), 1);
+  double h = acos(x)/3;
+
+  for(int k=0; k<3; k++) r[k] = m*cos(h-2.0943951023931957*k) - s;
+
+  // sort
+  for(int i=0; i<2; i++)
+    for(int j=0; j<2-i; j++)
+      if (r[j+1] < r[j]) { double t = r[j]; r[j] = r[j+1]; r[j+1] = t; }
+
+  return 3;
+}
+
+
+//**********************************************************
+// MPFR references
+
+mpfr_t mp_a, mp_b, mp_c, mp_d, mp_x, mp_p, mp_q;
+
+static void mp_init(void)
+{
+  mpfr_init2(mp_a, MP_PREC); mpfr_init2(mp_b, MP_PREC);
+  mpfr_init2(mp_c, MP_PREC); mpfr_init2(mp_d, MP_PREC);
+  mpfr_init2(mp_x, MP_PREC); mpfr_init2(mp_p, MP_PREC);
+  mpfr_init2(mp_q, MP_PREC);
+}
+
+// real roots (mp_d = exact discriminant). returns count
+static int mp_quadratic(double a, double b, double c, double* r)
+{
+  mpfr_set_d(mp_d, b, MPFR_RNDN);
+  mpfr_mul_d(mp_d, mp_d, b, MPFR_RNDN);
+  mpfr_set_d(mp_e, 4*a, MPFR_RNDN);
+  mpfr_mul_d(mp_e, mp_e, c, MPFR_RNDN);
+  mpfr_sub(mp_d, mp_d, mp_e, MPFR_RNDN);
+
+  if (mpfr_sgn(mp_d) < 0) return 0;
+
+  // q = -(b+sign(b)√d)/2, roots: q/a, c/q
+  mpfr_sqrt(mp_q, mp_d, MPFR_RNDN);
+  if (b < 0) mpfr_neg(mp_q, mp_q, MPFR_RNDN);
+  mpfr_add_d(mp_q, mp_q, b, MPFR_RNDN);
+  mpfr_mul_d(mp_q, mp_q, -0.5, MPFR_RNDN);
+
+  if (mpfr_zero_p(mp_q)) { r[0] = r[1] = 0; return 2; }
+
+  mpfr_div_d(mp_e, mp_q, a, MPFR_RNDN);
+  r[0] = mpfr_get_d(mp_e, MPFR_RNDN);
+
+  mpfr_set_d(mp_e, c, MPFR_RNDN);
+  mpfr_div(mp_e, mp_e, mp_q, MPFR_RNDN);
+  r[1] = mpfr_get_d(mp_e, MPFR_RNDN);
+
+  if (r[1] < r[0]) { double t = r[0]; r[0] = r[1]; r[1] = t; }
+
+  return 2;
+}
+
+// sign of the exact cubic discriminant:
+// 18abcd - 4b³d + b²c² - 4ac³ - 27a²d²
+// (zero is a multiple root so all three are real)
+static int mp_cubic_count(double a, double b, double c, double d)
+{
+  static const double k[5] = {18,-4,1,-4,-27};
+  const  double e[5][4] = {
+    {a,b,c,d}, {b,b,b,d}, {b,b,c,c}, {a,c,c,c}, {a,a,d,d}
+  };
+
+  mpfr_set_d(mp_d, 0, MPFR_RNDN);
+
+  for(int i=0; i<5; i++) {
+    mpfr_set_d(mp_e, k[i], MPFR_RNDN);
+    for(int j=0; j<4; j++) mpfr_mul_d(mp_e, mp_e, e[i][j], MPFR_RNDN);
+    mpfr_add(mp_d, mp_d, mp_e, MPFR_RNDN);
+  }
+
+  return mpfr_sgn(mp_d) >= 0 ? 3 : 1;
+}
+
+// root of the cubic by Newton (in MPFR) from 'x'
+static double mp_cubic_root(double a, double b, double c, double d, double x)
+{
+  mpfr_set_d(mp_x, x, MPFR_RNDN);
+
+  for(int i=0; i<12; i++) {
+    // p = ((ax+b)x+c)x+d, q = (3ax+2b)x+c
+    mpfr_set_d(mp_p, a, MPFR_RNDN);
+    mpfr_mul(mp_p, mp_p, mp_x, MPFR_RNDN); mpfr_add_d(mp_p, mp_p, b, MPFR_RNDN);
+    mpfr_mul(mp_p, mp_p, mp_x, MPFR_RNDN); mpfr_add_d(mp_p, mp_p, c, MPFR_RNDN);
+    mpfr_mul(mp_p, mp_p, mp_x, MPFR_RNDN); mpfr_add_d(mp_p, mp_p, d, MPFR_RNDN);
+
+    mpfr_set_d(mp_q, 3*a, MPFR_RNDN);
+    mpfr_mul(mp_q, mp_q, mp_x, MPFR_RNDN); mpfr_add_d(mp_q, mp_q, 2*b, MPFR_RNDN);
+    mpfr_mul(mp_q, mp_q, mp_x, MPFR_RNDN); mpfr_add_d(mp_q, mp_q, c, MPFR_RNDN);
+
+    if (mpfr_zero_p(mp_q) || mpfr_zero_p(mp_p)) break;
+
+    mpfr_div(mp_p, mp_p, mp_q, MPFR_RNDN);
+    mpfr_sub(mp_x, mp_x, mp_p, MPFR_RNDN);
+  }
+
+  return mpfr_get_d(mp_x, MPFR_RNDN);
+}
+
+// distance in ulps of 'r'
+static inline double root_ulps(double x, double r)
+{
+  if (x == r) return 0;
+  if (r == 0) return INFINITY;
+  return fabs(x-r)/ldexp(1.0, ilogb(r)-52);
+}
+
+
+//**********************************************************
+
+double   coef[4*NEQ];
+double   root[3*NEQ];
+int8_t   cnt[NEQ];
+double   ref[3*NEQ];
+int8_t   ref_cnt[NEQ];
+
+enum { DATA_RANDOM, DATA_CLOSE, DATA_WIDE };
+
+static const char* data_name[] = { "random", "close", "wide" };
+
+// quadratics: random, nearly double roots (b² ≈ 4ac) & roots of widely
+// different magnitude (|c| << |b|: cancellation in the textbook formula)
+static void gen_quadratic(int data)
+{
+  for(int i=0; i<NEQ; i++) {
+    double* e = coef+3*i;
+    double  a = rand_val(8), c = rand_val(8);
+
+    switch(data) {
+      case DATA_RANDOM: e[0] = a; e[1] = rand_val(8); e[2] = c; break;
+
+      case DATA_CLOSE: {
+        c = copysign(c,a);
+        double s = 2*sqrt(a*c)*(1 + rand_val(1)*ldexp(1,-20-(int)(prng_u32()%30)));
+        e[0] = a; e[1] = (prng_u32() & 1) ? s : -s; e[2] = c;
+        break;
+      }
+
+      default:
+        e[0] = a; e[1] = rand_val(2)*16; e[2] = c*0x1.0p-40; break;
+    }
+  }
+}
+
+// cubics: random coefficients and from roots: clustered (1, 1+ε, 1+2ε
+// scaled) and widely spread (~1e-6, 1, 1e6) with rounded coefficients
+static void gen_cubic(int data)
+{
+  for(int i=0; i<NEQ; i++) {
+    double* e = coef+4*i;
+
+    if (data == DATA_RANDOM) {
+      for(int j=0; j<4; j++) e[j] = rand_val(8);
+      continue;
+    }
+
+    double r0, r1, r2, s = rand_val(4);
+
+    if (data == DATA_CLOSE) {
+      double t = ldexp(prng_f64()+0.5, -10-(int)(prng_u32()%10));
+      r0 = s; r1 = s*(1+t); r2 = s*(1+2*t);
+    }
+    else {
+      r0 = s*1e-6*(prng_f64()+0.5); r1 = -s*(prng_f64()+0.5); r2 = s*1e6*(prng_f64()+0.5);
+    }
+
+    // a(x-r0)(x-r1)(x-r2)
+    double a = rand_val(2);
+
+    e[0] = a;
+    e[1] = -a*(r0+r1+r2);
+    e[2] = a*(r0*r1+r0*r2+r1*r2);
+    e[3] = -a*r0*r1*r2;
+  }
+
+  // regression: the inflection point's residual has the wrong sign so
+  // the bound isn't past the root (the start point came back as a root)
+  if (data == DATA_CLOSE) {
+    static const double e[4] = {
+      0x1.c423042ec933ap+1, -0x1.f505835115d68p+1, 0x1.7220b67e15639p+0, -0x1.6c92f3148f398p-3
+    };
+
+    for(int j=0; j<4; j++) coef[j] = e[j];
+  }
+}
+
+typedef struct {
+  const char* name;
+  uint32_t    mode;         // ~0 = textbook
+} method_t;
+
+static const method_t methods[] = {
+  { "textbook",    ~0u },
+  { "f64",         FE_POLY_F64 },
+  { "f64+polish",  FE_POLY_F64|FE_POLY_POLISH },
+  { "pair",        FE_POLY_PAIR },
+  { "pair+polish", FE_POLY_PAIR|FE_POLY_POLISH },
+};
+
+static void run(int deg, uint32_t mode)
+{
+  if (deg == 2) {
+    if (mode == ~0u) { for(int i=0; i<NEQ; i++) cnt[i] = (int8_t)naive_quadratic(coef[3*i],coef[3*i+1],coef[3*i+2],root+2*i); }
+    else fe_quadratic_batch(coef, NEQ, root, cnt, mode);
+  }
+  else {
+    if (mode == ~0u) { for(int i=0; i<NEQ; i++) cnt[i] = (int8_t)naive_cubic(coef[4*i],coef[4*i+1],coef[4*i+2],coef[4*i+3],root+3*i); }
+    else fe_cubic_batch(coef, NEQ, root, cnt, mode);
+  }
+}
+
+uint64_t solver_tests(int deg)
+{
+  uint64_t errors = 0;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255)
+         "\n%s: %d equations per set. root errors in ulp (vs. MPFR)\n" SGR_RESET,
+         deg == 2 ? "quadratic" : "cubic", NEQ);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("data",6),    .just=report_table_justify_left },
+      { REPORT_TABLE_STR("method",11), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("count wrong",5) },
+      { REPORT_TABLE_E("max ulp",3) },
+      { REPORT_TABLE_F("% CR",3,3) },
+      { REPORT_TABLE_F("ns/eq",3,2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int data=0; data<3; data++) {
+    if (deg == 2) gen_quadratic(data); else gen_cubic(data);
+
+    // references: the roots for the cubic start from the pair+polish
+    // results (one real root or all three)
+    if (deg == 2) {
+      for(int i=0; i<NEQ; i++)
+        ref_cnt[i] = (int8_t)mp_quadratic(coef[3*i],coef[3*i+1],coef[3*i+2],ref+2*i);
+    }
+    else {
+      run(3, FE_POLY_PAIR|FE_POLY_POLISH);
+
+      for(int i=0; i<NEQ; i++) {
+        const double* e = coef+4*i;
+        ref_cnt[i] = (int8_t)mp_cubic_count(e[0],e[1],e[2],e[3]);
+
+        int n = (cnt[i] < ref_cnt[i]) ? cnt[i] : ref_cnt[i];
+
+        for(int j=0; j<n; j++) ref[3*i+j] = mp_cubic_root(e[0],e[1],e[2],e[3],root[3*i+j]);
+      }
+    }
+
+    for(size_t m=0; m<LENGTHOF(methods); m++) {
+      double t0 = timer_ns();
+      run(deg, methods[m].mode);
+      double t1 = timer_ns();
+
+      uint64_t wrong = 0, total = 0, cr = 0;
+      double   emax  = 0;
+
+      for(int i=0; i<NEQ; i++) {
+        if (cnt[i] != ref_cnt[i]) { wrong++; continue; }
+
+        // cubic: one real root is r[0]
+        int n = (deg == 2) ? ref_cnt[i] : (ref_cnt[i] == 3 ? 3 : 1);
+
+        for(int j=0; j<n; j++) {
+          double x = root[deg*i+j], r = ref[deg*i+j];
+          double e = root_ulps(x,r);
+          if (e > emax) emax = e;
+          cr += (x == r);
+          total++;
+        }
+      }
+
+      // the number of real roots is exact & the pair forms are within
+      // an ulp
+      if (methods[m].mode != ~0u) {
+        errors += wrong;
+        if ((methods[m].mode & FE_POLY_PAIR) && emax > 1) errors++;
+      }
+
+      report_table_row(stdout, &table, data_name[data], methods[m].name, wrong, emax,
+                       total ? 100.0*(double)cr/(double)total : 0.0, (t1-t0)/NEQ);
+    }
+  }
+
+  report_table_end(stdout, &table);
+
+  return errors;
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, MP_PREC);
+  mpfr_init2(mp_t, MP_PREC);
+  mp_init();
+
+  uint64_t errors = 0;
+
+  errors += solver_tests(2);
+  errors += solver_tests(3);
+
+  printf("\nerrors: %lu\n", (unsigned long)errors);
+
+  return errors != 0;
+}
@@ -0,0 +1,285 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Correctness & rough throughput of f64_pair_sort.h. The radix sorts
+// are checked against qsort (by key) bit for bit and against each other
+// for all thread counts. Timings are single measurements & only meant
+// to show relative costs.
+
+#define FE_PAIR_PTHREADS
+
+#include "common.h"
+#include "../f64_pair_sort.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define KEY_TRIALS 0x100000
+#define BENCH_LEN  (1<<22)
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+// data sets
+enum { DATA_POS, DATA_SPREAD, DATA_DUP, DATA_SPECIAL, DATA_LENGTH };
+
+static const char* data_name[] = { "[0,1)", "±2^±30", "dups", "special" };
+
+static inline fe_pair_t prng_pair_spread(int b)
+{
+  int    e = (int)(prng_u64() >> 32) % (2*b+1) - b;
+  double h = ldexp(2.0*prng_f64()-1.0, e);
+
+  return fe_fast_sum(h, h*0x1.0p-53*(2.0*prng_f64()-1.0));
+}
+
+// dups: few distinct 'hi' each with a few 'lo'. special: signed zeros,
+// infinities & NaNs mixed with small integers (lots of equal 'hi')
+static fe_pair_t prng_pair(int set)
+{
+  uint32_t u = prng_u32();
+
+  switch(set) {
+    case DATA_POS:    return prng_fe();
+    case DATA_SPREAD: return prng_pair_spread(30);
+
+    case DATA_DUP: {
+      double h = (double)(u & 0xf) - 8.0;
+      double l = ldexp((double)((u >> 4) & 7) - 3.0, -60);
+      return fe_fast_sum(h,l);
+    }
+
+    default: {
+      static const double s[] = { 0.0, -0.0, INFINITY, -INFINITY, NAN, -NAN, 1.0, -1.0 };
+      double h = s[u & 7];
+      double l = ((u >> 3) & 1) ? -0.0 : 0.0;
+
+      if (!isfinite(h)) return fe_pair(h,0.0);
+
+      if (h == 1.0 || h == -1.0) { h *= (double)((u >> 4) & 15); l = ldexp((double)((u >> 8) & 3), -70); }
+
+      return fe_fast_sum(h,l);
+    }
+  }
+}
+
+// total order used as the reference
+static int cmp_key(const void* a, const void* b)
+{
+  return fe_key_cmp(fe_to_key(*(const fe_pair_t*)a), fe_to_key(*(const fe_pair_t*)b));
+}
+
+// what a user would write (no NaNs in the timed data)
+static int cmp_pair(const void* a, const void* b)
+{
+  return fe_cmp(*(const fe_pair_t*)a, *(const fe_pair_t*)b);
+}
+
+static inline bool same_bits(double a, double b) { return fe_to_bits(a) == fe_to_bits(b); }
+
+//**********************************************************
+
+void key_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nkeys: failures/trials\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("data",8), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("round trip",10) },
+      { REPORT_TABLE_U64("order",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int set=0; set<DATA_LENGTH; set++) {
+    uint64_t fails[2] = {0};
+
+    for(int j=0; j<KEY_TRIALS; j++) {
+      fe_pair_t a = prng_pair(set);
+      fe_pair_t b = prng_pair(set);
+      fe_pair_t r = fe_from_key(fe_to_key(a));
+      int       k = fe_key_cmp(fe_to_key(a), fe_to_key(b));
+
+      fails[0] += !same_bits(r.hi,a.hi) || !same_bits(r.lo,a.lo);
+
+      // ordered values: key order is the value order except for signed
+      // zeros which are equal as values
+      if (isnan(a.hi) || isnan(b.hi)) {
+        if (isnan(a.hi) && !isnan(b.hi)) fails[1] += k != (signbit(a.hi) ? -1 : 1);
+        if (isnan(b.hi) && !isnan(a.hi)) fails[1] += k != (signbit(b.hi) ? 1 : -1);
+        continue;
+      }
+
+      int c = fe_cmp(a,b);
+
+      fails[1] += (c != 0) ? (k != c) : (k != 0 && !(a.hi == 0.0 || a.lo == 0.0));
+    }
+
+    report_table_row(stdout, &table, data_name[set], fails[0], fails[1], (uint64_t)KEY_TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+
+static const size_t sort_len[] = { 0, 1, 2, 3, 100, 0x8000-1, 0x40000+7, 0x100000 };
+
+void sort_tests(void)
+{
+  long     cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t tmax = (uint32_t)(cpus > 4 ? cpus : 4);
+  size_t   nmax = sort_len[LENGTHOF(sort_len)-1];
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nsorts vs. qsort (by key): mismatched elements\n" SGR_RESET);
+
+  fe_pair_t* ref = malloc(nmax*sizeof(fe_pair_t));
+  double*    hi  = malloc(nmax*sizeof(double));
+  double*    lo  = malloc(nmax*sizeof(double));
+  double*    mh  = malloc(nmax*sizeof(double));
+  double*    ml  = malloc(nmax*sizeof(double));
+
+  if (!ref || !hi || !lo || !mh || !ml) { printf("  allocation failed\n"); goto done; }
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("data",8), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("n",8) },
+      { REPORT_TABLE_U64("soa",8) },
+      { REPORT_TABLE_U64("soa_mt",8) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int set=0; set<DATA_LENGTH; set++) {
+    for(size_t k=0; k<LENGTHOF(sort_len); k++) {
+      size_t   n = sort_len[k];
+      uint64_t e[2] = {0};
+
+      for(size_t i=0; i<n; i++) ref[i] = prng_pair(set);
+
+      for(size_t i=0; i<n; i++) { hi[i] = ref[i].hi; lo[i] = ref[i].lo; }
+
+      qsort(ref, n, sizeof(fe_pair_t), cmp_key);
+
+      for(uint32_t t=1; t<=tmax; t++) {
+        memcpy(mh, hi, n*sizeof(double));
+        memcpy(ml, lo, n*sizeof(double));
+
+        if (fe_sort_soa_mt(mh,ml,n,t) != 0) { e[1] = n; break; }
+
+        for(size_t i=0; i<n; i++)
+          e[1] += !same_bits(mh[i],ref[i].hi) || !same_bits(ml[i],ref[i].lo);
+      }
+
+      if (fe_sort_soa(hi,lo,n) != 0) e[0] = n;
+
+      for(size_t i=0; i<n; i++)
+        e[0] += !same_bits(hi[i],ref[i].hi) || !same_bits(lo[i],ref[i].lo);
+
+      report_table_row(stdout, &table, data_name[set], (uint64_t)n, e[0], e[1]);
+    }
+  }
+
+  report_table_end(stdout, &table);
+
+ done:
+  free(ref); free(hi); free(lo); free(mh); free(ml);
+}
+
+//**********************************************************
+
+void bench(void)
+{
+  long     cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t tmax = (uint32_t)(cpus > 4 ? cpus : 4);
+  size_t   n    = BENCH_LEN;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nthroughput: n=%d (±2^±30), %ld online cpus\n" SGR_RESET, BENCH_LEN, cpus);
+
+  fe_pair_t* x  = malloc(n*sizeof(fe_pair_t));
+  fe_pair_t* a  = malloc(n*sizeof(fe_pair_t));
+  double*    hi = malloc(n*sizeof(double));
+  double*    lo = malloc(n*sizeof(double));
+
+  if (!x || !a || !hi || !lo) { printf("  allocation failed\n"); goto done; }
+
+  for(size_t i=0; i<n; i++) x[i] = prng_pair(DATA_SPREAD);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("sort",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("threads",3) },
+      { REPORT_TABLE_F("ns/elem",3,3) },
+      { REPORT_TABLE_F("vs qsort",4,2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  double t0, t1, base;
+
+  memcpy(a, x, n*sizeof(fe_pair_t));
+  t0 = timer_ns();
+  qsort(a, n, sizeof(fe_pair_t), cmp_pair);
+  t1 = timer_ns();
+  base = t1-t0;
+
+  report_table_row(stdout, &table, "qsort (pair)", (uint64_t)1, base/(double)n, 1.0);
+
+  for(size_t i=0; i<n; i++) { hi[i] = x[i].hi; lo[i] = x[i].lo; }
+
+  t0 = timer_ns();
+  fe_sort_soa(hi,lo,n);
+  t1 = timer_ns();
+
+  report_table_row(stdout, &table, "fe_sort_soa", (uint64_t)1, (t1-t0)/(double)n, base/(t1-t0));
+
+  for(uint32_t t=2; t<=tmax; t *= 2) {
+    for(size_t i=0; i<n; i++) { hi[i] = x[i].hi; lo[i] = x[i].lo; }
+
+    t0 = timer_ns();
+    fe_sort_soa_mt(hi,lo,n,t);
+    t1 = timer_ns();
+
+    report_table_row(stdout, &table, "fe_sort_soa_mt", (uint64_t)t, (t1-t0)/(double)n, base/(t1-t0));
+  }
+
+  report_table_end(stdout, &table);
+
+  // sanity: same order as the qsort result
+  uint64_t e = 0;
+
+  for(size_t i=0; i<n; i++) e += !fe_eq(a[i], fe_pair(hi[i],lo[i]));
+
+  printf("  mismatches vs. qsort: %lu\n", e);
+
+ done:
+  free(x); free(a); free(hi); free(lo);
+}
+
+int main(void)
+{
+  mpfr_init2(mp_e, 128);
+  mpfr_init2(mp_t, 128);
+
+  key_tests();
+  sort_tests();
+  bench();
+
+  return 0;
+}
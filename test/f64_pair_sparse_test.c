@@ -0,0 +1,604 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Accuracy (vs. MPFR) and bandwidth normalized timings of the SpMV
+// routines in f64_pair_sparse.h. Timings are best of a few runs & only
+// meant to show relative costs.
+
+#define FE_PAIR_PTHREADS
+
+#include "common.h"
+#include "../f64_pair_sparse.h"
+
+#include <stdlib.h>
+#include <time.h>
+
+#define MP_PREC 400
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+static inline int same(double a, double b)
+{
+  return fe_to_bits(a) == fe_to_bits(b);
+}
+
+//**********************************************************
+// test matrices
+
+static fe_csr_t csr_alloc(size_t m, size_t n, size_t nnz)
+{
+  fe_csr_t a = {
+    .m   = m,
+    .n   = n,
+    .row = malloc((m+1)*sizeof(size_t)),
+    .col = malloc(nnz*sizeof(uint32_t)),
+    .v   = malloc(nnz*sizeof(double))
+  };
+
+  a.row[0] = 0;
+
+  return a;
+}
+
+static void csr_free(fe_csr_t a)
+{
+  free(a.row); free(a.col); free(a.v);
+}
+
+// random with sign & exponent on [-e,e]
+static inline double rand_val(int e)
+{
+  double v = 2.0*prng_f64()-1.0;
+  return e ? ldexp(v, (int)(prng_u32() % (uint32_t)(2*e+1)) - e) : v;
+}
+
+// 5-point Laplacian on a g x g grid
+static fe_csr_t csr_laplace(uint32_t g)
+{
+  size_t   m = (size_t)g*g;
+  fe_csr_t a = csr_alloc(m, m, 5*m);
+  size_t   k = 0;
+
+  for(uint32_t y=0; y<g; y++) {
+    for(uint32_t x=0; x<g; x++) {
+      uint32_t i = y*g+x;
+
+      if (y > 0)   { a.col[k] = i-g; a.v[k++] = -1; }
+      if (x > 0)   { a.col[k] = i-1; a.v[k++] = -1; }
+      a.col[k] = i; a.v[k++] = 4;
+      if (x < g-1) { a.col[k] = i+1; a.v[k++] = -1; }
+      if (y < g-1) { a.col[k] = i+g; a.v[k++] = -1; }
+
+      a.row[i+1] = k;
+    }
+  }
+
+  return a;
+}
+
+// irregular: row lengths 1 + (heavy tailed up to ~'len'), random columns
+// (unsorted, may repeat) & values with exponents on [-e,e]
+static fe_csr_t csr_random(size_t m, uint32_t len, int e)
+{
+  size_t* rl  = malloc(m*sizeof(size_t));
+  size_t  nnz = 0;
+
+  for(size_t i=0; i<m; i++) {
+    double u = prng_f64();
+    rl[i] = 1 + (size_t)(len*u*u*u*u);
+    nnz  += rl[i];
+  }
+
+  fe_csr_t a = csr_alloc(m, m, nnz);
+  size_t   k = 0;
+
+  for(size_t i=0; i<m; i++) {
+    for(size_t j=0; j<rl[i]; j++, k++) {
+      a.col[k] = prng_u32() % (uint32_t)m;
+      a.v[k]   = rand_val(e);
+    }
+    a.row[i+1] = k;
+  }
+
+  free(rl);
+
+  return a;
+}
+
+// plain double CSR
+static void csr_spmv_f64(fe_csr_t a, const double* restrict x, double* restrict y)
+{
+  for(size_t i=0; i<a.m; i++) {
+    double s = 0;
+    for(size_t k=a.row[i]; k<a.row[i+1]; k++)
+      s += a.v[k]*x[a.col[k]];
+    y[i] = s;
+  }
+}
+
+
+//**********************************************************
+// accuracy: bits relative to Σ|aᵢⱼxⱼ| (worst row)
+
+static double row_bits(fe_csr_t a, const double* x, size_t i, double yh, double yl)
+{
+  double mag = 0;
+
+  mpfr_set_d(mp_e, 0, MPFR_RNDN);
+
+  for(size_t k=a.row[i]; k<a.row[i+1]; k++) {
+    mpfr_set_d(mp_t, a.v[k], MPFR_RNDN);
+    mpfr_mul_d(mp_t, mp_t, x[a.col[k]], MPFR_RNDN);
+    mpfr_add(mp_e, mp_e, mp_t, MPFR_RNDN);
+    mag += fabs(a.v[k]*x[a.col[k]]);
+  }
+
+  mpfr_sub_d(mp_e, mp_e, yh, MPFR_RNDN);
+  mpfr_sub_d(mp_e, mp_e, yl, MPFR_RNDN);
+
+  double err = fabs(mpfr_get_d(mp_e, MPFR_RNDN));
+
+  if (err == 0 || mag == 0) return 160;
+
+  return -log2(err/mag);
+}
+
+uint64_t accuracy_tests(void)
+{
+  uint64_t errors = 0;
+  size_t   m      = 4000;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nSpMV accuracy: min bits relative to Σ|aᵢⱼxⱼ| (double: ~53-log2(k), pair: ~106-2log2(k))\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("matrix",14), .just=report_table_justify_left },
+      { REPORT_TABLE_F("double",3,1) },
+      { REPORT_TABLE_F("fe_csr",3,1) },
+      { REPORT_TABLE_F("fe_sell σ=1",3,1) },
+      { REPORT_TABLE_F("fe_sell σ=64",3,1) },
+      { REPORT_TABLE_STR("mt same",4) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  static const struct { uint32_t len; int e; const char* name; } prob[] = {
+    { 16,  0, "len 16, 2^±0"  },
+    { 64, 20, "len 64, 2^±20" },
+    {256, 40, "len 256, 2^±40"},
+  };
+
+  double* x  = malloc(m*sizeof(double));
+  double* y  = malloc(m*sizeof(double));
+  double* yh = malloc(m*sizeof(double));
+  double* yl = malloc(m*sizeof(double));
+  double* zh = malloc(m*sizeof(double));
+  double* zl = malloc(m*sizeof(double));
+
+  for(size_t p=0; p<LENGTHOF(prob); p++) {
+    fe_csr_t a = csr_random(m, prob[p].len, prob[p].e);
+    double   b[4] = {160,160,160,160};
+    int      ok   = 1;
+
+    for(size_t i=0; i<m; i++) x[i] = rand_val(prob[p].e);
+
+    csr_spmv_f64(a,x,y);
+
+    for(size_t i=0; i<m; i++) b[0] = fmin(b[0], row_bits(a,x,i,y[i],0));
+
+    fe_csr_spmv(a,x,yh,yl);
+
+    for(size_t i=0; i<m; i++) b[1] = fmin(b[1], row_bits(a,x,i,yh[i],yl[i]));
+
+    for(uint32_t t=1; t<=8; t++) {
+      fe_csr_spmv_mt(a,x,zh,zl,t);
+      for(size_t i=0; i<m; i++) ok &= same(yh[i],zh[i]) & same(yl[i],zl[i]);
+    }
+
+    for(int s=0; s<2; s++) {
+      fe_sell_t sa;
+
+      if (fe_sell_from_csr(&sa, a, s ? 64 : 1) != 0) { errors++; continue; }
+
+      fe_sell_spmv(&sa,x,yh,yl);
+
+      for(size_t i=0; i<m; i++) b[2+s] = fmin(b[2+s], row_bits(a,x,i,yh[i],yl[i]));
+
+      for(uint32_t t=1; t<=8; t++) {
+        fe_sell_spmv_mt(&sa,x,zh,zl,t);
+        for(size_t i=0; i<m; i++) ok &= same(yh[i],zh[i]) & same(yl[i],zl[i]);
+      }
+
+      // hi only
+      fe_sell_spmv(&sa,x,zh,NULL);
+      for(size_t i=0; i<m; i++) ok &= same(yh[i],zh[i]);
+
+      fe_sell_free(&sa);
+    }
+
+    // pair results must be at least 100-2log2(len) bits
+    double bound = 100 - 2*log2((double)prob[p].len+1);
+
+    errors += !ok;
+    errors += (uint64_t)((b[1] < bound) + (b[2] < bound) + (b[3] < bound));
+
+    report_table_row(stdout, &table, prob[p].name, b[0], b[1], b[2], b[3], ok ? "yes" : "FAIL");
+
+    csr_free(a);
+  }
+
+  report_table_end(stdout, &table);
+
+  free(x); free(y); free(yh); free(yl); free(zh); free(zl);
+
+  return errors;
+}
+
+
+//**********************************************************
+// bandwidth normalized timings
+//
+// Bytes are the minimum traffic of one SpMV: the stored values and
+// column indices, the row/slice offsets (& SELL permutation), 'x' once
+// and 'y' (8 or 16 bytes per row).
+
+#define BENCH_RUNS 5
+
+typedef enum { B_F64, B_CSR, B_SELL } bench_kind_t;
+
+static double bench(bench_kind_t kind, fe_csr_t a, const fe_sell_t* s, const double* x,
+                    double* yh, double* yl, uint32_t t)
+{
+  double best = INFINITY;
+
+  for(int r=0; r<BENCH_RUNS; r++) {
+    double t0 = timer_ns();
+
+    switch(kind) {
+      case B_F64:  csr_spmv_f64(a,x,yh);         break;
+      case B_CSR:  fe_csr_spmv_mt(a,x,yh,yl,t);  break;
+      default:     fe_sell_spmv_mt(s,x,yh,yl,t); break;
+    }
+
+    best = fmin(best, timer_ns()-t0);
+  }
+
+  return best;
+}
+
+void bench_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nSpMV timings (%d run best)\n" SGR_RESET, BENCH_RUNS);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("matrix",10), .just=report_table_justify_left },
+      { REPORT_TABLE_STR("method",13), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("threads",3) },
+      { REPORT_TABLE_F("ms",4,2) },
+      { REPORT_TABLE_F("ns/nnz",2,3) },
+      { REPORT_TABLE_F("GB/s",3,2) },
+      { REPORT_TABLE_F("fill",1,3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  fe_csr_t mat[2];
+  const char* name[2] = { "laplace", "random" };
+
+  mat[0] = csr_laplace(1000);
+  mat[1] = csr_random(400000, 64, 0);
+
+  for(int p=0; p<2; p++) {
+    fe_csr_t a   = mat[p];
+    size_t   m   = a.m;
+    size_t   nnz = fe_csr_nnz(a);
+    double*  x   = malloc(m*sizeof(double));
+    double*  yh  = malloc(m*sizeof(double));
+    double*  yl  = malloc(m*sizeof(double));
+    fe_sell_t s;
+
+    for(size_t i=0; i<m; i++) x[i] = rand_val(0);
+
+    if (fe_sell_from_csr(&s, a, 256) != 0) { printf("alloc failed\n"); return; }
+
+    double base = 12.0*(double)nnz + 8.0*(double)(m+1) + 8.0*(double)a.n;
+    double sell = 12.0*(double)fe_sell_size(&s) + 12.0*(double)s.slices + 4.0*(double)m + 8.0*(double)a.n;
+    double fill = (double)fe_sell_size(&s)/(double)nnz;
+
+    double ns = bench(B_F64, a, &s, x, yh, yl, 1);
+    report_table_row(stdout, &table, name[p], "double csr", (uint64_t)1, 1e-6*ns, ns/(double)nnz, (base+8.0*(double)m)/ns, 1.0);
+
+    for(uint32_t t=1; t<=4; t*=2) {
+      ns = bench(B_CSR, a, &s, x, yh, yl, t);
+      report_table_row(stdout, &table, name[p], "fe_csr", (uint64_t)t, 1e-6*ns, ns/(double)nnz, (base+16.0*(double)m)/ns, 1.0);
+    }
+
+    for(uint32_t t=1; t<=4; t*=2) {
+      ns = bench(B_SELL, a, &s, x, yh, yl, t);
+      report_table_row(stdout, &table, name[p], "fe_sell σ=256", (uint64_t)t, 1e-6*ns, ns/(double)nnz, (sell+16.0*(double)m)/ns, fill);
+    }
+
+    ns = bench(B_SELL, a, &s, x, yh, NULL, 1);
+    report_table_row(stdout, &table, name[p], "fe_sell (hi)", (uint64_t)1, 1e-6*ns, ns/(double)nnz, (sell+8.0*(double)m)/ns, fill);
+
+    fe_sell_free(&s);
+    free(x); free(yh); free(yl);
+    csr_free(a);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+
+//**********************************************************
+// Krylov solvers vs. plain double versions
+//
+// The double versions use the same recurrences with plain double
+// inner products and SpMV and no residual replacement. The reported
+// residual is the true |b-Ax|₂/|b|₂ (pair precision) for all.
+
+static inline double dot_f64(const double* x, const double* y, size_t n)
+{
+  double s = 0;
+  for(size_t i=0; i<n; i++) s += x[i]*y[i];
+  return s;
+}
+
+static int cg_f64(fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit)
+{
+  size_t  n  = a.m;
+  double* r  = malloc(3*n*sizeof(double));
+  double* p  = r+n;
+  double* q  = p+n;
+  double  bn = sqrt(dot_f64(b,b,n));
+  int     it = 0;
+
+  csr_spmv_f64(a,x,q);
+
+  for(size_t i=0; i<n; i++) p[i] = r[i] = b[i]-q[i];
+
+  double rho = dot_f64(r,r,n);
+
+  while ((uint32_t)it < maxit && sqrt(rho) > tol*bn) {
+    csr_spmv_f64(a,p,q);
+    it++;
+
+    double alpha = rho/dot_f64(p,q,n);
+
+    for(size_t i=0; i<n; i++) {
+      x[i] += alpha*p[i];
+      r[i] -= alpha*q[i];
+    }
+
+    double rn   = dot_f64(r,r,n);
+    double beta = rn/rho;
+
+    rho = rn;
+
+    for(size_t i=0; i<n; i++) p[i] = r[i] + beta*p[i];
+  }
+
+  free(r);
+
+  return it;
+}
+
+static int bicgstab_f64(fe_csr_t a, const double* b, double* x, double tol, uint32_t maxit)
+{
+  size_t  n  = a.m;
+  double* r  = malloc(6*n*sizeof(double));
+  double* r0 = r+n;
+  double* p  = r0+n;
+  double* v  = p+n;
+  double* s  = v+n;
+  double* t  = s+n;
+  double  bn = sqrt(dot_f64(b,b,n));
+  int     it = 0;
+
+  csr_spmv_f64(a,x,t);
+
+  for(size_t i=0; i<n; i++) { r[i] = r0[i] = b[i]-t[i]; p[i] = v[i] = 0; }
+
+  double rho = 1, alpha = 1, omega = 1;
+
+  while ((uint32_t)it < maxit && sqrt(dot_f64(r,r,n)) > tol*bn) {
+    double rh   = dot_f64(r0,r,n);
+    double beta = (rh/rho)*(alpha/omega);
+
+    if (rh == 0 || omega == 0) break;
+
+    rho = rh;
+
+    for(size_t i=0; i<n; i++) p[i] = r[i] + beta*(p[i] - omega*v[i]);
+
+    csr_spmv_f64(a,p,v);
+    alpha = rho/dot_f64(r0,v,n);
+
+    for(size_t i=0; i<n; i++) s[i] = r[i] - alpha*v[i];
+
+    csr_spmv_f64(a,s,t);
+    it += 2;
+
+    double tt = dot_f64(t,t,n);
+
+    omega = tt != 0 ? dot_f64(t,s,n)/tt : 0;
+
+    for(size_t i=0; i<n; i++) {
+      x[i] += alpha*p[i] + omega*s[i];
+      r[i]  = s[i] - omega*t[i];
+    }
+  }
+
+  free(r);
+
+  return it;
+}
+
+// 1D Laplacian (tridiagonal 2,-1): condition number ~ 4n²/π²
+static fe_csr_t csr_laplace1(size_t m)
+{
+  fe_csr_t a = csr_alloc(m, m, 3*m);
+  size_t   k = 0;
+
+  for(size_t i=0; i<m; i++) {
+    if (i > 0)   { a.col[k] = (uint32_t)i-1; a.v[k++] = -1; }
+    a.col[k] = (uint32_t)i; a.v[k++] = 2;
+    if (i < m-1) { a.col[k] = (uint32_t)i+1; a.v[k++] = -1; }
+    a.row[i+1] = k;
+  }
+
+  return a;
+}
+
+// 5-point diffusion on a g x g grid with coefficient 1 or 'c' on
+// alternating 'b' x 'b' blocks (harmonic mean on the faces).
+// 'w' > 0 adds a first order upwind convection term w(∂x+∂y) which
+// makes it nonsymmetric.
+static fe_csr_t csr_diffusion(uint32_t g, uint32_t b, double c, double w)
+{
+  size_t   m = (size_t)g*g;
+  fe_csr_t a = csr_alloc(m, m, 5*m);
+  size_t   k = 0;
+
+#define KAPPA(X,Y) ((((X)/b + (Y)/b) & 1) ? c : 1.0)
+#define FACE(K0,K1) (2.0*(K0)*(K1)/((K0)+(K1)))
+
+  for(uint32_t y=0; y<g; y++) {
+    for(uint32_t x=0; x<g; x++) {
+      uint32_t i  = y*g+x;
+      double   k0 = KAPPA(x,y);
+      double   fs = FACE(k0, y > 0   ? KAPPA(x,y-1) : k0);
+      double   fw = FACE(k0, x > 0   ? KAPPA(x-1,y) : k0);
+      double   fe = FACE(k0, x < g-1 ? KAPPA(x+1,y) : k0);
+      double   fn = FACE(k0, y < g-1 ? KAPPA(x,y+1) : k0);
+
+      if (y > 0)   { a.col[k] = i-g; a.v[k++] = -fs-w; }
+      if (x > 0)   { a.col[k] = i-1; a.v[k++] = -fw-w; }
+      a.col[k] = i; a.v[k++] = fs+fw+fe+fn+2*w;
+      if (x < g-1) { a.col[k] = i+1; a.v[k++] = -fe; }
+      if (y < g-1) { a.col[k] = i+g; a.v[k++] = -fn; }
+
+      a.row[i+1] = k;
+    }
+  }
+
+#undef KAPPA
+#undef FACE
+
+  return a;
+}
+
+uint64_t krylov_tests(void)
+{
+  uint64_t errors = 0;
+  double   tol    = 1e-13;
+  uint32_t maxit  = 40000;
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nKrylov solvers: |b-Ax|/|b| <= %g (x₀=0, b=Ax, x random), max %u SpMV\n" SGR_RESET, tol, maxit);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("problem",16), .just=report_table_justify_left },
+      { REPORT_TABLE_STR("solver",12), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("SpMV",5) },
+      { REPORT_TABLE_U64("repl",3) },
+      { REPORT_TABLE_F("ms",5,2) },
+      { REPORT_TABLE_E("|b-Ax|/|b|",2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  static const struct { const char* name; int kind; uint32_t g; uint32_t b; double c; double w; } prob[] = {
+    { "laplace1 2000",   0, 2000, 0, 0,    0   },
+    { "laplace2 200²",   1,  200, 1, 1,    0   },
+    { "jumps 1e-4 128²", 1,  128, 8, 1e-4, 0   },
+    { "jumps 1e-6 128²", 1,  128, 8, 1e-6, 0   },
+    { "convect 128²",    1,  128, 8, 1e-2, 0.5 },
+  };
+
+  for(size_t p=0; p<LENGTHOF(prob); p++) {
+    fe_csr_t a = prob[p].kind ? csr_diffusion(prob[p].g, prob[p].b, prob[p].c, prob[p].w)
+                              : csr_laplace1(prob[p].g);
+    size_t   n = a.m;
+    int      spd = prob[p].w == 0;
+    double*  xt  = malloc(n*sizeof(double));
+    double*  b   = malloc(n*sizeof(double));
+    double*  x   = malloc(n*sizeof(double));
+    double*  r   = malloc(n*sizeof(double));
+
+    for(size_t i=0; i<n; i++) xt[i] = rand_val(0);
+
+    fe_csr_spmv(a,xt,b,NULL);
+
+    double bn = sqrt(dot_f64(b,b,n));
+
+    for(int s=0; s<4; s++) {
+      const char*      name[] = { "cg_f64", "fe_cg", "bicgstab_f64", "fe_bicgstab" };
+      fe_krylov_info_t info   = {0};
+      int              it;
+
+      if (spd ^ (s < 2)) continue;
+
+      memset(x, 0, n*sizeof(double));
+
+      double t0 = timer_ns();
+
+      switch(s) {
+        case 0:  it = cg_f64(a,b,x,tol,maxit);            break;
+        case 1:  it = fe_cg(a,b,x,tol,maxit,&info);       break;
+        case 2:  it = bicgstab_f64(a,b,x,tol,maxit);      break;
+        default: it = fe_bicgstab(a,b,x,tol,maxit,&info); break;
+      }
+
+      double t1 = timer_ns();
+
+      fe_csr_residual(a,b,x,r,NULL);
+
+      double res = sqrt(fe_krylov_dot_i(r,r,n).hi)/bn;
+
+      // the pair versions must converge
+      if (s & 1) errors += !info.converged || res > tol;
+
+      report_table_row(stdout, &table, prob[p].name, name[s], (uint64_t)it,
+                       (uint64_t)info.replacements, 1e-6*(t1-t0), res);
+    }
+
+    free(xt); free(b); free(x); free(r);
+    csr_free(a);
+  }
+
+  report_table_end(stdout, &table);
+
+  return errors;
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, MP_PREC);
+  mpfr_init2(mp_t, MP_PREC);
+
+  uint64_t errors = accuracy_tests();
+
+  bench_tests();
+
+  errors += krylov_tests();
+
+  printf("\nerrors: %lu\n", (unsigned long)errors);
+
+  return errors != 0;
+}
@@ -0,0 +1,369 @@
+// -*- coding: utf-8 -*-
+// Marc B. Reynolds, 2022-2025
+// Public Domain under http://unlicense.org, see link for details.
+
+// Accuracy (vs. MPFR) and rough throughput of the routines in
+// f64_pair_sum.h. Timings are single measurements & only meant to
+// show relative costs.
+
+#define FE_PAIR_PTHREADS
+
+#include "common.h"
+#include "../f64_pair_sum.h"
+
+#include <stdlib.h>
+#include <time.h>
+#include <unistd.h>
+
+#define LEN   0x10000
+#define REPS  0x100
+
+// globals
+mpfr_t mp_e;
+mpfr_t mp_t;
+mpfr_t mp_s;
+
+double    data_d[LEN];
+fe_pair_t data_p[LEN];
+
+static inline double timer_ns(void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return 1e9*(double)t.tv_sec + (double)t.tv_nsec;
+}
+
+// x = s 2^e with s on [-1,1) and e on [-b,b]
+static inline double prng_spread_f64(int b)
+{
+  int e = (int)(prng_u64() >> 32) % (2*b+1) - b;
+
+  return ldexp(2.0*prng_f64()-1.0, e);
+}
+
+// data sets
+enum { DATA_POS, DATA_SPREAD, DATA_CANCEL, DATA_LENGTH };
+
+static const char* data_name[] = { "[0,1)", "±2^±30", "cancel" };
+
+void data_init(int set)
+{
+  for(int i=0; i<LEN; i++) {
+    double v;
+
+    switch(set) {
+      case DATA_POS:    v = prng_f64(); break;
+      case DATA_SPREAD: v = prng_spread_f64(30); break;
+      default:
+        // pairs which nearly cancel: sum is ~2^-40 of sum of magnitudes
+        if (i & 1) v = -data_d[i-1]*(1.0+0x1.0p-40*prng_f64());
+        else       v = prng_spread_f64(20);
+    }
+    data_d[i] = v;
+    data_p[i] = fe_mul_dd(v, 1.0+0x1.0p-30*prng_f64());
+  }
+
+  // exact sum of the pairs in mp_s (mp_e for the doubles)
+  mpfr_set_d(mp_s,0,MPFR_RNDN);
+  mpfr_set_d(mp_e,0,MPFR_RNDN);
+
+  for(int i=0; i<LEN; i++) {
+    mpfr_add_d(mp_e,mp_e,data_d[i],  MPFR_RNDN);
+    mpfr_add_d(mp_s,mp_s,data_p[i].hi,MPFR_RNDN);
+    mpfr_add_d(mp_s,mp_s,data_p[i].lo,MPFR_RNDN);
+  }
+}
+
+// |e-r| in units of u^2 A (A = sum of magnitudes)
+double sum_error(mpfr_t e, fe_pair_t r, double a)
+{
+  mpfr_sub_d(mp_t, e,    r.hi, MPFR_RNDN);
+  mpfr_sub_d(mp_t, mp_t, r.lo, MPFR_RNDN);
+  mpfr_abs  (mp_t, mp_t,       MPFR_RNDN);
+
+  return mpfr_get_d(mp_t, MPFR_RNDU)*0x1.0p106/a;
+}
+
+typedef struct {
+  fe_pair_t (*d)(const double*,    size_t);
+  fe_pair_t (*p)(const fe_pair_t*, size_t);
+  char*  name;
+  double bound_d;   // error bounds in n u^2 A
+  double bound_p;
+} sum_table_t;
+
+#define FR_BOUND_D(K) (((K)+3)/2.0 + 2.0*((K)+1)/(K))
+#define FR_BOUND_P(K) (2.0*((K)+1) + 2.0*(2*(K)+1)/(K))
+
+fe_pair_t accum_sum_d(const double* x, size_t n)
+{
+  return fe_accum_result(fe_accum_add_array_d(fe_accum(),x,n));
+}
+
+fe_pair_t accum_sum(const fe_pair_t* x, size_t n)
+{
+  return fe_accum_result(fe_accum_add_array(fe_accum(),x,n));
+}
+
+sum_table_t sums[] =
+{
+  { .d=fe_sum_d, .p=fe_sum, .name="fe_sum", .bound_d=2, .bound_p=3 },
+  { .d=fr_sum_d, .p=fr_sum, .name="fr_sum", .bound_d=FR_BOUND_D(FR_ACCUM_PERIOD), .bound_p=FR_BOUND_P(FR_ACCUM_PERIOD) },
+  { .d=accum_sum_d, .p=accum_sum, .name="fe_accum", .bound_d=2, .bound_p=3 },
+  { .d=fe_rsum_d,   .p=fe_rsum,   .name="fe_rsum",  .bound_d=2, .bound_p=3 },
+};
+
+volatile double sink;
+
+void sum_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nsums: n=%d, error in u²A (A=Σ|x|), bound in n u²A\n" SGR_RESET, LEN);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("sum",10), .just=report_table_justify_left },
+      { REPORT_TABLE_STR("data",8), .just=report_table_justify_left },
+      { REPORT_TABLE_F("err(d)",6,3) },
+      { REPORT_TABLE_F("err(p)",6,3) },
+      { REPORT_TABLE_F("bound(d)",3,2) },
+      { REPORT_TABLE_F("bound(p)",3,2) },
+      { REPORT_TABLE_F("ns/d",3,3) },
+      { REPORT_TABLE_F("ns/p",3,3) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int set=0; set<DATA_LENGTH; set++) {
+    data_init(set);
+
+    double ad = 0, ap = 0;
+
+    for(int i=0; i<LEN; i++) {
+      ad += fabs(data_d[i]);
+      ap += fabs(data_p[i].hi);
+    }
+
+    for(size_t i=0; i<LENGTHOF(sums); i++) {
+      sum_table_t* t = sums+i;
+      double ed = sum_error(mp_e, t->d(data_d,LEN), ad);
+      double ep = sum_error(mp_s, t->p(data_p,LEN), ap);
+      double t0,t1,t2;
+
+      t0 = timer_ns();
+      for(int r=0; r<REPS; r++) sink = t->d(data_d,LEN).hi;
+      t1 = timer_ns();
+      for(int r=0; r<REPS; r++) sink = t->p(data_p,LEN).hi;
+      t2 = timer_ns();
+
+      report_table_row(stdout, &table, t->name, data_name[set], ed, ep, t->bound_d, t->bound_p,
+                       (t1-t0)/(REPS*(double)LEN),
+                       (t2-t1)/(REPS*(double)LEN));
+    }
+  }
+
+  report_table_end(stdout, &table);
+}
+
+// reproducibility: fe_rsum results must be bit identical under
+// permutations, chunked/merged accumulation & thread counts.
+#define REPRO_PERMS 16
+
+double    perm_d[LEN];
+fe_pair_t perm_p[LEN];
+double    perm_y[LEN];
+
+static inline uint32_t prng_range(uint32_t n) { return (uint32_t)(((prng_u64()>>32)*n)>>32); }
+
+void shuffle(void)
+{
+  for(uint32_t i=LEN-1; i>0; i--) {
+    uint32_t j = prng_range(i+1);
+    double    t = perm_d[i]; perm_d[i] = perm_d[j]; perm_d[j] = t;
+    fe_pair_t p = perm_p[i]; perm_p[i] = perm_p[j]; perm_p[j] = p;
+    double    y = perm_y[i]; perm_y[i] = perm_y[j]; perm_y[j] = y;
+  }
+}
+
+static inline int same(fe_pair_t a, fe_pair_t b)
+{
+  return fe_to_bits(a.hi) == fe_to_bits(b.hi) && fe_to_bits(a.lo) == fe_to_bits(b.lo);
+}
+
+// accumulate random length chunks & merge them in reverse order
+fe_pair_t rsum_chunked(const double* x, size_t n)
+{
+  static fe_rsum_t part[64];
+  uint32_t c = 0;
+  size_t   o = 0;
+
+  while (o < n && c < 63) {
+    size_t len = 1 + prng_range(2*LEN/32);
+    if (len > n-o) len = n-o;
+    fe_rsum_init(part+c);
+    fe_rsum_add_array_d(part+c, x+o, len);
+    o += len; c++;
+  }
+
+  fe_rsum_init(part+c);
+  fe_rsum_add_array_d(part+c, x+o, n-o);
+
+  for(uint32_t i=c; i>0; i--) fe_rsum_merge(part+i-1, part+i);
+
+  return fe_rsum_result(part);
+}
+
+void repro_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nreproducible: n=%d, error in u²|S|, mismatches vs. in-order result\n" SGR_RESET, LEN);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("data",8), .just=report_table_justify_left },
+      { REPORT_TABLE_F("err(d)",6,3) },
+      { REPORT_TABLE_F("err(p)",6,3) },
+      { REPORT_TABLE_U64("trials",4) },
+      { REPORT_TABLE_U64("rsum",4) },
+      { REPORT_TABLE_U64("rdot",4) },
+      { REPORT_TABLE_U64("accum",4) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int set=0; set<DATA_LENGTH; set++) {
+    data_init(set);
+
+    for(int i=0; i<LEN; i++) perm_y[i] = prng_spread_f64(10);
+
+    fe_pair_t rd = fe_rsum_d(data_d,LEN);
+    fe_pair_t rp = fe_rsum  (data_p,LEN);
+    fe_pair_t ry = fe_rdot_d(data_d,perm_y,LEN);
+    fe_pair_t ra = accum_sum_d(data_d,LEN);
+
+    double ed = sum_error(mp_e, rd, fabs(mpfr_get_d(mp_e,MPFR_RNDN)));
+    double ep = sum_error(mp_s, rp, fabs(mpfr_get_d(mp_s,MPFR_RNDN)));
+
+    uint64_t trials = 0, fd = 0, fy = 0, fa = 0;
+
+    memcpy(perm_d, data_d, sizeof(perm_d));
+    memcpy(perm_p, data_p, sizeof(perm_p));
+
+    double ycopy[LEN];
+    memcpy(ycopy, perm_y, sizeof(ycopy));
+
+    for(int r=0; r<REPRO_PERMS; r++) {
+      shuffle();
+      trials++;
+      fd += !same(rd, fe_rsum_d(perm_d,LEN));
+      fd += !same(rp, fe_rsum  (perm_p,LEN));
+      fd += !same(rd, rsum_chunked(perm_d,LEN));
+      fy += !same(ry, fe_rdot_d(perm_d,perm_y,LEN));
+      fa += !same(ra, accum_sum_d(perm_d,LEN));
+    }
+
+    // thread counts on the original order
+    memcpy(perm_y, ycopy, sizeof(ycopy));
+
+    for(uint32_t t=1; t<=8; t++) {
+      trials++;
+      fd += !same(rd, fe_rsum_d_mt(data_d,LEN,t));
+      fy += !same(ry, fe_rdot_d_mt(data_d,perm_y,LEN,t));
+      fa += !same(ra, fe_sum_d_mt(data_d,LEN,t));
+    }
+
+    report_table_row(stdout, &table, data_name[set], ed, ep, trials, fd, fy, fa);
+  }
+
+  report_table_end(stdout, &table);
+  printf("  (accum: fe_accum_t is deterministic but order dependent, shown for comparison)\n");
+}
+
+// threaded reductions: merged results vs MPFR & scaling
+#define MT_LEN  (1<<23)
+#define MT_REPS 8
+
+void mt_tests(void)
+{
+  long     cpus = sysconf(_SC_NPROCESSORS_ONLN);
+  uint32_t tmax = (uint32_t)(cpus > 4 ? cpus : 4);
+
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nthreaded: n=%d, %ld online cpus, error in u²A\n" SGR_RESET, MT_LEN, cpus);
+
+  double* x = malloc(MT_LEN*sizeof(double));
+  double* y = malloc(MT_LEN*sizeof(double));
+  double  ax=0, axy=0;
+
+  if (!x || !y) { printf("  allocation failed\n"); free(x); free(y); return; }
+
+  mpfr_set_d(mp_e,0,MPFR_RNDN);
+  mpfr_set_d(mp_s,0,MPFR_RNDN);
+
+  for(int i=0; i<MT_LEN; i++) {
+    x[i] = prng_spread_f64(30);
+    y[i] = prng_spread_f64(30);
+    ax  += fabs(x[i]);
+    axy += fabs(x[i]*y[i]);
+    mpfr_add_d(mp_e,mp_e,x[i],MPFR_RNDN);
+    mpfr_set_d(mp_t,x[i],MPFR_RNDN);
+    mpfr_mul_d(mp_t,mp_t,y[i],MPFR_RNDN);
+    mpfr_add  (mp_s,mp_s,mp_t,MPFR_RNDN);
+  }
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_U64("threads",3) },
+      { REPORT_TABLE_F("err(sum)",6,3) },
+      { REPORT_TABLE_F("err(dot)",6,3) },
+      { REPORT_TABLE_F("ns/sum",3,3) },
+      { REPORT_TABLE_F("ns/dot",3,3) },
+      { REPORT_TABLE_F("ns/rsum",3,3) },
+      { REPORT_TABLE_F("speedup",3,2) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  double base = 0;
+
+  for(uint32_t t=1; t<=tmax; t++) {
+    double es = sum_error(mp_e, fe_sum_d_mt(x,MT_LEN,t),   ax);
+    double ed = sum_error(mp_s, fe_dot_d_mt(x,y,MT_LEN,t), axy);
+    double t0,t1,t2,t3;
+
+    t0 = timer_ns();
+    for(int r=0; r<MT_REPS; r++) sink = fe_sum_d_mt(x,MT_LEN,t).hi;
+    t1 = timer_ns();
+    for(int r=0; r<MT_REPS; r++) sink = fe_dot_d_mt(x,y,MT_LEN,t).hi;
+    t2 = timer_ns();
+    for(int r=0; r<MT_REPS; r++) sink = fe_rsum_d_mt(x,MT_LEN,t).hi;
+    t3 = timer_ns();
+
+    if (t == 1) base = t1-t0;
+
+    report_table_row(stdout, &table, (uint64_t)t, es, ed,
+                     (t1-t0)/(MT_REPS*(double)MT_LEN),
+                     (t2-t1)/(MT_REPS*(double)MT_LEN),
+                     (t3-t2)/(MT_REPS*(double)MT_LEN),
+                     base/(t1-t0));
+  }
+
+  report_table_end(stdout, &table);
+
+  free(x);
+  free(y);
+}
+
+
+int main(void)
+{
+  mpfr_init2(mp_e, 1024);
+  mpfr_init2(mp_t, 1024);
+  mpfr_init2(mp_s, 1024);
+
+  sum_tests();
+  repro_tests();
+  mt_tests();
+
+  return 0;
+}
@@ -1097,6 +1097,1166 @@ void op_pp_tests(void)
   }
 }
 
+//**********************************************************
+// correctly rounded results: f(pair,pair) → double & f(pair) → double
+// checks for bit-exact agreement with MPFR. besides random inputs
+// near-tie inputs (result within ~2^-100 of a midpoint) and exact
+// ties are generated to exercise the slow-paths.
+
+// 'inv' is used to build near-tie inputs: a = inv(tie,b) 
+typedef struct {
+  double    (*f)(fe_pair_t,fe_pair_t);
+  int       (*mp)(mpfr_t,const mpfr_t,const mpfr_t,mpfr_rnd_t);
+  char*     name;
+  fe_pair_t (*inv)(fe_pair_t,fe_pair_t);
+} cr_pp_table_t;
+
+cr_pp_table_t cr_pp[] =
+{
+  { .f=fe_result_mul, .mp=mpfr_mul, .name="fe_result_mul", .inv=fe_div },
+  { .f=fe_result_div, .mp=mpfr_div, .name="fe_result_div", .inv=fe_mul },
+  { .f=fe_result_add, .mp=mpfr_add, .name="fe_result_add", .inv=fe_sub },
+};
+
+// inputs which have failed in the past (checked by all)
+static const fe_pair_t cr_pp_hard[][2] =
+{
+  // fe_result_add: tie split across z.lo & q.hi (fast-path returned z.hi)
+  { UP(0x1.e9319da0030aap+0, 0x1.1055p-55), UP(0x1.77d58p-54, 0x1.18ca6fb138p-106) },
+};
+
+// a tie value (m+ulp(m)/2) for m on [1,2) as a normalized pair. 'm'
+// is randomly odd or even so hi is either m or its successor.
+static inline fe_pair_t prng_fe_tie(void)
+{
+  uint64_t u = prng_u64();
+  uint64_t b = (u >> 12) ^ f64_one_bits_k;
+
+  if ((b & 1) == 0)
+    return fe_pair(type_pun(b,double), 0x1.0p-53);
+
+  return fe_pair(type_pun(b+1,double), -0x1.0p-53);
+}
+
+// unnormalized pair: |lo| on (2^-60,2^-30)|hi| & hi on [1,2)
+static inline fr_pair_t prng_fr_unnorm(void)
+{
+  double h = prng_fe_12().hi;
+  double s = ldexp(1.0, -(int)(30+(prng_u64() >> 59)*4));
+  double l = h*s*(prng_f64()-0.5);
+
+  return fr_pair(h,l);
+}
+
+// reference: 256-bit is more than enough for the generated inputs
+static mpfr_t mp_cr_a, mp_cr_b, mp_cr_r;
+
+static inline uint64_t cr_check(const char* name, double r, fe_pair_t a, fe_pair_t b)
+{
+  double e = mpfr_get_d(mp_cr_r, MPFR_RNDN);
+
+  if (r == e) return 0;
+  
+  printf("  %s : UP(%a,% a), UP(%a,% a) : r=%a e=%a\n", name, a.hi,a.lo, b.hi,b.lo, r,e);
+  return 1;
+}
+
+void cr_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\ncorrectly rounded → double : failures/trials\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("random",10) },
+      { REPORT_TABLE_U64("near-tie",10) },
+      { REPORT_TABLE_U64("tie",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  mpfr_init2(mp_cr_a, 256);
+  mpfr_init2(mp_cr_b, 256);
+  mpfr_init2(mp_cr_r, 256);
+
+  report_table_header(stdout, &table);
+  
+  for(size_t i=0; i<LENGTHOF(cr_pp); i++) {
+    cr_pp_table_t* t = cr_pp + i;
+    uint64_t fails[3] = {0};
+
+    // historic failures
+    for(size_t j=0; j<LENGTHOF(cr_pp_hard); j++) {
+      fe_pair_t a = cr_pp_hard[j][0];
+      fe_pair_t b = cr_pp_hard[j][1];
+      mp_set(mp_cr_a, a);
+      mp_set(mp_cr_b, b);
+      t->mp(mp_cr_r, mp_cr_a, mp_cr_b, MPFR_RNDN);
+      fails[1] += cr_check(t->name, t->f(a,b), a, b);
+    }
+
+    for(int j=0; j<TRIALS; j++) {
+      fe_pair_t a[3],b[3];
+      fe_pair_t m = prng_fe_tie();
+
+      a[0] = prng_fe_12();
+      b[0] = prng_fe();
+      b[1] = prng_fe_12();
+      a[1] = t->inv(m,b[1]);
+      a[2] = m;
+      b[2] = t->inv(fe_pair(1.0,0.0), fe_pair(1.0,0.0));
+
+      for(int k=0; k<3; k++) {
+        mp_set(mp_cr_a, a[k]);
+        mp_set(mp_cr_b, b[k]);
+        t->mp(mp_cr_r, mp_cr_a, mp_cr_b, MPFR_RNDN);
+        fails[k] += cr_check(t->name, t->f(a[k],b[k]), a[k], b[k]);
+      }
+    }
+    
+    report_table_row(stdout,&table, t->name, fails[0], fails[1], fails[2], (uint64_t)TRIALS);
+  }
+
+  // sqrt: no exact tie cases (tie squared isn't a pair)
+  {
+    uint64_t  fails[3] = {0};
+    fe_pair_t z = fe_pair(0,0);
+
+    for(int j=0; j<TRIALS; j++) {
+      fe_pair_t a[2];
+
+      a[0] = prng_fe_12();
+      a[1] = fe_sq_hq(prng_fe_tie());
+
+      for(int k=0; k<2; k++) {
+        mp_set(mp_cr_a, a[k]);
+        mpfr_sqrt(mp_cr_r, mp_cr_a, MPFR_RNDN);
+        fails[k] += cr_check("fe_result_sqrt", fe_result_sqrt(a[k]), a[k], z);
+      }
+    }
+    
+    report_table_row(stdout,&table, "fe_result_sqrt", fails[0], fails[1], fails[2], (uint64_t)TRIALS);
+  }
+
+  // fr: unnormalized inputs. near-tie/tie are: (m,q)+(ulp(m)/2-q, ±tiny)
+  // where 'm' is even and the tail of the tie is split across the
+  // components so neither input is normalized.
+  {
+    uint64_t fails[3] = {0};
+
+    for(int j=0; j<TRIALS; j++) {
+      fr_pair_t a[3],b[3];
+      fe_pair_t m = prng_fe_tie();
+      double    q = m.lo*0x1.0p-20*(double)(prng_u64() >> 44);
+
+      a[0] = prng_fr_unnorm();
+      b[0] = fr_neg(prng_fr_unnorm());
+      a[1] = fr_pair(m.hi, q);
+      b[1] = fr_pair(m.lo-q, (prng_f64()-0.5)*0x1.0p-90);
+      a[2] = a[1];
+      b[2] = fr_pair(b[1].hi, 0.0);
+
+      for(int k=0; k<3; k++) {
+        mp_set(mp_cr_a, fr2fe(a[k]));
+        mp_set(mp_cr_b, fr2fe(b[k]));
+        mpfr_add(mp_cr_r, mp_cr_a, mp_cr_b, MPFR_RNDN);
+        fails[k] += cr_check("fr_result_add", fr_result_add(a[k],b[k]), fr2fe(a[k]), fr2fe(b[k]));
+      }
+
+      mp_set(mp_cr_a, fr2fe(a[0]));
+      mpfr_add_d(mp_cr_r, mp_cr_a, b[1].hi, MPFR_RNDN);
+      fails[0] += cr_check("fr_result_add_d", fr_result_add_d(a[0],b[1].hi), fr2fe(a[0]), fe_pair(b[1].hi,0));
+    }
+    
+    report_table_row(stdout,&table, "fr_result_add", fails[0], fails[1], fails[2], (uint64_t)TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+// multiply by constant: fe_mul_k/fe_mul_k_d vs fe_mul/fe_mul_d.
+// error is WRT the pair value of the constant (not the real K)
+
+typedef struct {
+  const fe_pair_t* k;
+  char*            name;
+} const_k_table_t;
+
+const_k_table_t const_k[] =
+{
+  { &fe_k_pi,      "fe_k_pi"       },
+  { &fe_k_pi_i,    "fe_k_pi_i"     },
+  { &fe_k_log2,    "fe_k_log2"     },
+  { &fe_k_log2_i,  "fe_k_log2_i"   },
+  { &fe_k_log10,   "fe_k_log10"    },
+  { &fe_k_log10_i, "fe_k_log10_i"  },
+  { &fe_k_e,       "fe_k_e"        },
+  { &fe_k_e_i,     "fe_k_e_i"      },
+  { &fe_k_sqrt_2,  "fe_k_sqrt_2"   },
+  { &fe_k_sqrt_2_i,"fe_k_sqrt_2_i" },
+};
+
+#define CONST_K_BATCH 64
+
+void const_k_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nmultiply by constant → pair : peak ulp, hard = fe_mul_k_d hi isn't RN(Kx)\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("K",14), .just=report_table_justify_left },
+      { REPORT_TABLE_POS_F("fe_mul",1,4) },
+      { REPORT_TABLE_POS_F("fe_mul_k",1,4) },
+      { REPORT_TABLE_POS_F("fe_mul_d",1,4) },
+      { REPORT_TABLE_POS_F("fe_mul_k_d",1,4) },
+      { REPORT_TABLE_U64("hard",8) },
+      { REPORT_TABLE_U64("batch",8) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(size_t i=0; i<LENGTHOF(const_k); i++) {
+    fe_pair_t  kp = *const_k[i].k;
+    fe_const_t k  = fe_const_init(kp);
+    double     m[4] = {0};
+    uint64_t   hard = 0;
+    uint64_t   bad  = 0;
+
+    mp_set(mp_b,kp);
+
+    for(int j=0; j<TRIALS; j += CONST_K_BATCH) {
+      fe_pair_t x[CONST_K_BATCH], r[CONST_K_BATCH];
+      double    xd[CONST_K_BATCH];
+      fe_pair_t rd[CONST_K_BATCH];
+
+      for(int n=0; n<CONST_K_BATCH; n++) {
+        x[n]  = prng_fe();
+        xd[n] = prng_f64();
+      }
+
+      fe_mul_k_batch(x, CONST_K_BATCH, r, k);
+      fe_mul_k_d_batch(xd, CONST_K_BATCH, rd, k);
+
+      for(int n=0; n<CONST_K_BATCH; n++) {
+        fe_pair_t a = fe_mul_k(x[n],k);
+        fe_pair_t b = fe_mul_k_d(xd[n],k);
+
+        bad += !fe_eq(a,r[n]) || !fe_eq(b,rd[n]);
+
+        mp_set(mp_a,x[n]);
+        mpfr_mul(mp_r0,mp_a,mp_b,MPFR_RNDN);
+        m[0] = fmax(m[0], ulp_dist(mp_r0, fe_mul(x[n],kp)));
+        m[1] = fmax(m[1], ulp_dist(mp_r0, a));
+
+        mpfr_mul_d(mp_r0,mp_b,xd[n],MPFR_RNDN);
+        m[2] = fmax(m[2], ulp_dist(mp_r0, fe_mul_d(kp,xd[n])));
+        m[3] = fmax(m[3], ulp_dist(mp_r0, b));
+        hard += (b.hi != mpfr_get_d(mp_r0,MPFR_RNDN));
+      }
+    }
+
+    report_table_row(stdout,&table, const_k[i].name, m[0], m[1], m[2], m[3], hard, bad);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+// precomputed divisor: fe_div_pre/fe_d_div_pre vs fe_div/fe_d_div.
+// random divisors, each used for a block of numerators
+
+#define DIV_PRE_BLOCK 64
+
+void div_pre_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\ndivide by precomputed divisor → pair : peak ulp\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("y",14), .just=report_table_justify_left },
+      { REPORT_TABLE_POS_F("fe_div",1,4) },
+      { REPORT_TABLE_POS_F("fe_div_pre",1,4) },
+      { REPORT_TABLE_POS_F("fe_d_div",1,4) },
+      { REPORT_TABLE_POS_F("fe_d_div_pre",1,4) },
+      { REPORT_TABLE_U64("batch",8) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  // y ∈ [1,2) and y ∈ [0,1)
+  for(int s=0; s<2; s++) {
+    double   m[4] = {0};
+    uint64_t bad  = 0;
+
+    for(int j=0; j<TRIALS; j += DIV_PRE_BLOCK) {
+      fe_pair_t    y = (s == 0) ? prng_fe_12() : prng_fe();
+      fe_divisor_t d = fe_divisor_init(y);
+      fe_pair_t    x[DIV_PRE_BLOCK], r[DIV_PRE_BLOCK], rd[DIV_PRE_BLOCK];
+      double       xd[DIV_PRE_BLOCK];
+
+      for(int n=0; n<DIV_PRE_BLOCK; n++) {
+        x[n]  = prng_fe_12();
+        xd[n] = 2.0*prng_f64()+1.0;
+      }
+
+      fe_div_pre_batch(x, DIV_PRE_BLOCK, r, d);
+      fe_d_div_pre_batch(xd, DIV_PRE_BLOCK, rd, d);
+
+      mp_set(mp_b,y);
+
+      for(int n=0; n<DIV_PRE_BLOCK; n++) {
+        fe_pair_t a = fe_div_pre(x[n],d);
+        fe_pair_t b = fe_d_div_pre(xd[n],d);
+
+        bad += !fe_eq(a,r[n]) || !fe_eq(b,rd[n]);
+
+        mp_set(mp_a,x[n]);
+        mpfr_div(mp_r0,mp_a,mp_b,MPFR_RNDN);
+        m[0] = fmax(m[0], ulp_dist(mp_r0, fe_div(x[n],y)));
+        m[1] = fmax(m[1], ulp_dist(mp_r0, a));
+
+        mpfr_d_div(mp_r0,xd[n],mp_b,MPFR_RNDN);
+        m[2] = fmax(m[2], ulp_dist(mp_r0, fe_d_div(xd[n],y)));
+        m[3] = fmax(m[3], ulp_dist(mp_r0, b));
+      }
+    }
+
+    report_table_row(stdout,&table, (s == 0) ? "[1,2)" : "[0,1)", m[0], m[1], m[2], m[3], bad);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+// fused multiply-add: xy+z vs. the composed add(mul(x,y),z)
+// x,y ∈ [1,2), z ∈ [0,1) and z ∈ -[0,1/2) (so |xy+z| ≥ 1/2)
+
+static fe_pair_t fe_fma_x(fe_pair_t x, fe_pair_t y, fe_pair_t z)   { return fe_add(fe_mul(x,y),z); }
+static fe_pair_t fe_fma_d_x(fe_pair_t x, double y, fe_pair_t z)    { return fe_add(fe_mul_d(x,y),z); }
+static fr_pair_t fr_fma_x(fr_pair_t x, fr_pair_t y, fr_pair_t z)   { return fr_add(fr_mul(x,y),z); }
+static fr_pair_t fr_fma_d_x(fr_pair_t x, double y, fr_pair_t z)    { return fr_add(fr_mul_d(x,y),z); }
+
+void fma_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nf(pair,pair,pair) → pair : xy+z peak ulp (fused vs. composed)\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_POS_F("z>0",1,4) },
+      { REPORT_TABLE_POS_F("z<0",1,4) },
+      { REPORT_TABLE_POS_F("composed z>0",1,4) },
+      { REPORT_TABLE_POS_F("composed z<0",1,4) },
+    }
+  };
+
+  static const char* name[] = {"fe_fma", "fe_fma_d", "fr_fma", "fr_fma_d", "fe_fma_a", "fe_fma_d_a"};
+
+  report_table_header(stdout, &table);
+
+  for(int f=0; f<6; f++) {
+    double m[4] = {0};
+
+    for(int j=0; j<TRIALS; j++) {
+      fe_pair_t x  = prng_fe_12();
+      fe_pair_t y  = prng_fe_12();
+      fe_pair_t z  = prng_fe();
+      double    yd = y.hi;
+
+      if (f & 1) y = fe_set_d(yd);
+
+      mp_set(mp_a,x);
+      mp_set(mp_b,y);
+      mpfr_mul(mp_t,mp_a,mp_b,MPFR_RNDN);  // exact at 128-bits
+
+      for(int s=0; s<2; s++) {
+        fe_pair_t r,c;
+
+        mp_set(mp_c,z);
+        mpfr_add(mp_r0,mp_t,mp_c,MPFR_RNDN);
+
+        switch(f) {
+          case 0:  r = fe_fma(x,y,z);    c = fe_fma_x(x,y,z);    break;
+          case 1:  r = fe_fma_d(x,yd,z); c = fe_fma_d_x(x,yd,z); break;
+          case 2:  r = fr2fe(fr_fma(fe2fr(x),fe2fr(y),fe2fr(z)));   c = fr2fe(fr_fma_x(fe2fr(x),fe2fr(y),fe2fr(z)));   break;
+          case 3:  r = fr2fe(fr_fma_d(fe2fr(x),yd,fe2fr(z)));       c = fr2fe(fr_fma_d_x(fe2fr(x),yd,fe2fr(z)));       break;
+          case 4:  r = fe_fma_a(x,y,z);    c = fe_fma_x(x,y,z);    break;
+          default: r = fe_fma_d_a(x,yd,z); c = fe_fma_d_x(x,yd,z); break;
+        }
+
+        // ulp_dist uses mp_t as scratch: recompute the product after
+        m[s]   = fmax(m[s],   ulp_dist(mp_r0,r));
+        m[s+2] = fmax(m[s+2], ulp_dist(mp_r0,c));
+
+        mpfr_mul(mp_t,mp_a,mp_b,MPFR_RNDN);
+        z = fe_neg(fe_mul_pot(0.5,z));
+      }
+    }
+
+    report_table_row(stdout,&table, name[f], m[0], m[1], m[2], m[3]);
+  }
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+// rounding & remainders : exactness (failures/trials)
+
+static mpfr_t mp_ri_a, mp_ri_b, mp_ri_r, mp_ri_c;
+
+static inline fe_pair_t prng_fe_sign(fe_pair_t x)
+{
+  return (prng_u32() & 1) ? fe_neg(x) : x;
+}
+
+// inputs for the rounding functions:
+//   0: x ∈ ±[0,1)·2^k for k ∈ [0,110]
+//   1: integer 'hi' and lo ∈ {±1/2, ±1/4, ±(j+1/2)} (ties & near ties)
+//   2: hi half-integer and lo ∈ {0, ±tiny}
+static fe_pair_t prng_fe_rounding(int c)
+{
+  uint32_t u = prng_u32();
+
+  switch(c) {
+    case 0:
+      return prng_fe_sign(fe_ldexp(prng_fe(), (int)(u % 111)));
+
+    case 1: {
+      double h = (u & 1) ? (double)(prng_u64() >> 11) : (double)(prng_u64() >> 40);
+      double l = ((u >> 1) & 1) ? 0.5 : 0.25;
+
+      if (h >= 0x1.0p53) { h = ldexp(h,(int)(u >> 8) % 20); l += (double)((u >> 16) & 0xff); }
+      if ((u >> 2) & 1) l = -l;
+      if (h == 0.0) h = 1.0;
+
+      return prng_fe_sign(fe_fast_sum(h,l));
+    }
+
+    default: {
+      double h = (double)(prng_u64() >> (12 + (u % 40))) + 0.5;
+      double l = ((u >> 8) & 1) ? 0.0 : ldexp(0.25,-52-(int)((u >> 9) & 7));
+
+      if ((u >> 12) & 1) l = -l;
+
+      return prng_fe_sign(fe_fast_sum(h,l));
+    }
+  }
+}
+
+static inline uint64_t rounding_check(const char* name, fe_pair_t x, fe_pair_t r)
+{
+  mp_set(mp_ri_c, r);
+
+  if (mpfr_cmp(mp_ri_c, mp_ri_r) == 0 && fe_eq(r, fe_fast_sum(r.hi,r.lo))) return 0;
+
+  printf("  %s : UP(%a,% a) : r=UP(%a,% a)\n", name, x.hi,x.lo, r.hi,r.lo);
+  return 1;
+}
+
+static int mpfr_nearbyint(mpfr_t r, const mpfr_t x) { return mpfr_rint(r,x,MPFR_RNDN); }
+
+void rounding_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nrounding & remainders → pair : exact failures/trials\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("random",10) },
+      { REPORT_TABLE_U64("ties",10) },
+      { REPORT_TABLE_U64("halves",10) },
+      { REPORT_TABLE_U64("batch",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  static const struct {
+    fe_pair_t (*f)(fe_pair_t);
+    void      (*b)(const fe_pair_t*, size_t, fe_pair_t*);
+    int       (*mp)(mpfr_t, const mpfr_t);
+    char*     name;
+  } op[] = {
+    { fe_floor,     fe_floor_batch,     mpfr_floor,     "fe_floor"     },
+    { fe_ceil,      fe_ceil_batch,      mpfr_ceil,      "fe_ceil"      },
+    { fe_trunc,     fe_trunc_batch,     mpfr_trunc,     "fe_trunc"     },
+    { fe_round,     fe_round_batch,     mpfr_round,     "fe_round"     },
+    { fe_nearbyint, fe_nearbyint_batch, mpfr_nearbyint, "fe_nearbyint" },
+  };
+
+  mpfr_init2(mp_ri_a, 320);
+  mpfr_init2(mp_ri_b, 320);
+  mpfr_init2(mp_ri_r, 320);
+  mpfr_init2(mp_ri_c, 320);
+
+  report_table_header(stdout, &table);
+
+  for(size_t i=0; i<LENGTHOF(op); i++) {
+    uint64_t fails[4] = {0};
+
+    for(int j=0; j<TRIALS; j += 16) {
+      fe_pair_t x[16], r[16];
+
+      for(int c=0; c<3; c++) {
+        for(int k=0; k<16; k++) x[k] = prng_fe_rounding(c);
+
+        op[i].b(x,16,r);
+
+        for(int k=0; k<16; k++) {
+          mp_set(mp_ri_a, x[k]);
+          op[i].mp(mp_ri_r, mp_ri_a);
+          fails[c] += rounding_check(op[i].name, x[k], op[i].f(x[k]));
+          fails[3] += !fe_eq(r[k], op[i].f(x[k]));
+        }
+      }
+    }
+
+    report_table_row(stdout,&table, op[i].name, fails[0], fails[1], fails[2], fails[3], (uint64_t)TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+
+  // remainders: x ∈ ±[0,1)·2^k for k ∈ [0,120], y ∈ ±[1,2)·2^j for j ∈ [-4,4]
+  // (pair and double). 1 in 8 are shifted to k+900 and j-900 so x/y
+  // overflows. only results representable as a pair are required to
+  // be exact (the rest are counted)
+  table = (report_table_t){
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("pair y",10) },
+      { REPORT_TABLE_U64("double y",10) },
+      { REPORT_TABLE_U64("quo/batch",10) },
+      { REPORT_TABLE_U64("not pair",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int f=0; f<2; f++) {
+    uint64_t fails[3] = {0};
+    uint64_t skip     = 0;
+
+    for(int j=0; j<TRIALS; j++) {
+      uint32_t  u = prng_u32();
+      int       g = ((u >> 16) & 7) ? 0 : 900;
+      fe_pair_t x = prng_fe_sign(fe_ldexp(prng_fe(), (int)(u % 121)+g));
+      fe_pair_t y = prng_fe_sign(fe_ldexp(prng_fe_12(), (int)((u >> 8) % 9)-4-g));
+
+      for(int c=0; c<2; c++) {
+        fe_pair_t r;
+        int       q = 0;
+        long      e = 0;
+
+        if (c) y = fe_set_d(y.hi);
+
+        mp_set(mp_ri_a, x);
+        mp_set(mp_ri_b, y);
+
+        if (f == 0) {
+          mpfr_fmod(mp_ri_r, mp_ri_a, mp_ri_b, MPFR_RNDN);
+          r = fe_fmod(x,y);
+          fe_pair_t b;
+          fe_fmod_batch(&x,1,&b,y);
+          fails[2] += !fe_eq(r,b);
+        }
+        else {
+          mpfr_remquo(mp_ri_r, &e, mp_ri_a, mp_ri_b, MPFR_RNDN);
+          r = fe_remquo(x,y,&q);
+          e = (e < 0) ? -(-e & 7) : (e & 7);
+          fails[2] += (q != (int)e);
+        }
+
+        // skip if the exact result isn't a pair
+        fe_pair_t t = mp2fe(mp_ri_r);
+        mp_set(mp_ri_c, t);
+
+        if (mpfr_cmp(mp_ri_c, mp_ri_r) != 0) { skip++; continue; }
+
+        fails[c] += rounding_check((f == 0) ? "fe_fmod" : "fe_remquo", x, r);
+      }
+    }
+
+    report_table_row(stdout,&table, (f == 0) ? "fe_fmod" : "fe_remquo", fails[0], fails[1], fails[2], skip, (uint64_t)TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+
+  // frexp/ldexp round trip
+  {
+    uint64_t fails = 0;
+
+    for(int j=0; j<TRIALS; j++) {
+      fe_pair_t x = prng_fe_rounding((int)(prng_u32() % 3));
+      int       e;
+      fe_pair_t m = fe_frexp(x,&e);
+      double    a = fabs(m.hi);
+      int       d = m.hi*m.lo < 0.0;   // |m| < |m.hi|
+
+      // 1/2 <= |m| < 1 exactly (hi+lo in double can round to 1)
+      fails += !fe_eq(fe_ldexp(m,e), x) || !(a > 0.5 || (a == 0.5 && !d)) || !(a < 1.0 || (a == 1.0 && d));
+    }
+
+    printf("fe_frexp/fe_ldexp round trip failures: %lu/%lu\n", fails, (uint64_t)TRIALS);
+  }
+}
+
+//**********************************************************
+// comparisons & min/max : failures/trials
+
+// 'y' relative to 'x' to hit the interesting cases:
+//   0: independent, 1: y = x, 2: same 'hi' (random 'lo'), 3: adjacent 'hi',
+//   4: -x, 5: signed zero, 6: NaN
+static fe_pair_t prng_fe_cmp(fe_pair_t x)
+{
+  uint32_t u = prng_u32();
+  double   d = isfinite(x.hi) && x.hi != 0.0 ? ldexp(1.0, ilogb(x.hi)-53) : 0.0;
+
+  switch(u % 7) {
+    case 0:  return prng_fe_sign(prng_fe());
+    case 1:  return x;
+    case 2:  return fe_fast_sum(x.hi, (2.0*prng_f64()-1.0)*d);
+    case 3:  return fe_fast_sum(nextafter(x.hi, ((u >> 8) & 1) ? INFINITY : -INFINITY), (2.0*prng_f64()-1.0)*d);
+    case 4:  return fe_neg(x);
+    case 5:  return fe_set_d(((u >> 8) & 1) ? 0.0 : -0.0);
+    default: return ((u >> 8) & 3) ? prng_fe_sign(prng_fe()) : fe_pair(NAN,NAN);
+  }
+}
+
+// -2 unordered, otherwise sign of x-y
+static int cmp_ref(fe_pair_t x, fe_pair_t y)
+{
+  if (isnan(x.hi) || isnan(y.hi)) return -2;
+
+  mp_set(mp_ri_a, x);
+  mp_set(mp_ri_b, y);
+
+  int c = mpfr_cmp(mp_ri_a, mp_ri_b);
+
+  return (c > 0) - (c < 0);
+}
+
+// same value (or both NaN)
+static bool cmp_same(fe_pair_t x, fe_pair_t y)
+{
+  return (isnan(x.hi) && isnan(y.hi)) || cmp_ref(x,y) == 0;
+}
+
+static fe_pair_t fe_min_ref(fe_pair_t x, fe_pair_t y)
+{
+  if (isnan(x.hi)) return y;
+  if (isnan(y.hi)) return x;
+  return (cmp_ref(y,x) < 0) ? y : x;
+}
+
+static fe_pair_t fe_max_ref(fe_pair_t x, fe_pair_t y)
+{
+  if (isnan(x.hi)) return y;
+  if (isnan(y.hi)) return x;
+  return (cmp_ref(y,x) > 0) ? y : x;
+}
+
+#define CMP_N 67
+
+void compare_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\ncomparisons : failures/trials\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("fails",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  static const char* name[] = {
+    "fe_eq", "fe_ne", "fe_lt", "fe_le", "fe_gt", "fe_ge", "fe_cmp", "fe_sign",
+    "fe_min", "fe_max", "fe_clamp"
+  };
+
+  uint64_t fails[LENGTHOF(name)] = {0};
+
+  mpfr_init2(mp_ri_a, 320);
+  mpfr_init2(mp_ri_b, 320);
+
+  for(int j=0; j<TRIALS; j++) {
+    fe_pair_t x = prng_fe_sign(fe_ldexp(prng_fe(), (int)(prng_u32() % 64)-32));
+    fe_pair_t y = prng_fe_cmp(x);
+    fe_pair_t a = prng_fe_cmp(x);
+    fe_pair_t b = prng_fe_cmp(x);
+    int       c = cmp_ref(x,y);
+    int       s = isnan(x.hi) ? 0 : (x.hi > 0.0) - (x.hi < 0.0);
+
+    fails[0] += fe_eq(x,y) != (c ==  0);
+    fails[1] += fe_ne(x,y) != (c !=  0);
+    fails[2] += fe_lt(x,y) != (c == -1);
+    fails[3] += fe_le(x,y) != (c == -1 || c == 0);
+    fails[4] += fe_gt(x,y) != (c ==  1);
+    fails[5] += fe_ge(x,y) != (c ==  1 || c == 0);
+    fails[6] += fe_cmp(x,y) != ((c == -2) ? 0 : c);
+    fails[7] += fe_sign(x) != s;
+    fails[8] += !cmp_same(fe_min(x,y), fe_min_ref(x,y));
+    fails[9] += !cmp_same(fe_max(x,y), fe_max_ref(x,y));
+
+    // clamp to [a,b] (ordered)
+    if (isnan(a.hi) || isnan(b.hi)) continue;
+    if (cmp_ref(a,b) > 0) { fe_pair_t t = a; a = b; b = t; }
+
+    fe_pair_t r = isnan(x.hi) ? x : (cmp_ref(x,a) < 0) ? a : (cmp_ref(x,b) > 0) ? b : x;
+
+    fails[10] += !cmp_same(fe_clamp(x,a,b), r);
+  }
+
+  report_table_header(stdout, &table);
+
+  for(size_t i=0; i<LENGTHOF(name); i++)
+    report_table_row(stdout,&table, name[i], fails[i], (uint64_t)TRIALS);
+
+  report_table_end(stdout, &table);
+
+  // SoA array kernels vs. the scalar reference: arrays of 0 to CMP_N-1
+  // elements with repeats (ties for the index) and NaNs
+  static const char* aname[] = {
+    "fe_min_soa", "fe_max_soa", "fe_argmin_soa", "fe_argmax_soa", "fe_{cmp}_soa"
+  };
+
+  uint64_t afails[LENGTHOF(aname)] = {0};
+  uint64_t trials = (uint64_t)TRIALS/16;
+
+  for(uint64_t j=0; j<trials; j++) {
+    double    hi[CMP_N], lo[CMP_N];
+    uint8_t   m[CMP_N];
+    size_t    n = (size_t)(prng_u32() % CMP_N);
+    fe_pair_t x = prng_fe_sign(prng_fe());
+
+    for(size_t i=0; i<n; i++) {
+      x = prng_fe_cmp(x);
+      hi[i] = x.hi;
+      lo[i] = x.lo;
+    }
+
+    fe_pair_t rmin = fe_pair(NAN,NAN);
+    fe_pair_t rmax = fe_pair(NAN,NAN);
+    size_t    imin = n, imax = n;
+
+    for(size_t i=0; i<n; i++) {
+      fe_pair_t e = fe_pair(hi[i],lo[i]);
+
+      if (isnan(e.hi)) continue;
+      if (imin == n || cmp_ref(e,rmin) < 0) { rmin = e; imin = i; }
+      if (imax == n || cmp_ref(e,rmax) > 0) { rmax = e; imax = i; }
+    }
+
+    afails[0] += !cmp_same(fe_min_soa(hi,lo,n), rmin);
+    afails[1] += !cmp_same(fe_max_soa(hi,lo,n), rmax);
+    afails[2] += fe_argmin_soa(hi,lo,n) != imin;
+    afails[3] += fe_argmax_soa(hi,lo,n) != imax;
+
+    // masked compares against an element (or a random value)
+    fe_pair_t y = (n && (j & 1)) ? fe_pair(hi[j % n], lo[j % n]) : prng_fe_sign(prng_fe());
+    size_t    k[6];
+    bool      ok = true;
+
+    k[0] = fe_lt_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_lt(fe_pair(hi[i],lo[i]),y);
+    k[1] = fe_le_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_le(fe_pair(hi[i],lo[i]),y);
+    k[2] = fe_gt_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_gt(fe_pair(hi[i],lo[i]),y);
+    k[3] = fe_ge_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_ge(fe_pair(hi[i],lo[i]),y);
+    k[4] = fe_eq_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_eq(fe_pair(hi[i],lo[i]),y);
+    k[5] = fe_ne_soa(hi,lo,n,m,y);  for(size_t i=0; i<n; i++) ok &= m[i] == fe_ne(fe_pair(hi[i],lo[i]),y);
+
+    // counts: lt+ge and gt+le are the ordered elements, eq+ne all
+    size_t u = 0;
+
+    for(size_t i=0; i<n; i++) u += !isnan(hi[i]) && !isnan(y.hi);
+
+    ok &= (k[0]+k[3] == u) && (k[2]+k[1] == u) && (k[4]+k[5] == n);
+
+    afails[4] += !ok;
+  }
+
+  report_table_header(stdout, &table);
+
+  for(size_t i=0; i<LENGTHOF(aname); i++)
+    report_table_row(stdout,&table, aname[i], afails[i], trials);
+
+  report_table_end(stdout, &table);
+}
+
+//**********************************************************
+// integer conversions : failures/trials
+
+#if defined(__SIZEOF_INT128__)
+
+static void mp_set_u128(mpfr_t r, unsigned __int128 x)
+{
+  mpfr_set_d(r, 0.0, MPFR_RNDN);
+
+  for(int i=3; i>=0; i--) {
+    mpfr_mul_2si(r, r, 32, MPFR_RNDN);
+    mpfr_add_d  (r, r, (double)(uint32_t)(x >> (32*i)), MPFR_RNDN);
+  }
+}
+
+static void mp_set_i128(mpfr_t r, __int128 x)
+{
+  mp_set_u128(r, (x < 0) ? -(unsigned __int128)x : (unsigned __int128)x);
+
+  if (x < 0) mpfr_neg(r, r, MPFR_RNDN);
+}
+
+// random with 0 to 128 significant bits
+static unsigned __int128 prng_u128(void)
+{
+  unsigned __int128 x = ((unsigned __int128)prng_u64() << 64) | prng_u64();
+  uint32_t          k = prng_u32() % 129;
+
+  return (k == 0) ? 0 : x >> (128-k);
+}
+
+// 'c' vs. 'mp_ri_r' correctly rounded to a pair: hi = RN(x), lo = RN(x-hi)
+// (which is exact when x is a pair)
+static uint64_t int_conv_check(fe_pair_t c)
+{
+  double h = mpfr_get_d(mp_ri_r, MPFR_RNDN);
+
+  mpfr_sub_d(mp_ri_c, mp_ri_r, h, MPFR_RNDN);
+
+  return (c.hi != h) || (c.lo != mpfr_get_d(mp_ri_c, MPFR_RNDN));
+}
+
+// saturated truncation of 'mp_ri_a' to [lo,hi] in 'mp_ri_r'
+static void mp_trunc_sat(const mpfr_t lo, const mpfr_t hi)
+{
+  mpfr_trunc(mp_ri_r, mp_ri_a);
+
+  if (mpfr_cmp(mp_ri_r, lo) < 0) mpfr_set(mp_ri_r, lo, MPFR_RNDN);
+  if (mpfr_cmp(mp_ri_r, hi) > 0) mpfr_set(mp_ri_r, hi, MPFR_RNDN);
+}
+
+// pairs for the to-integer conversions: ±[0,1)·2^k for k ∈ [0,130] and
+// the edges of the ranges
+static fe_pair_t prng_fe_int(void)
+{
+  static const fe_pair_t edge[] = {
+    {0x1.0p127,0}, {0x1.0p127,-1}, {0x1.0p127,-0x1.0p73}, {0x1.0p127,0.5}, {0x1.0p127,-0.5},
+    {0x1.0p128,0}, {0x1.0p128,-1}, {0x1.0p128,-0x1.0p74}, {0x1.0p128,-0.5},
+    {0x1.fffffffffffffp126,0x1.0p72}, {0x1.fffffffffffffp127,0x1.0p73},
+    {0x1.0p-3,0}, {INFINITY,0}, {NAN,NAN}, {0,0}, {-0.0,0},
+  };
+
+  uint32_t u = prng_u32();
+
+  if ((u & 7) == 0) return prng_fe_sign(edge[(u >> 3) % LENGTHOF(edge)]);
+
+  return prng_fe_sign(fe_ldexp(prng_fe(), (int)((u >> 3) % 131)));
+}
+
+void int_conv_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\ninteger conversions : failures/trials\n" SGR_RESET);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("< 2^106",10) },
+      { REPORT_TABLE_U64("larger",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  mpfr_t mp_min, mp_max;
+
+  mpfr_init2(mp_min,  320);
+  mpfr_init2(mp_max,  320);
+  mpfr_init2(mp_ri_a, 320);
+  mpfr_init2(mp_ri_r, 320);
+  mpfr_init2(mp_ri_c, 320);
+
+  report_table_header(stdout, &table);
+
+  // from: correctly rounded (exact below 2^106)
+  {
+    uint64_t fails[2][2] = {{0}};
+
+    for(int j=0; j<TRIALS; j++) {
+      unsigned __int128 u = prng_u128();
+      __int128          s = (__int128)(u >> 1);
+
+      if (prng_u32() & 1) s = -s-(__int128)(u & 1);
+
+      mp_set_u128(mp_ri_r, u);
+      int e = (u >> 106) == 0;
+      fails[0][!e] += int_conv_check(fe_from_u128(u));
+
+      mp_set_i128(mp_ri_r, s);
+      e = (s < 0 ? -(unsigned __int128)s : (unsigned __int128)s) >> 106 == 0;
+      fails[1][!e] += int_conv_check(fe_from_i128(s));
+    }
+
+    report_table_row(stdout,&table, "fe_from_u128", fails[0][0], fails[0][1], (uint64_t)TRIALS);
+    report_table_row(stdout,&table, "fe_from_i128", fails[1][0], fails[1][1], (uint64_t)TRIALS);
+  }
+
+  // to: saturated truncation (split by the magnitude of x)
+  {
+    uint64_t fails[2][2] = {{0}};
+
+    for(int j=0; j<TRIALS; j++) {
+      fe_pair_t x = prng_fe_int();
+      int       b = !(fabs(x.hi) < 0x1.0p106);
+
+      if (isnan(x.hi)) {
+        fails[0][b] += fe_to_u128(x) != 0;
+        fails[1][b] += fe_to_i128(x) != (__int128)((unsigned __int128)1 << 127);
+        continue;
+      }
+
+      mp_set(mp_ri_a, x);
+
+      mpfr_set_d(mp_min, 0.0, MPFR_RNDN);
+      mp_set_u128(mp_max, ~(unsigned __int128)0);
+      mp_trunc_sat(mp_min, mp_max);
+      mp_set_u128(mp_ri_c, fe_to_u128(x));
+      fails[0][b] += mpfr_cmp(mp_ri_c, mp_ri_r) != 0;
+
+      mp_set_i128(mp_max, (__int128)(~(unsigned __int128)0 >> 1));
+      mpfr_neg(mp_min, mp_max, MPFR_RNDN);
+      mpfr_sub_d(mp_min, mp_min, 1.0, MPFR_RNDN);
+      mp_trunc_sat(mp_min, mp_max);
+      mp_set_i128(mp_ri_c, fe_to_i128(x));
+      fails[1][b] += mpfr_cmp(mp_ri_c, mp_ri_r) != 0;
+    }
+
+    report_table_row(stdout,&table, "fe_to_u128", fails[0][0], fails[0][1], (uint64_t)TRIALS);
+    report_table_row(stdout,&table, "fe_to_i128", fails[1][0], fails[1][1], (uint64_t)TRIALS);
+  }
+
+  // 64-bit batch forms: always exact
+  {
+    uint64_t fails[2] = {0};
+
+    for(int j=0; j<TRIALS; j += 16) {
+      uint64_t  u[16];
+      int64_t   s[16];
+      fe_pair_t ru[16], rs[16];
+
+      for(int k=0; k<16; k++) {
+        u[k] = prng_u64() >> (prng_u32() % 64);
+        s[k] = (int64_t)(prng_u64() >> (prng_u32() % 64));
+        if (k == 0) { u[k] = UINT64_MAX; s[k] = INT64_MIN; }
+      }
+
+      fe_from_u64_batch(u,16,ru);
+      fe_from_i64_batch(s,16,rs);
+
+      for(int k=0; k<16; k++) {
+        mp_set_u128(mp_ri_r, u[k]);
+        fails[0] += int_conv_check(ru[k]) || !fe_eq(ru[k], fe_from_u64(u[k]));
+        mp_set_i128(mp_ri_r, s[k]);
+        fails[1] += int_conv_check(rs[k]) || !fe_eq(rs[k], fe_from_i64(s[k]));
+      }
+    }
+
+    report_table_row(stdout,&table, "fe_from_u64", fails[0], (uint64_t)0, (uint64_t)TRIALS);
+    report_table_row(stdout,&table, "fe_from_i64", fails[1], (uint64_t)0, (uint64_t)TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+
+  mpfr_clear(mp_min);
+  mpfr_clear(mp_max);
+}
+
+#endif
+
+//**********************************************************
+// narrowing conversions: failures/trials
+
+// binary formats: 'p' significand bits, MPFR style exponents: finite
+// values are m·2^e with m ∈ [1/2,1) and e ∈ [emin,emax] (subnormals
+// counted)
+typedef struct { const char* name; int p; int emin; int emax; } narrow_fmt_t;
+
+static const narrow_fmt_t narrow_fmt[] = {
+  { "fe_to_f32",  24, -148, 128 },
+  { "fe_to_bf16",  8, -132, 128 },
+  { "fe_to_f16",  11,  -23,  16 },
+};
+
+static double bf16_to_d(uint16_t x)
+{
+  uint32_t u = (uint32_t)x << 16;
+  float    f;
+  memcpy(&f, &u, 4);
+  return f;
+}
+
+static double f16_to_d(uint16_t x)
+{
+  double s = (x & 0x8000) ? -1.0 : 1.0;
+  int    e = (x >> 10) & 0x1f;
+  int    m = x & 0x3ff;
+
+  if (e == 0x1f) return (m == 0) ? s*INFINITY : NAN;
+  if (e == 0)    return s*ldexp(m, -24);
+
+  return s*ldexp(1024+m, e-25);
+}
+
+// narrowed 'x' (index 'f' into narrow_fmt) as a double. 'q' is set when
+// the encoding is a quiet NaN
+static double narrow_to_d(int f, fe_pair_t x, bool* q)
+{
+  uint16_t r;
+
+  switch(f) {
+    case 0:  *q = isnan(fe_to_f32(x)); return fe_to_f32(x);
+    case 1:  r = fe_to_bf16(x); *q = (r & 0x7fc0) == 0x7fc0; return bf16_to_d(r);
+    default: r = fe_to_f16(x);  *q = (r & 0x7e00) == 0x7e00; return f16_to_d(r);
+  }
+}
+
+// 'mp_ri_a' correctly rounded to the format 'f' in 'mp_ri_r': round to
+// a multiple of the ulp 2^k (fixed for subnormals) then overflow.
+// infinities & zeros pass through
+static void mp_narrow(const narrow_fmt_t* f)
+{
+  mpfr_set(mp_ri_r, mp_ri_a, MPFR_RNDN);
+
+  if (mpfr_zero_p(mp_ri_a) || mpfr_cmpabs(mp_ri_a, mp_ri_c) > 0) return;
+
+  long e = (long)mpfr_get_exp(mp_ri_a);
+  long k = (e-f->p > f->emin-1) ? e-f->p : f->emin-1;
+
+  mpfr_mul_2si(mp_ri_r, mp_ri_r, -k, MPFR_RNDN);
+  mpfr_rint   (mp_ri_r, mp_ri_r, MPFR_RNDN);
+  mpfr_mul_2si(mp_ri_r, mp_ri_r,  k, MPFR_RNDN);
+
+  mpfr_set_d(mp_ri_c, ldexp(1.0, f->emax), MPFR_RNDN);
+
+  if (mpfr_cmpabs(mp_ri_r, mp_ri_c) >= 0)
+    mpfr_set_d(mp_ri_r, copysign(INFINITY, mpfr_get_d(mp_ri_r, MPFR_RNDN)), MPFR_RNDN);
+}
+
+// inputs for format 'f':
+//   0: ±[0,1)·2^k with k from below the subnormals to past the range
+//   1: ties of the format in 'hi' and lo ∈ {0, ±tiny}: the double rounding cases
+//   2: edges: overflow threshold, smallest subnormals & normal, specials
+static fe_pair_t prng_fe_narrow(const narrow_fmt_t* f, int c)
+{
+  uint32_t u = prng_u32();
+
+  switch(c) {
+    case 0:
+      return prng_fe_sign(fe_ldexp(prng_fe(), f->emin-3 + (int)(u % (uint32_t)(f->emax-f->emin+5))));
+
+    case 1: {
+      int    e = f->emin-1 + (int)(u % (uint32_t)(f->emax-f->emin+2));
+      int    q = ((e-f->p > f->emin-1) ? e-f->p : f->emin-1) - 1;
+      double h = ldexp((double)(2*(prng_u64() >> (64-(e-q-1)))+1), q);
+      double l = ((u >> 24) & 1) ? 0.0 : ldexp(((u >> 25) & 1) ? 1.0 : -1.0, q-54-(int)((u >> 26) % 20));
+
+      return prng_fe_sign(fe_fast_sum(h,l));
+    }
+
+    default: {
+      double    m = ldexp(1.0, f->emax);
+      double    t = m - ldexp(1.0, f->emax-f->p-1);
+      double    s = ldexp(1.0, f->emin-2);
+      fe_pair_t edge[] = {
+        {m-ldexp(1.0,f->emax-f->p),0}, {t,0}, {t,-0x1.0p-60*t}, {t,0x1.0p-60*t}, {m,0},
+        {2*s,0}, {s,0}, {s,-0x1.0p-60*s}, {s,0x1.0p-60*s}, {ldexp(1.0,f->emin+f->p-2),-0x1.0p-60*s},
+        {INFINITY,0}, {NAN,NAN}, {0,0},
+      };
+
+      return prng_fe_sign(edge[(u >> 8) % LENGTHOF(edge)]);
+    }
+  }
+}
+
+void narrow_tests(void)
+{
+  printf(SGR_BOLD SGR_RGB(200,200,255) "\nnarrowing conversions : failures/trials\n" SGR_RESET);
+
+  mpfr_init2(mp_ri_a, 320);
+  mpfr_init2(mp_ri_r, 320);
+  mpfr_init2(mp_ri_c, 320);
+
+  report_table_t table = {
+    .col = {
+      { REPORT_TABLE_STR("f",14), .just=report_table_justify_left },
+      { REPORT_TABLE_U64("random",10) },
+      { REPORT_TABLE_U64("ties",10) },
+      { REPORT_TABLE_U64("edges",10) },
+      { REPORT_TABLE_U64("batch",10) },
+      { REPORT_TABLE_U64("trials",10) },
+    }
+  };
+
+  report_table_header(stdout, &table);
+
+  for(int i=0; i<(int)LENGTHOF(narrow_fmt); i++) {
+    const narrow_fmt_t* f = narrow_fmt+i;
+    uint64_t fails[4] = {0};
+
+    for(int j=0; j<TRIALS; j++) {
+      for(int c=0; c<3; c++) {
+        fe_pair_t x = prng_fe_narrow(f,c);
+        bool      q;
+        double    r = narrow_to_d(i,x,&q);
+
+        if (isnan(x.hi)) { fails[c] += !q; continue; }
+
+        mpfr_set_d(mp_ri_c, 0x1.fffffffffffffp1023, MPFR_RNDN);
+        mp_set(mp_ri_a, x);
+        mp_narrow(f);
+
+        double v = mpfr_get_d(mp_ri_r, MPFR_RNDN);
+
+        if (r == v && signbit(r) == signbit(v)) continue;
+
+        if (fails[c] < 4)
+          printf("  %s : UP(%a,% a) : r=%a (expected %a)\n", f->name, x.hi,x.lo, r, v);
+
+        fails[c]++;
+      }
+    }
+
+    // batch vs. scalar (bit patterns)
+    for(int j=0; j<TRIALS/16; j++) {
+      fe_pair_t x[16];
+      float     r32[16];
+      uint16_t  r16[16];
+
+      for(int k=0; k<16; k++) x[k] = prng_fe_narrow(f,k%3);
+
+      switch(i) {
+        case 0:
+          fe_to_f32_batch(x,16,r32);
+          for(int k=0; k<16; k++) { float v = fe_to_f32(x[k]); fails[3] += memcmp(r32+k, &v, 4) != 0; }
+          break;
+
+        case 1:
+          fe_to_bf16_batch(x,16,r16);
+          for(int k=0; k<16; k++) fails[3] += r16[k] != fe_to_bf16(x[k]);
+          break;
+
+        default:
+          fe_to_f16_batch(x,16,r16);
+          for(int k=0; k<16; k++) fails[3] += r16[k] != fe_to_f16(x[k]);
+          break;
+      }
+    }
+
+    report_table_row(stdout,&table, f->name, fails[0], fails[1], fails[2], fails[3], (uint64_t)TRIALS);
+  }
+
+  report_table_end(stdout, &table);
+}
+
 //**********************************************************
 
 int main(void)
@@ -1130,6 +2290,17 @@ int main(void)
   op_dp_tests();
   op_pd_tests();
   op_pp_tests();
+
+  cr_tests();
+  const_k_tests();
+  div_pre_tests();
+  fma_tests();
+  rounding_tests();
+  compare_tests();
+#if defined(__SIZEOF_INT128__)
+  int_conv_tests();
+#endif
+  narrow_tests();
 #endif  
 
   return 0;